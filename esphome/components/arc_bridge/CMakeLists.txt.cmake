@@ -1,6 +1,6 @@
 esphome_component(
   NAME arc_bridge
-  SRCS "arc_bridge.cpp" "arc_cover.cpp" "battery.cpp" "delivery.cpp" "pairing.cpp" "protocol.cpp" "tx_queue.cpp"
-  HDRS "arc_bridge.h" "arc_cover.h" "battery.h" "delivery.h" "pairing.h" "protocol.h" "tx_queue.h"
+  SRCS "arc_bridge.cpp" "arc_cover.cpp" "battery.cpp" "blind_registry.cpp" "bridge_engine.cpp" "cover_motion.cpp" "delivery.cpp" "frame_extractor.cpp" "latency_histogram.cpp" "loop_profiler.cpp" "motion_batch.cpp" "motion_tracker.cpp" "pairing.cpp" "poll_scheduler.cpp" "protocol.cpp" "publish_filter.cpp" "startup_guard.cpp" "startup_sweep.cpp" "state_cache.cpp" "travel_model.cpp" "tx_queue.cpp" "uart_trace.cpp"
+  HDRS "arc_bridge.h" "arc_cover.h" "battery.h" "blind_id.h" "blind_registry.h" "bridge_engine.h" "bridge_log.h" "cover_motion.h" "delivery.h" "fixed_string.h" "frame_extractor.h" "latency_histogram.h" "loop_profiler.h" "motion_batch.h" "motion_tracker.h" "pairing.h" "poll_scheduler.h" "protocol.h" "publish_filter.h" "startup_guard.h" "startup_sweep.h" "state_cache.h" "travel_model.h" "tx_queue.h" "uart_trace.h"
   REQUIRES "uart;cover;sensor;text_sensor"
 )
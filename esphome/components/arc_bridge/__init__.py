@@ -1,17 +1,145 @@
 import esphome.codegen as cg
 import esphome.config_validation as cv
-from esphome.components import text_sensor, uart
+from esphome.components import sensor, text_sensor, uart
 
 CONF_AUTO_POLL = "auto_poll"
 CONF_AUTO_POLL_INTERVAL = "auto_poll_interval"
+CONF_AUTO_POLL_MIN_AGE = "auto_poll_min_age"
+CONF_STARTUP_SWEEP = "startup_sweep"
+CONF_STARTUP_GUARD = "startup_guard"
+CONF_STARTUP_SETTLE = "startup_settle"
+CONF_MOTION_POLL_INTERVAL = "motion_poll_interval"
+CONF_MOTION_TIMEOUT = "motion_timeout"
+CONF_TRAVEL_SAVE_INTERVAL = "travel_save_interval"
+CONF_STATE_SAVE_INTERVAL = "state_save_interval"
+CONF_STATIC_REFRESH_INTERVAL = "static_refresh_interval"
 CONF_COMMAND_RETRIES = "command_retries"
 CONF_COMMAND_RETRY_TIMEOUT = "command_retry_timeout"
+CONF_DELIVERY_WINDOW = "delivery_window"
+CONF_UART_TRACE_SIZE = "uart_trace_size"
 CONF_MOTION_TX_GAP = "motion_tx_gap"
+CONF_TX_QUEUE_CAPACITY = "tx_queue_capacity"
+CONF_TX_AGING_INTERVAL = "tx_aging_interval"
+CONF_TX_CLASS_WEIGHTS = "tx_class_weights"
+CONF_SENSOR_PUBLISH = "sensor_publish"
+CONF_DELTA = "delta"
+CONF_MIN_INTERVAL = "min_interval"
+CONF_HEARTBEAT = "heartbeat"
 CONF_PAIRING_STATUS = "pairing_status"
 CONF_LAST_PAIRED_ID = "last_paired_id"
+CONF_COMMAND_LATENCY = "command_latency"
+CONF_PER_BLIND = "per_blind"
+CONF_UPDATE_INTERVAL = "update_interval"
+CONF_SENSORS = "sensors"
+CONF_SENSOR = "sensor"
+CONF_PACING_CLASS = "pacing_class"
+CONF_STAGE = "stage"
+CONF_STATISTIC = "statistic"
+CONF_LOOP_PROFILER = "loop_profiler"
+CONF_STALL_THRESHOLD = "stall_threshold"
+CONF_SECTION = "section"
 
 arc_bridge_ns = cg.esphome_ns.namespace("arc_bridge")
 ARCBridgeComponent = arc_bridge_ns.class_("ARCBridgeComponent", cg.Component, uart.UARTDevice)
+TxPriorityClass = arc_bridge_ns.enum("TxPriorityClass", is_class=True)
+SensorKind = arc_bridge_ns.enum("SensorKind", is_class=True)
+TxPacingClass = arc_bridge_ns.enum("TxPacingClass", is_class=True)
+LatencyStage = arc_bridge_ns.enum("LatencyStage", is_class=True)
+LoopSection = arc_bridge_ns.enum("LoopSection", is_class=True)
+
+TX_PRIORITY_CLASSES = {
+    "emergency_stop": TxPriorityClass.EMERGENCY_STOP,
+    "motion": TxPriorityClass.MOTION,
+    "retry_verify": TxPriorityClass.RETRY_VERIFY,
+    "interactive_query": TxPriorityClass.INTERACTIVE_QUERY,
+    "static_query": TxPriorityClass.STATIC_QUERY,
+    "background_poll": TxPriorityClass.BACKGROUND_POLL,
+}
+
+SENSOR_KINDS = {
+    "link_quality": SensorKind.LINK_QUALITY,
+    "status": SensorKind.STATUS,
+    "voltage": SensorKind.VOLTAGE,
+    "battery_level": SensorKind.BATTERY_LEVEL,
+    "speed": SensorKind.SPEED,
+    "version": SensorKind.VERSION,
+    "limits": SensorKind.LIMITS,
+}
+
+TX_PACING_CLASSES = {
+    "standard": TxPacingClass.STANDARD,
+    "motion": TxPacingClass.MOTION,
+}
+
+LATENCY_STAGES = {
+    "queue_wait": LatencyStage.QUEUE_WAIT,
+    "ack_rtt": LatencyStage.ACK_RTT,
+    "total": LatencyStage.TOTAL,
+}
+
+# Percentile each statistic publishes; the 100th is the maximum.
+LATENCY_STATISTICS = {
+    "p50": 50,
+    "p95": 95,
+    "max": 100,
+}
+
+COMMAND_LATENCY_SENSOR_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_SENSOR): cv.use_id(sensor.Sensor),
+        cv.Optional(CONF_PACING_CLASS, default="motion"): cv.one_of(
+            *TX_PACING_CLASSES, lower=True
+        ),
+        cv.Required(CONF_STAGE): cv.one_of(*LATENCY_STAGES, lower=True),
+        cv.Required(CONF_STATISTIC): cv.one_of(*LATENCY_STATISTICS, lower=True),
+    }
+)
+
+COMMAND_LATENCY_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_PER_BLIND, default=False): cv.boolean,
+        cv.Optional(CONF_UPDATE_INTERVAL, default="60s"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_SENSORS, default=[]): cv.ensure_list(COMMAND_LATENCY_SENSOR_SCHEMA),
+    }
+)
+
+LOOP_SECTIONS = {
+    "rx": LoopSection.RX,
+    "framing": LoopSection.FRAMING,
+    "dispatch": LoopSection.DISPATCH,
+    "motion": LoopSection.MOTION,
+    "poll": LoopSection.POLL,
+    "tx": LoopSection.TX,
+    "delivery": LoopSection.DELIVERY,
+    "query_all": LoopSection.QUERY_ALL,
+    "loop": LoopSection.LOOP,
+}
+
+LOOP_PROFILE_SENSOR_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_SENSOR): cv.use_id(sensor.Sensor),
+        cv.Required(CONF_SECTION): cv.one_of(*LOOP_SECTIONS, lower=True),
+        cv.Optional(CONF_STATISTIC, default="max"): cv.one_of("max", "mean", lower=True),
+    }
+)
+
+# The profiler is only compiled in when this block is present.
+LOOP_PROFILER_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_STALL_THRESHOLD, default="30ms"): cv.positive_time_period_microseconds,
+        cv.Optional(CONF_UPDATE_INTERVAL, default="60s"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_SENSORS, default=[]): cv.ensure_list(LOOP_PROFILE_SENSOR_SCHEMA),
+    }
+)
+
+# Unset fields keep the per-kind defaults in publish_filter.h.
+SENSOR_PUBLISH_POLICY_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_DELTA): cv.positive_float,
+        cv.Optional(CONF_MIN_INTERVAL): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_HEARTBEAT): cv.positive_time_period_milliseconds,
+    }
+)
 
 CONFIG_SCHEMA = (
     cv.Schema(
@@ -19,11 +147,44 @@ CONFIG_SCHEMA = (
             cv.GenerateID(): cv.declare_id(ARCBridgeComponent),
             cv.Optional(CONF_AUTO_POLL, default=True): cv.boolean,
             cv.Optional(CONF_AUTO_POLL_INTERVAL, default="10s"): cv.positive_time_period_milliseconds,
+            cv.Optional(
+                CONF_AUTO_POLL_MIN_AGE, default="60s"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_STARTUP_SWEEP, default=True): cv.boolean,
+            cv.Optional(CONF_STARTUP_GUARD, default="10s"): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_STARTUP_SETTLE, default="500ms"): cv.positive_time_period_milliseconds,
             cv.Optional(CONF_MOTION_TX_GAP, default="200ms"): cv.positive_time_period_milliseconds,
+            cv.Optional(
+                CONF_MOTION_POLL_INTERVAL, default="2s"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_MOTION_TIMEOUT, default="90s"): cv.positive_time_period_milliseconds,
+            cv.Optional(
+                CONF_TRAVEL_SAVE_INTERVAL, default="15min"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(
+                CONF_STATE_SAVE_INTERVAL, default="30s"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(
+                CONF_STATIC_REFRESH_INTERVAL, default="24h"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_TX_QUEUE_CAPACITY): cv.int_range(min=8, max=1024),
+            cv.Optional(
+                CONF_TX_AGING_INTERVAL, default="50ms"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_TX_CLASS_WEIGHTS, default={}): cv.Schema(
+                {cv.Optional(name): cv.int_range(min=0, max=60000) for name in TX_PRIORITY_CLASSES}
+            ),
+            cv.Optional(CONF_SENSOR_PUBLISH, default={}): cv.Schema(
+                {cv.Optional(name): SENSOR_PUBLISH_POLICY_SCHEMA for name in SENSOR_KINDS}
+            ),
             cv.Optional(CONF_COMMAND_RETRIES, default=1): cv.int_range(min=0, max=5),
+            cv.Optional(CONF_DELIVERY_WINDOW, default=4): cv.int_range(min=1, max=16),
             cv.Optional(
                 CONF_COMMAND_RETRY_TIMEOUT, default="1500ms"
             ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_UART_TRACE_SIZE, default=0): cv.int_range(min=0, max=32768),
+            cv.Optional(CONF_COMMAND_LATENCY): COMMAND_LATENCY_SCHEMA,
+            cv.Optional(CONF_LOOP_PROFILER): LOOP_PROFILER_SCHEMA,
             cv.Optional(CONF_PAIRING_STATUS): cv.use_id(text_sensor.TextSensor),
             cv.Optional(CONF_LAST_PAIRED_ID): cv.use_id(text_sensor.TextSensor),
         }
@@ -41,11 +202,76 @@ async def to_code(config):
     cg.add(var.set_auto_poll_enabled(config[CONF_AUTO_POLL]))
     interval = config[CONF_AUTO_POLL_INTERVAL]
     cg.add(var.set_auto_poll_interval(interval.total_milliseconds))
+    min_age = config[CONF_AUTO_POLL_MIN_AGE]
+    cg.add(var.set_auto_poll_min_age(min_age.total_milliseconds))
+    cg.add(var.set_startup_sweep_enabled(config[CONF_STARTUP_SWEEP]))
+    startup_guard = config[CONF_STARTUP_GUARD]
+    cg.add(var.set_startup_guard_max(startup_guard.total_milliseconds))
+    startup_settle = config[CONF_STARTUP_SETTLE]
+    cg.add(var.set_startup_settle(startup_settle.total_milliseconds))
     motion_gap = config[CONF_MOTION_TX_GAP]
     cg.add(var.set_motion_tx_gap(motion_gap.total_milliseconds))
+    motion_poll_interval = config[CONF_MOTION_POLL_INTERVAL]
+    cg.add(var.set_motion_poll_interval(motion_poll_interval.total_milliseconds))
+    motion_timeout = config[CONF_MOTION_TIMEOUT]
+    cg.add(var.set_motion_timeout(motion_timeout.total_milliseconds))
+    travel_save_interval = config[CONF_TRAVEL_SAVE_INTERVAL]
+    cg.add(var.set_travel_save_interval(travel_save_interval.total_milliseconds))
+    state_save_interval = config[CONF_STATE_SAVE_INTERVAL]
+    cg.add(var.set_state_save_interval(state_save_interval.total_milliseconds))
+    static_refresh_interval = config[CONF_STATIC_REFRESH_INTERVAL]
+    cg.add(var.set_static_refresh_interval(static_refresh_interval.total_milliseconds))
+    if CONF_TX_QUEUE_CAPACITY in config:
+        cg.add(var.set_tx_queue_capacity(config[CONF_TX_QUEUE_CAPACITY]))
+    aging_interval = config[CONF_TX_AGING_INTERVAL]
+    cg.add(var.set_tx_aging_interval(aging_interval.total_milliseconds))
+    for name, weight in config[CONF_TX_CLASS_WEIGHTS].items():
+        cg.add(var.set_tx_class_weight(TX_PRIORITY_CLASSES[name], weight))
+    for name, policy in config[CONF_SENSOR_PUBLISH].items():
+        kind = SENSOR_KINDS[name]
+        if CONF_DELTA in policy:
+            cg.add(var.set_publish_delta(kind, policy[CONF_DELTA]))
+        if CONF_MIN_INTERVAL in policy:
+            cg.add(var.set_publish_min_interval(kind, policy[CONF_MIN_INTERVAL].total_milliseconds))
+        if CONF_HEARTBEAT in policy:
+            cg.add(var.set_publish_heartbeat(kind, policy[CONF_HEARTBEAT].total_milliseconds))
     cg.add(var.set_command_retry_count(config[CONF_COMMAND_RETRIES]))
     retry_timeout = config[CONF_COMMAND_RETRY_TIMEOUT]
     cg.add(var.set_command_retry_timeout(retry_timeout.total_milliseconds))
+    cg.add(var.set_delivery_window(config[CONF_DELIVERY_WINDOW]))
+    if config[CONF_UART_TRACE_SIZE] > 0:
+        cg.add(var.set_uart_trace_size(config[CONF_UART_TRACE_SIZE]))
+    if CONF_COMMAND_LATENCY in config:
+        latency = config[CONF_COMMAND_LATENCY]
+        cg.add(var.set_blind_latency_enabled(latency[CONF_PER_BLIND]))
+        update_interval = latency[CONF_UPDATE_INTERVAL]
+        cg.add(var.set_command_latency_update_interval(update_interval.total_milliseconds))
+        for entry in latency[CONF_SENSORS]:
+            latency_sensor = await cg.get_variable(entry[CONF_SENSOR])
+            cg.add(
+                var.add_command_latency_sensor(
+                    latency_sensor,
+                    TX_PACING_CLASSES[entry[CONF_PACING_CLASS]],
+                    LATENCY_STAGES[entry[CONF_STAGE]],
+                    LATENCY_STATISTICS[entry[CONF_STATISTIC]],
+                )
+            )
+    if CONF_LOOP_PROFILER in config:
+        profiler = config[CONF_LOOP_PROFILER]
+        cg.add_define("USE_ARC_BRIDGE_PROFILER")
+        stall_threshold = profiler[CONF_STALL_THRESHOLD]
+        cg.add(var.set_loop_stall_threshold(stall_threshold.total_microseconds))
+        update_interval = profiler[CONF_UPDATE_INTERVAL]
+        cg.add(var.set_loop_profile_update_interval(update_interval.total_milliseconds))
+        for entry in profiler[CONF_SENSORS]:
+            profile_sensor = await cg.get_variable(entry[CONF_SENSOR])
+            cg.add(
+                var.add_loop_profile_sensor(
+                    profile_sensor,
+                    LOOP_SECTIONS[entry[CONF_SECTION]],
+                    entry[CONF_STATISTIC] == "max",
+                )
+            )
 
     if CONF_PAIRING_STATUS in config:
         pairing_status = await cg.get_variable(config[CONF_PAIRING_STATUS])
@@ -1,50 +1,53 @@
 #pragma once
 
-#include "delivery.h"
-#include "pairing.h"
-#include "tx_queue.h"
+#include "blind_id.h"
+#include "bridge_engine.h"
+#include "latency_histogram.h"
+#include "motion_batch.h"
+#include "publish_filter.h"
+#include "state_cache.h"
+#include "travel_model.h"
 
 #include "esphome/core/component.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/preferences.h"
 #include "esphome/components/uart/uart.h"
 #include "esphome/components/sensor/sensor.h"
 #include "esphome/components/text_sensor/text_sensor.h"
 
+#include <array>
+#include <functional>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
-#include <deque>
 
 namespace esphome {
 namespace arc_bridge {
 
 class ARCCover;  // forward declaration
 
-class ARCBridgeComponent : public Component, public uart::UARTDevice {
+// Binds the BridgeEngine to ESPHome: millis() is its clock, the UART its
+// transport, covers and sensors receive its events and the preferences store
+// its travel times and snapshots. All protocol behaviour lives in the engine.
+class ARCBridgeComponent : public Component,
+                           public uart::UARTDevice,
+                           public BridgeEngine,
+                           protected BridgeClock,
+                           protected BridgeTransport,
+                           protected BridgeEventSink,
+                           protected BridgeStorage {
  public:
   void setup() override;
   void loop() override;
+  void on_shutdown() override;
 
   // registration
   void register_cover(const std::string &id, ARCCover *cover);
 
-  // command API
-  void send_open(const std::string &id);
-  void send_close(const std::string &id);
-  void send_stop(const std::string &id);
-  void send_move(const std::string &id, uint8_t percent);
-  void send_query(const std::string &id);
-  void send_query_all();
-  void send_pair_command();
-  void send_raw_command(const std::string &cmd);
-  void send_favorite(const std::string &id);
-  void send_jog_open(const std::string &id);
-  void send_jog_close(const std::string &id);
-
-  // Query additional motor telemetry via the UART bridge.
-  void send_voltage_query(const std::string &id);
-  void send_version_query(const std::string &id);
-  void send_speed_query(const std::string &id);
-  void send_limits_query(const std::string &id);
+  void add_on_motion_batch_callback(std::function<void(const MotionBatchStatus &)> &&callback) {
+    this->motion_batch_callback_.add(std::move(callback));
+  }
 
   // sensor mapping
   void map_lq_sensor(const std::string &id, sensor::Sensor *s);
@@ -57,118 +60,91 @@ class ARCBridgeComponent : public Component, public uart::UARTDevice {
   void set_pairing_status_sensor(text_sensor::TextSensor *sensor);
   void set_last_paired_id_sensor(text_sensor::TextSensor *sensor);
 
-  // Runtime tuning for polling, retries, and motion pacing.
-  void set_auto_poll_enabled(bool enabled) { this->auto_poll_enabled_ = enabled; }
-  void set_auto_poll_interval(uint32_t interval_ms) { this->query_interval_ms_ = interval_ms; }
-  void set_command_retry_count(uint8_t retry_count) { this->command_retry_count_ = retry_count; }
-  void set_command_retry_timeout(uint32_t timeout_ms) { this->command_retry_timeout_ms_ = timeout_ms; }
-  void set_motion_tx_gap(uint32_t gap_ms) { this->motion_tx_gap_ms_ = gap_ms; }
-
-  bool is_startup_guard_cleared() const { return this->startup_guard_cleared_; }
+  // Diagnostic sensors for get_command_latency(), published every update
+  // interval. A `percentile` of 100 publishes the maximum.
+  void add_command_latency_sensor(sensor::Sensor *sensor, TxPacingClass pacing_class,
+                                  LatencyStage stage, uint8_t percentile);
+  void set_command_latency_update_interval(uint32_t interval_ms) {
+    this->command_latency_update_interval_ms_ = interval_ms;
+  }
 
-  void send_simple(const std::string &id, char cmd, const std::string &arg = "") {
-    this->send_simple_(id, cmd, arg);
+#ifdef USE_ARC_BRIDGE_PROFILER
+  // Diagnostic sensors for get_loop_profiler(), in microseconds, published
+  // every update interval.
+  void add_loop_profile_sensor(sensor::Sensor *sensor, LoopSection section, bool max);
+  void set_loop_profile_update_interval(uint32_t interval_ms) {
+    this->loop_profile_update_interval_ms_ = interval_ms;
   }
+#endif
 
  protected:
-  void handle_frame(const std::string &frame);
-  void parse_frame(const std::string &frame);
-  void send_simple_(const std::string &id, char command, const std::string &payload = "",
-                    bool priority = false,
-                    TxPacingClass pacing_class = TxPacingClass::STANDARD,
-                    bool is_poll = false,
-                    DeliveryExpectation delivery_expectation = DeliveryExpectation::NONE,
-                    bool allow_retry = false,
-                    const std::string &expected_ack_token = "",
-                    const std::string &expected_ack_prefix = "");
-  void enqueue_queries_for_id_(const std::string &id, bool force_static);
-  // Helper to decode and publish pVc feedback.
-  void handle_pvc_value_(const std::string &id, const std::string &digits);
-  uint32_t allocate_tracking_id_();
-  void arm_pending_delivery_(const TxQueueItem &item, uint32_t now);
-  void acknowledge_pending_delivery_(const ParsedFrame &parsed);
-  void process_pending_deliveries_();
-  bool tx_item_blocked_by_pending_delivery_(const TxQueueItem &item) const;
-  void send_verification_query_(const std::string &id);
-  void publish_pairing_status_(const std::string &status);
-  void publish_last_paired_id_(const std::string &id);
-  void handle_pairing_outcome_(const PairingOutcome &outcome);
-  void process_pairing_timeout_();
-
-  // ===============================
-  // CONSTANTS (Option A ordering)
-  // ===============================
-  static const uint32_t QUERY_INTERVAL_MS = 10000;      // 10 seconds
-  static const uint32_t STARTUP_GUARD_MS  = 10000;      // 10 seconds
-  static const uint32_t MOVEMENT_QUIET_MS = 90000;      // 90 seconds
-  static const uint32_t TX_WATCHDOG_MS    = 5000;       // 5 seconds
-  static const uint32_t PAIRING_TIMEOUT_MS = 30000;     // 30 seconds
-  static const uint8_t COMMAND_RETRY_COUNT = 1;         // one resend after verification
-  static const uint32_t COMMAND_RETRY_TIMEOUT_MS = 1500;  // wait before verify/retry
-
-  // ===============================
-  // INTERNAL STATE
-  // ===============================
-  std::deque<char> rx_buffer_;
-  uint32_t boot_millis_{0};
-  uint32_t last_query_millis_{0};
-  uint32_t last_rx_millis_{0};
-  uint32_t last_motion_millis_{0};
-  size_t query_index_{0};
-  bool startup_guard_cleared_{false};
-  bool auto_poll_enabled_{true};
-  uint32_t query_interval_ms_{QUERY_INTERVAL_MS};
-  uint8_t command_retry_count_{COMMAND_RETRY_COUNT};
-  uint32_t command_retry_timeout_ms_{COMMAND_RETRY_TIMEOUT_MS};
-  uint32_t motion_tx_gap_ms_{DEFAULT_MOTION_TX_GAP_MS};
-
-  std::vector<ARCCover *> covers_;
-  std::unordered_map<std::string, ARCCover *> cover_map_;
-  std::unordered_map<std::string, sensor::Sensor *> lq_map_;
-  std::unordered_map<std::string, text_sensor::TextSensor *> status_map_;
-  std::unordered_map<std::string, sensor::Sensor *> voltage_map_;
-  std::unordered_map<std::string, sensor::Sensor *> battery_level_map_;
-  std::unordered_map<std::string, text_sensor::TextSensor *> version_map_;
-  std::unordered_map<std::string, sensor::Sensor *> speed_map_;
-  std::unordered_map<std::string, text_sensor::TextSensor *> limits_map_;
+  // BridgeClock
+  uint32_t now_ms() const override { return millis(); }
+  uint32_t cycle_count() const override { return arch_get_cpu_cycle_count(); }
+  uint32_t cycles_per_us() const override { return arch_get_cpu_freq_hz() / 1000000; }
+
+  // BridgeTransport
+  size_t receive(char *buffer, size_t size) override;
+  void transmit(std::string_view bytes) override;
+
+  // BridgeEventSink
+  void on_sensor(size_t blind, SensorKind kind, float value) override;
+  void on_text_sensor(size_t blind, SensorKind kind, std::string_view value) override;
+  void on_cover_position(size_t blind, int position, bool in_motion) override;
+  void on_cover_available(size_t blind, bool available) override;
+  void on_cover_motion(size_t blind, int target, uint32_t full_travel_ms,
+                       uint32_t motion_timeout_ms) override;
+  void on_cover_stop(size_t blind) override;
+  void on_pairing_status(std::string_view status) override;
+  void on_last_paired_id(std::string_view id) override;
+  void on_motion_batch(const MotionBatchStatus &status) override;
+
+  // BridgeStorage
+  bool load_travel_model(size_t blind, BlindId id, TravelModel &model) override;
+  void save_travel_model(size_t blind, const TravelModel &model) override;
+  bool load_snapshot(size_t blind, BlindId id, BlindSnapshot &snapshot) override;
+  void save_snapshot(size_t blind, const BlindSnapshot &snapshot) override;
+
+  // ESPHome objects behind one engine blind index.
+  struct BlindEntities {
+    ARCCover *cover{nullptr};
+    std::array<sensor::Sensor *, SENSOR_KIND_COUNT> sensors{};
+    std::array<text_sensor::TextSensor *, SENSOR_KIND_COUNT> text_sensors{};
+    ESPPreferenceObject travel_pref;
+    ESPPreferenceObject snapshot_pref;
+  };
+
+  // Entities for the blind at `index`, grown to fit; nullptr for NOT_FOUND.
+  BlindEntities *entities_at_(size_t index);
+  void map_sensor_(const std::string &id, SensorKind kind, sensor::Sensor *sensor);
+  void map_text_sensor_(const std::string &id, SensorKind kind, text_sensor::TextSensor *sensor);
+  void publish_command_latency_();
+#ifdef USE_ARC_BRIDGE_PROFILER
+  void publish_loop_profile_();
+#endif
+
+  std::vector<BlindEntities> entities_;
   text_sensor::TextSensor *pairing_status_sensor_{nullptr};
   text_sensor::TextSensor *last_paired_id_sensor_{nullptr};
-  PairingSession pairing_session_;
-  // Track motion-command delivery per blind so retries stay scoped.
-  struct PendingCommandDelivery {
-    TxQueueItem item;
-    uint8_t retries_used{0};
-    uint32_t last_activity_ms{0};
-    bool verification_sent{false};
+  CallbackManager<void(const MotionBatchStatus &)> motion_batch_callback_;
+
+  struct LatencySensor {
+    sensor::Sensor *sensor;
+    TxPacingClass pacing_class;
+    LatencyStage stage;
+    uint8_t percentile;
+  };
+  std::vector<LatencySensor> latency_sensors_;
+  uint32_t command_latency_update_interval_ms_{60000};
+#ifdef USE_ARC_BRIDGE_PROFILER
+  struct LoopProfileSensor {
+    sensor::Sensor *sensor;
+    LoopSection section;
+    bool max;
   };
-  std::unordered_map<std::string, PendingCommandDelivery> pending_command_deliveries_;
-  uint32_t next_tracking_id_{1};
-
-  // ===============================
-  // TX QUEUE SUPPORT
-  // ===============================
-  std::deque<TxQueueItem> tx_queue_;
-  uint32_t last_tx_millis_{0};
-  void queue_tx(const std::string &frame,
-                TxPacingClass pacing_class = TxPacingClass::STANDARD,
-                bool is_poll = false,
-                const std::string &blind_id = "",
-                DeliveryExpectation delivery_expectation = DeliveryExpectation::NONE,
-                bool allow_retry = false,
-                uint32_t tracking_id = 0,
-                const std::string &expected_ack_token = "",
-                const std::string &expected_ack_prefix = "");
-  void queue_tx_front(const std::string &frame,
-                      TxPacingClass pacing_class = TxPacingClass::STANDARD,
-                      bool is_poll = false,
-                      const std::string &blind_id = "",
-                      DeliveryExpectation delivery_expectation = DeliveryExpectation::NONE,
-                      bool allow_retry = false,
-                      uint32_t tracking_id = 0,
-                      const std::string &expected_ack_token = "",
-                      const std::string &expected_ack_prefix = "");
-  void drop_pending_polls_();
-  void process_tx_queue_();
+  std::vector<LoopProfileSensor> loop_profile_sensors_;
+  uint32_t loop_profile_update_interval_ms_{60000};
+#endif
 };
 
 }  // namespace arc_bridge
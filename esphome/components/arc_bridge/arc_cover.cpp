@@ -1,5 +1,6 @@
 #include "arc_cover.h"
 #include "arc_bridge.h"
+#include "esphome/core/hal.h"
 #include "esphome/core/log.h"
 
 #include <cmath>
@@ -9,6 +10,33 @@ namespace arc_bridge {
 
 static const char *const TAG = "arc_cover";
 
+void ARCCover::setup() {
+  // The loop only runs while a move is being interpolated.
+  this->disable_loop();
+}
+
+void ARCCover::loop() {
+  if (!this->motion_.active()) {
+    this->disable_loop();
+    return;
+  }
+  const uint32_t now = millis();
+  if (this->motion_.idle_ms(now) >= this->motion_timeout_ms_) {
+    ESP_LOGD(TAG, "[%s] No motion report for %" PRIu32 " ms -> idle",
+             this->blind_id_.text().c_str(), this->motion_timeout_ms_);
+    this->end_motion_();
+    return;
+  }
+  if (this->interpolation_interval_ms_ == 0 ||
+      now - this->last_motion_publish_ms_ < this->interpolation_interval_ms_) {
+    return;
+  }
+  const float estimate = this->motion_.estimate(now);
+  if (estimate >= 0.0f && std::fabs(this->position - (1.0f - estimate / 100.0f)) >= 0.005f) {
+    this->publish_motion_state_(now);
+  }
+}
+
 cover::CoverTraits ARCCover::get_traits() {
   cover::CoverTraits traits;
   traits.set_supports_position(true);
@@ -16,11 +44,11 @@ cover::CoverTraits ARCCover::get_traits() {
   return traits;
 }
 
-void ARCCover::publish_raw_position(int device_pos) {
+void ARCCover::publish_raw_position(int device_pos, bool in_motion) {
   // Handle missing or invalid position.
   if (device_pos < 0 || device_pos > 100) {
     ESP_LOGW(TAG, "[%s] invalid/missing position (%d) -> marking unavailable",
-             this->blind_id_.c_str(), device_pos);
+             this->blind_id_.text().c_str(), device_pos);
     this->set_available(false);
     return;
   }
@@ -30,15 +58,31 @@ void ARCCover::publish_raw_position(int device_pos) {
   // Sanity check.
   if (ha_pos < 0.0f || ha_pos > 1.0f || std::isnan(ha_pos)) {
     ESP_LOGW(TAG, "[%s] invalid ha_pos %.2f -> ignoring",
-             this->blind_id_.c_str(), ha_pos);
+             this->blind_id_.text().c_str(), ha_pos);
     return;
   }
 
+  const uint32_t now = millis();
+  if (in_motion) {
+    this->last_known_pos_ = device_pos;
+    this->motion_.report(static_cast<float>(device_pos), now);
+    if (this->motion_.active()) {
+      this->status_clear_warning();
+      this->set_has_state(true);
+      this->publish_motion_state_(now);
+      this->enable_loop();
+      return;
+    }
+  } else {
+    this->motion_.arrive(static_cast<float>(device_pos), now);
+  }
+
   // Avoid re-publishing unchanged values
   if (this->has_state() && !std::isnan(this->position) &&
-      fabs(this->position - ha_pos) < 0.005f) {
+      fabs(this->position - ha_pos) < 0.005f &&
+      this->current_operation == cover::COVER_OPERATION_IDLE) {
     ESP_LOGV(TAG, "[%s] ha_pos=%.2f unchanged -> no publish",
-             this->blind_id_.c_str(), ha_pos);
+             this->blind_id_.text().c_str(), ha_pos);
     return;
   }
 
@@ -49,17 +93,73 @@ void ARCCover::publish_raw_position(int device_pos) {
   this->current_operation = cover::COVER_OPERATION_IDLE;
   this->position = ha_pos;
   ESP_LOGD(TAG, "[%s] device_pos=%d -> ha_pos=%.2f",
-           this->blind_id_.c_str(), device_pos, ha_pos);
+           this->blind_id_.text().c_str(), device_pos, ha_pos);
   this->publish_state();
 }
 
+void ARCCover::on_motion_acknowledged(int target, uint32_t full_travel_ms,
+                                      uint32_t motion_timeout_ms) {
+  const uint32_t now = millis();
+  this->motion_timeout_ms_ = motion_timeout_ms;
+  this->motion_.start(static_cast<float>(this->last_known_pos_), static_cast<float>(target), now,
+                      full_travel_ms);
+  if (!this->motion_.active()) {
+    return;
+  }
+  ESP_LOGD(TAG, "[%s] Moving to %d", this->blind_id_.text().c_str(), target);
+  this->publish_motion_state_(now);
+  this->enable_loop();
+}
+
+void ARCCover::on_stop_acknowledged() {
+  if (this->motion_.active()) {
+    this->end_motion_();
+  }
+}
+
+void ARCCover::publish_motion_state_(uint32_t now) {
+  // Optimistic until the blind reports: an unknown start shows the target.
+  float estimate = this->motion_.estimate(now);
+  if (estimate < 0.0f) {
+    estimate = this->motion_.target();
+  }
+  switch (this->motion_.direction()) {
+    case TravelDirection::OPENING:
+      this->current_operation = cover::COVER_OPERATION_OPENING;
+      break;
+    case TravelDirection::CLOSING:
+      this->current_operation = cover::COVER_OPERATION_CLOSING;
+      break;
+    case TravelDirection::NONE:
+    default:
+      this->current_operation = cover::COVER_OPERATION_IDLE;
+      break;
+  }
+  this->position = 1.0f - estimate / 100.0f;
+  this->last_motion_publish_ms_ = now;
+  this->publish_state();
+}
+
+void ARCCover::end_motion_() {
+  const uint32_t now = millis();
+  const float estimate = this->motion_.estimate(now);
+  this->motion_.stop();
+  this->current_operation = cover::COVER_OPERATION_IDLE;
+  if (estimate >= 0.0f) {
+    this->position = 1.0f - estimate / 100.0f;
+  }
+  this->publish_state();
+  this->disable_loop();
+}
+
 void ARCCover::set_available(bool available) {
   if (!available) {
+    this->motion_.stop();
     this->current_operation = cover::COVER_OPERATION_IDLE;
     this->position = NAN;
     this->set_has_state(false);
     this->publish_state();
-    ESP_LOGW(TAG, "[%s] marked unavailable", this->blind_id_.c_str());
+    ESP_LOGW(TAG, "[%s] marked unavailable", this->blind_id_.text().c_str());
   } else {
     this->status_clear_warning();
     if (this->last_known_pos_ >= 0) {
@@ -68,20 +168,31 @@ void ARCCover::set_available(bool available) {
       this->set_has_state(true);
       this->publish_state();
     }
-    ESP_LOGD(TAG, "[%s] marked available", this->blind_id_.c_str());
+    ESP_LOGD(TAG, "[%s] marked available", this->blind_id_.text().c_str());
+  }
+}
+
+uint8_t ARCCover::arc_percent_for(float position) const {
+  float p = position;
+  if (p < 0.0f) p = 0.0f;
+  if (p > 1.0f) p = 1.0f;
+
+  if (this->invert_position_) {
+    return static_cast<uint8_t>(std::round(p * 100.0f));
   }
+  return static_cast<uint8_t>(std::round((1.0f - p) * 100.0f));
 }
 
 void ARCCover::control(const cover::CoverCall &call) {
   if (this->bridge_ == nullptr) {
-    ESP_LOGW(TAG, "[%s] No ARC bridge associated", this->blind_id_.c_str());
+    ESP_LOGW(TAG, "[%s] No ARC bridge associated", this->blind_id_.text().c_str());
     return;
   }
 
-  // Prevent any movement during startup guard
+  // The bridge holds commands until the hub is ready.
   if (!this->bridge_->is_startup_guard_cleared()) {
-    ESP_LOGW(TAG, "[%s] Ignoring command during startup guard period", this->blind_id_.c_str());
-    return;
+    ESP_LOGI(TAG, "[%s] Command held until the startup guard clears",
+             this->blind_id_.text().c_str());
   }
 
   if (call.get_stop()) {
@@ -90,18 +201,11 @@ void ARCCover::control(const cover::CoverCall &call) {
   }
 
   if (call.get_position().has_value()) {
-    float p = *call.get_position();
-    if (p < 0.0f) p = 0.0f;
-    if (p > 1.0f) p = 1.0f;
-
-    uint8_t arc_percent;
-    if (this->invert_position_) {
-      arc_percent = static_cast<uint8_t>(std::round(p * 100.0f));
-    } else {
-      arc_percent = static_cast<uint8_t>(std::round((1.0f - p) * 100.0f));
-    }
+    const float p = *call.get_position();
+    const uint8_t arc_percent = this->arc_percent_for(p);
 
-    ESP_LOGD(TAG, "[%s] control pos=%.2f -> arc_percent=%d", this->blind_id_.c_str(), p, arc_percent);
+    ESP_LOGD(TAG, "[%s] control pos=%.2f -> arc_percent=%d", this->blind_id_.text().c_str(), p,
+             arc_percent);
 
     if (arc_percent >= 100)
       this->bridge_->send_close(this->blind_id_);
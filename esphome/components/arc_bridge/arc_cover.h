@@ -1,4 +1,8 @@
 #pragma once
+#include "blind_id.h"
+#include "cover_motion.h"
+#include "motion_tracker.h"
+
 #include "esphome/core/component.h"
 #include "esphome/components/cover/cover.h"
 
@@ -12,28 +16,55 @@ class ARCBridgeComponent;  // forward declare
 class ARCCover : public cover::Cover, public Component {
  public:
   void set_bridge(ARCBridgeComponent *bridge) { this->bridge_ = bridge; }
+  ARCBridgeComponent *get_bridge() const { return this->bridge_; }
 
-  void set_blind_id(const std::string &id) { this->blind_id_ = id; }
-  const std::string &get_blind_id() const { return this->blind_id_; }
+  void set_blind_id(const std::string &id) { this->blind_id_ = BlindId::from_text(id); }
+  BlindId get_blind_id() const { return this->blind_id_; }
 
   void set_invert_position(bool invert) { this->invert_position_ = invert; }
+  // ARC position (0 open, 100 closed) for a Home Assistant position.
+  uint8_t arc_percent_for(float position) const;
+
+  // 0 publishes only reported positions while the blind moves.
+  void set_interpolation_interval(uint32_t interval_ms) {
+    this->interpolation_interval_ms_ = interval_ms;
+  }
 
   // publishers
-  void publish_raw_position(int device_pos);
+  // `in_motion` marks a "<NN" report from a blind that is still travelling.
+  void publish_raw_position(int device_pos, bool in_motion = false);
+  // The blind acknowledged a command moving it to ARC position `target`.
+  // `full_travel_ms` is its learned time for a full move that way, 0 if unknown.
+  // The move ends once the blind is quiet for `motion_timeout_ms`, the
+  // bridge's timeout for this blind.
+  void on_motion_acknowledged(int target, uint32_t full_travel_ms = 0,
+                              uint32_t motion_timeout_ms = DEFAULT_MOTION_TIMEOUT_MS);
+  void on_stop_acknowledged();
 
   // Correct availability handling for HA
   void set_available(bool available);
 
+  void setup() override;
+  void loop() override;
   cover::CoverTraits get_traits() override;
   void control(const cover::CoverCall &call) override;
 
  protected:
+  // Publishes the interpolated position with the direction of travel.
+  void publish_motion_state_(uint32_t now);
+  void end_motion_();
+
   ARCBridgeComponent *bridge_{nullptr};
-  std::string blind_id_;
+  BlindId blind_id_;
   bool invert_position_{false};
 
   // cache last known position for availability restore
   int last_known_pos_{-1};
+
+  PositionInterpolator motion_;
+  uint32_t interpolation_interval_ms_{DEFAULT_INTERPOLATION_INTERVAL_MS};
+  uint32_t last_motion_publish_ms_{0};
+  uint32_t motion_timeout_ms_{DEFAULT_MOTION_TIMEOUT_MS};
 };
 
 }  // namespace arc_bridge
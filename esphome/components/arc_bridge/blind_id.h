@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace esphome {
+namespace arc_bridge {
+
+// ARC blind address. Addresses are always three ASCII characters, so they are
+// packed little-endian into one word: copying, comparing and hashing an id
+// costs the same as an integer. A packed value of 0 means "no blind".
+class BlindId {
+ public:
+  static constexpr size_t LENGTH = 3;
+
+  // NUL-terminated spelling of an id, for logs and text sensors.
+  struct Text {
+    char data[LENGTH + 1];
+
+    const char *c_str() const { return this->data; }
+    std::string_view view() const { return this->data; }
+  };
+
+  constexpr BlindId() = default;
+
+  // Returns an invalid id unless `text` is exactly three non-NUL characters.
+  static constexpr BlindId from_text(std::string_view text) {
+    BlindId id;
+    if (text.size() != LENGTH || text[0] == '\0' || text[1] == '\0' || text[2] == '\0') {
+      return id;
+    }
+    id.packed_ = static_cast<uint32_t>(static_cast<uint8_t>(text[0])) |
+                 static_cast<uint32_t>(static_cast<uint8_t>(text[1])) << 8 |
+                 static_cast<uint32_t>(static_cast<uint8_t>(text[2])) << 16;
+    return id;
+  }
+
+  constexpr uint32_t packed() const { return this->packed_; }
+  constexpr bool valid() const { return this->packed_ != 0; }
+  constexpr char operator[](size_t index) const {
+    return static_cast<char>((this->packed_ >> (8 * index)) & 0xFF);
+  }
+
+  Text text() const { return {{(*this)[0], (*this)[1], (*this)[2], '\0'}}; }
+  std::string str() const {
+    return this->valid() ? std::string(this->text().view()) : std::string();
+  }
+
+  friend constexpr bool operator==(BlindId lhs, BlindId rhs) { return lhs.packed_ == rhs.packed_; }
+  friend constexpr bool operator!=(BlindId lhs, BlindId rhs) { return lhs.packed_ != rhs.packed_; }
+
+ protected:
+  uint32_t packed_{0};
+};
+
+}  // namespace arc_bridge
+}  // namespace esphome
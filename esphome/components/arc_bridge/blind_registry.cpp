@@ -0,0 +1,78 @@
+#include "blind_registry.h"
+
+namespace esphome {
+namespace arc_bridge {
+
+namespace {
+
+constexpr uint8_t MAX_HASH_BITS = 16;
+constexpr uint32_t MAX_ATTEMPTS_PER_SIZE = 1024;
+
+// Smallest table that keeps the load factor at or below one half.
+uint8_t min_bits_for_(size_t count) {
+  uint8_t bits = 0;
+  while ((static_cast<size_t>(1) << bits) < count * 2) {
+    bits++;
+  }
+  return bits;
+}
+
+}  // namespace
+
+void BlindRegistry::set_hash(uint32_t multiplier, uint8_t bits) {
+  if (bits > MAX_HASH_BITS || !this->layout_(multiplier, bits)) {
+    this->rebuild_();
+  }
+}
+
+size_t BlindRegistry::add(BlindId id) {
+  if (!id.valid()) {
+    return NOT_FOUND;
+  }
+  const size_t existing = this->find(id);
+  if (existing != NOT_FOUND) {
+    return existing;
+  }
+  if (this->ids_.size() + 1 >= UINT16_MAX) {
+    return NOT_FOUND;
+  }
+
+  this->ids_.push_back(id);
+  const size_t index = this->ids_.size() - 1;
+  if (this->slots_.size() >= this->ids_.size() * 2) {
+    uint16_t &slot = this->slots_[blind_hash_slot(id, this->multiplier_, this->bits_)];
+    if (slot == 0) {
+      slot = static_cast<uint16_t>(index + 1);
+      return index;
+    }
+  }
+  this->rebuild_();
+  return index;
+}
+
+bool BlindRegistry::layout_(uint32_t multiplier, uint8_t bits) {
+  this->slots_.assign(static_cast<size_t>(1) << bits, 0);
+  for (size_t i = 0; i < this->ids_.size(); i++) {
+    uint16_t &slot = this->slots_[blind_hash_slot(this->ids_[i], multiplier, bits)];
+    if (slot != 0) {
+      return false;
+    }
+    slot = static_cast<uint16_t>(i + 1);
+  }
+  this->multiplier_ = multiplier;
+  this->bits_ = bits;
+  return true;
+}
+
+void BlindRegistry::rebuild_() {
+  for (uint8_t bits = min_bits_for_(this->ids_.size()); bits <= MAX_HASH_BITS; bits++) {
+    for (uint32_t attempt = 0; attempt < MAX_ATTEMPTS_PER_SIZE; attempt++) {
+      if (this->layout_(blind_hash_multiplier(attempt), bits)) {
+        return;
+      }
+    }
+  }
+}
+
+}  // namespace arc_bridge
+}  // namespace esphome
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "blind_id.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace esphome {
+namespace arc_bridge {
+
+// Multiplicative hash shared with cover.py, which searches the same candidate
+// sequence at compile time. Keep the two in sync.
+static constexpr uint32_t BLIND_HASH_SEED = 0x9E3779B1;
+static constexpr uint32_t BLIND_HASH_STEP = 0x7F4A7C16;
+
+constexpr uint32_t blind_hash_multiplier(uint32_t attempt) {
+  return BLIND_HASH_SEED + attempt * BLIND_HASH_STEP;
+}
+
+constexpr uint32_t blind_hash_slot(BlindId id, uint32_t multiplier, uint8_t bits) {
+  return bits == 0 ? 0 : (id.packed() * multiplier) >> (32 - bits);
+}
+
+// Maps registered blind ids to dense indices 0..size()-1 through a collision
+// free (perfect) hash, so a lookup is one multiply, one shift and one compare.
+// cover.py computes the hash parameters for the configured blinds; ids added
+// outside that set make the registry search for new parameters on its own.
+class BlindRegistry {
+ public:
+  static constexpr size_t NOT_FOUND = SIZE_MAX;
+
+  void set_hash(uint32_t multiplier, uint8_t bits);
+
+  // Returns the index of `id`, registering it first when it is new.
+  size_t add(BlindId id);
+
+  size_t find(BlindId id) const {
+    if (this->slots_.empty()) {
+      return NOT_FOUND;
+    }
+    const uint16_t entry = this->slots_[blind_hash_slot(id, this->multiplier_, this->bits_)];
+    if (entry == 0 || this->ids_[entry - 1] != id) {
+      return NOT_FOUND;
+    }
+    return entry - 1;
+  }
+
+  size_t size() const { return this->ids_.size(); }
+  BlindId id_at(size_t index) const { return this->ids_[index]; }
+  uint32_t multiplier() const { return this->multiplier_; }
+  uint8_t bits() const { return this->bits_; }
+
+ protected:
+  bool layout_(uint32_t multiplier, uint8_t bits);
+  void rebuild_();
+
+  std::vector<BlindId> ids_;
+  // Slot -> index + 1, 0 for an empty slot.
+  std::vector<uint16_t> slots_;
+  uint32_t multiplier_{BLIND_HASH_SEED};
+  uint8_t bits_{0};
+};
+
+}  // namespace arc_bridge
+}  // namespace esphome
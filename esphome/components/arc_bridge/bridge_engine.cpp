@@ -0,0 +1,1740 @@
+#include "bridge_engine.h"
+
+#include "battery.h"
+#include "bridge_log.h"
+#include "protocol.h"
+#include "tx_queue.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+
+namespace esphome {
+namespace arc_bridge {
+
+static const char *const TAG = "arc_bridge";
+
+// Adds the cycles until the end of the enclosing block to a loop section.
+#ifdef USE_ARC_BRIDGE_PROFILER
+#define ARC_PROFILE_CONCAT_(a, b) a##b
+#define ARC_PROFILE_SCOPE_NAME_(line) ARC_PROFILE_CONCAT_(profile_scope_, line)
+#define ARC_PROFILE_SECTION(section) \
+  LoopSectionScope<BridgeClock> ARC_PROFILE_SCOPE_NAME_(__LINE__)( \
+      this->loop_profiler_, *this->clock_, LoopSection::section)
+#else
+#define ARC_PROFILE_SECTION(section)
+#endif
+
+namespace {
+
+static void decode_rssi(uint8_t raw, float &dbm, float &pct) {
+  dbm = (raw / 2.0f) - 130.0f;
+
+  if (dbm < -120) {
+    dbm = -120;
+  }
+  if (dbm > -20) {
+    dbm = -20;
+  }
+
+  pct = dbm + 120.0f;
+  if (pct < 0) {
+    pct = 0;
+  }
+  if (pct > 100) {
+    pct = 100;
+  }
+}
+
+static std::string format_version_text_(const ParsedFrame &parsed) {
+  if (!parsed.has(ParsedFrame::VERSION)) {
+    return "";
+  }
+
+  std::string type_name;
+  switch (parsed.motor_type_code) {
+    case 'A':
+      type_name = "AC";
+      break;
+    case 'C':
+      type_name = "Curtain";
+      break;
+    case 'D':
+      type_name = "DC";
+      break;
+    case 'S':
+      type_name = "Socket";
+      break;
+    case 'L':
+      type_name = "Lighting";
+      break;
+    default:
+      type_name = std::string("Type ") + parsed.motor_type_code;
+      break;
+  }
+
+  if (parsed.has(ParsedFrame::VERSION_NUMBER)) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%s v%u.%u", type_name.c_str(),
+             parsed.version_major, parsed.version_minor);
+    return buffer;
+  }
+
+  return type_name + " " + parsed.version_code;
+}
+
+static std::string format_limits_text_(std::string_view code) {
+  if (code == "00") {
+    return "Unset";
+  }
+  if (code == "01") {
+    return "Upper/Lower Set";
+  }
+  if (code == "03") {
+    return "Upper/Lower/Preferred Set";
+  }
+  return "Code " + std::string(code);
+}
+
+}  // namespace
+
+// =========================================================
+//  TX QUEUE IMPLEMENTATION
+// =========================================================
+
+void BridgeEngine::queue_tx(std::string_view frame,
+                            TxPriorityClass priority_class,
+                            TxPacingClass pacing_class,
+                            bool is_poll,
+                            BlindId blind_id,
+                            DeliveryExpectation delivery_expectation,
+                            bool allow_retry,
+                            uint32_t tracking_id,
+                            std::string_view expected_ack_token,
+                            std::string_view expected_ack_prefix) {
+  this->enqueue_tx_({frame, pacing_class, is_poll, blind_id, delivery_expectation, allow_retry,
+                     tracking_id, expected_ack_token, expected_ack_prefix},
+                    priority_class);
+}
+
+bool BridgeEngine::enqueue_tx_(const TxQueueItem &item, TxPriorityClass priority_class) {
+  switch (this->tx_scheduler_.push(item, priority_class, this->now_())) {
+    case TxPushResult::DROPPED:
+      ESP_LOGW(TAG, "TX queue full (%u items) -> dropping %s",
+               (unsigned) this->tx_scheduler_.queue().capacity(), item.frame.c_str());
+      return false;
+    case TxPushResult::MERGED:
+      ESP_LOGD(TAG, "TX %s already queued -> merged", item.frame.c_str());
+      return true;
+    case TxPushResult::PROMOTED:
+      ESP_LOGD(TAG, "TX %s already queued -> promoted to %s", item.frame.c_str(),
+               tx_priority_class_name(priority_class));
+      return true;
+    case TxPushResult::QUEUED:
+    default:
+      break;
+  }
+  ESP_LOGD(TAG, "Enqueued TX (%s): %s (queue size=%u, gap=%" PRIu32 " ms)",
+           tx_priority_class_name(priority_class), item.frame.c_str(),
+           (unsigned) this->tx_scheduler_.size(),
+           tx_gap_ms_for(item.pacing_class, this->motion_tx_gap_ms_));
+  return true;
+}
+
+void BridgeEngine::drop_pending_polls_() {
+  if (this->tx_scheduler_.empty()) {
+    return;
+  }
+
+  // Poll/query frames are tracked explicitly on the queue item
+  const size_t dropped = this->tx_scheduler_.drop_polls();
+  if (dropped > 0) {
+    ESP_LOGD(TAG, "Dropped %u queued poll frames", (unsigned) dropped);
+  }
+}
+
+void BridgeEngine::process_tx_queue_() {
+  ARC_PROFILE_SECTION(TX);
+  // Commands queued while the startup guard holds wait for the hub.
+  if (!this->startup_guard_.cleared()) {
+    return;
+  }
+  const uint32_t now = this->now_();
+
+  if (this->tx_scheduler_.empty()) {
+    return;
+  }
+
+  // Nothing can go out before the shorter of the two gaps has passed, so skip
+  // the scheduler scan until then.
+  const uint32_t elapsed = now - this->last_tx_millis_;
+  if (elapsed < std::min(DEFAULT_TX_GAP_MS, this->motion_tx_gap_ms_)) {
+    return;
+  }
+
+  const size_t index = this->tx_scheduler_.select(now, [this](const TxQueueItem &item) {
+    return this->tx_item_fits_delivery_window_(item);
+  });
+  if (index == TxScheduler::NONE) {
+    ESP_LOGVV(TAG, "TX deferred while awaiting blind acknowledgements");
+    return;
+  }
+
+  // Sent straight from its slot; the slot is only released after the write.
+  const TxQueueItem &item = this->tx_scheduler_.queue()[index];
+
+  // Enforce safe ARC timing using the configured per-bridge motion gap
+  const uint32_t required_gap = tx_gap_ms_for(item.pacing_class, this->motion_tx_gap_ms_);
+  if (elapsed < required_gap) {
+    return;
+  }
+
+  this->transmit_(item.frame.view(), now);
+  if (item.blind_id.valid()) {
+    // Lambdas may address blinds nothing registered; delivery tracking still
+    // needs a record for them.
+    BlindRecord *record = item.delivery_expectation == DeliveryExpectation::NONE
+                              ? this->find_blind_(item.blind_id)
+                              : this->register_blind_(item.blind_id);
+    if (record != nullptr) {
+      record->last_tx_ms = now;
+      this->arm_pending_delivery_(*record, item, now);
+    }
+  }
+
+  ESP_LOGD(TAG, "TX -> %s (%s, waited %" PRIu32 " ms, gap=%" PRIu32 " ms)", item.frame.c_str(),
+           tx_priority_class_name(item.priority_class), now - item.enqueued_ms, required_gap);
+  this->tx_scheduler_.complete(index, now);
+}
+
+void BridgeEngine::transmit_(std::string_view frame, uint32_t now) {
+  this->transport_->transmit(frame);
+  this->uart_trace_.record(now, TraceDirection::TX, frame);
+  this->last_tx_millis_ = now;
+}
+
+// =========================================================
+//  SETUP
+// =========================================================
+
+void BridgeEngine::start() {
+  const uint32_t now = this->now_();
+
+  this->boot_millis_ = now;
+  this->uart_trace_.set_origin(now);
+  this->startup_guard_.begin(now);
+#ifdef USE_ARC_BRIDGE_PROFILER
+  this->loop_profiler_.set_cycles_per_us(this->clock_->cycles_per_us());
+#endif
+  // Initialize timing so watchdog and quiet-time logic do not misfire at boot
+  this->last_tx_millis_ = now;
+  this->last_rx_millis_ = now;
+  this->last_query_millis_ = now;
+  this->last_travel_save_ms_ = now;
+  this->last_state_save_ms_ = now;
+  if (this->tx_queue_capacity_ == 0) {
+    // Room for a send_query_all() pass over every blind.
+    this->tx_scheduler_.set_capacity(
+        std::max(DEFAULT_TX_QUEUE_CAPACITY, this->records_.size() * TX_QUERIES_PER_BLIND));
+  }
+  this->load_travel_models_();
+  this->restore_state_snapshots_();
+  this->cleared_tracking_ids_.reserve(this->tx_scheduler_.queue().capacity());
+  if (this->blind_latency_enabled_) {
+    this->blind_latency_.assign(this->records_.size(), CommandLatency{});
+  }
+
+  ESP_LOGI(TAG,
+           "ARCBridge setup (startup guard %" PRIu32 "-%" PRIu32
+           " ms, auto-poll %s, interval %" PRIu32 " ms, tx gaps default=%" PRIu32 " ms motion=%" PRIu32
+           " ms, command retries=%u timeout=%" PRIu32 " ms)",
+           this->startup_guard_.settle_ms(), this->startup_guard_.max_ms(),
+           (this->auto_poll_enabled_ && this->query_interval_ms_ > 0) ? "enabled" : "disabled",
+           this->query_interval_ms_,
+           tx_gap_ms_for(TxPacingClass::STANDARD, this->motion_tx_gap_ms_),
+           tx_gap_ms_for(TxPacingClass::MOTION, this->motion_tx_gap_ms_),
+           this->command_retry_count_,
+           this->command_retry_timeout_ms_);
+}
+
+void BridgeEngine::save_pending_state() {
+  if (this->travel_dirty_) {
+    this->save_travel_models_(this->now_());
+  }
+  if (this->state_dirty_) {
+    this->save_state_snapshots_(this->now_());
+  }
+}
+
+void BridgeEngine::send_startup_probe_(uint32_t now) {
+  this->startup_guard_.mark_probed(now);
+  if (this->records_.empty()) {
+    return;
+  }
+  // A different blind each time, though the hub answers for offline blinds too.
+  const BlindId blind_id =
+      this->blinds_.id_at(this->startup_probe_cursor_++ % this->records_.size());
+  TxFrame frame;
+  if (!build_command_frame(frame, blind_id, 'r', "?")) {
+    return;
+  }
+  this->transmit_(frame.view(), now);
+  ESP_LOGD(TAG, "Startup probe %" PRIu32 " -> %s", this->startup_guard_.probes_sent(),
+           frame.c_str());
+}
+
+void BridgeEngine::on_startup_guard_cleared_(uint32_t now) {
+  if (this->startup_guard_.state() == StartupGuardState::HUB_READY) {
+    ESP_LOGI(TAG, "Startup guard cleared after %" PRIu32 " ms: hub answered (%" PRIu32
+                  " probes)",
+             this->startup_guard_.duration_ms(), this->startup_guard_.probes_sent());
+  } else {
+    ESP_LOGW(TAG, "Startup guard cleared after %" PRIu32 " ms without a hub answer",
+             this->startup_guard_.duration_ms());
+  }
+  if (!this->tx_scheduler_.empty()) {
+    ESP_LOGI(TAG, "Sending %u frames held during the startup guard",
+             static_cast<unsigned>(this->tx_scheduler_.size()));
+  }
+  if (this->startup_sweep_enabled_ && !this->records_.empty()) {
+    this->startup_sweep_.begin(this->records_.size(), now);
+    ESP_LOGI(TAG, "Startup sweep of %u blinds", static_cast<unsigned>(this->records_.size()));
+  }
+}
+
+// =========================================================
+//  LOOP
+// =========================================================
+
+void BridgeEngine::run() {
+#ifdef USE_ARC_BRIDGE_PROFILER
+  this->loop_profiler_.begin_pass(this->clock_->cycle_count());
+#endif
+  const uint32_t now = this->now_();
+
+  // Startup guard
+  if (!this->startup_guard_.cleared()) {
+    ARC_PROFILE_SECTION(POLL);
+    if (this->startup_guard_.update(now)) {
+      this->on_startup_guard_cleared_(now);
+    } else if (this->startup_guard_.probe_due(now)) {
+      this->send_startup_probe_(now);
+    }
+  }
+
+  // -----------------------------
+  // UART RX
+  // -----------------------------
+  this->receive_frames_(now);
+
+  // -----------------------------
+  // MOTION TRACKING
+  // -----------------------------
+  const bool any_blind_moving = this->process_motion_(now);
+  if (this->travel_dirty_ && now - this->last_travel_save_ms_ >= this->travel_save_interval_ms_) {
+    this->save_travel_models_(now);
+  }
+  if (this->state_dirty_ && now - this->last_state_save_ms_ >= this->state_save_interval_ms_) {
+    this->save_state_snapshots_(now);
+  }
+
+  const bool auto_poll_active = this->startup_guard_.cleared() && this->auto_poll_enabled_ &&
+                                this->query_interval_ms_ > 0 && this->cover_count_ > 0 &&
+                                !this->pairing_session_.active &&
+                                !this->startup_sweep_.active();
+
+  // -----------------------------
+  // AUTO POLL
+  // -----------------------------
+  if (auto_poll_active && now - this->last_query_millis_ >= this->query_interval_ms_) {
+    ARC_PROFILE_SECTION(POLL);
+    this->last_query_millis_ = now;
+
+    // Query one blind at a time so large installs do not burst the UART bus,
+    // and only when one has gone quiet for long enough to need it.
+    const size_t index = this->most_stale_blind_(now, this->poll_min_age_ms_);
+    if (index != BlindRegistry::NOT_FOUND) {
+      BlindRecord &record = this->records_[index];
+      const BlindId blind_id = this->blinds_.id_at(index);
+      if (record.poll.heard) {
+        ESP_LOGD(TAG, "Auto-poll: querying blind %s (silent for %" PRIu32 " s)",
+                 blind_id.text().c_str(), record.poll.age_ms(now) / 1000);
+      } else {
+        ESP_LOGD(TAG, "Auto-poll: querying blind %s (never heard)", blind_id.text().c_str());
+      }
+      record.poll.mark_polled(now);
+      this->enqueue_queries_for_id_(blind_id, false, TxPriorityClass::BACKGROUND_POLL);
+    } else {
+      ESP_LOGV(TAG, "Auto-poll: every blind heard within %" PRIu32 " s, skipping",
+               this->poll_min_age_ms_ / 1000);
+    }
+  }
+
+  // -----------------------------
+  // STARTUP SWEEP
+  // -----------------------------
+  // Fed one step at a time, so the sweep runs at the TX gap behind commands.
+  if (this->startup_sweep_.active() && !this->pairing_session_.active &&
+      this->tx_scheduler_.empty()) {
+    this->process_startup_sweep_(now);
+  }
+
+  // -----------------------------
+  // TX QUEUE PROCESSING
+  // -----------------------------
+  this->process_tx_queue_();
+  this->process_pending_deliveries_();
+  this->process_pairing_timeout_();
+
+  // -----------------------------
+  // TX WATCHDOG (movement-aware)
+  // -----------------------------
+  this->process_tx_watchdog_(now, any_blind_moving);
+#ifdef USE_ARC_BRIDGE_PROFILER
+  if (this->loop_profiler_.end_pass(this->clock_->cycle_count())) {
+    this->log_loop_stall_();
+  }
+#endif
+}
+
+void BridgeEngine::receive_frames_(uint32_t now) {
+  char chunk[64];
+  char frame[FrameExtractor::CAPACITY];
+  size_t received;
+  while ((received = this->receive_chunk_(chunk, sizeof(chunk))) > 0) {
+    this->last_rx_millis_ = now;
+    for (size_t i = 0; i < received; i++) {
+      const size_t length = this->extract_frame_(chunk[i], frame, sizeof(frame), now);
+      if (length > 0) {
+        ARC_PROFILE_SECTION(DISPATCH);
+        this->handle_frame(std::string_view(frame, length));
+      }
+    }
+  }
+}
+
+size_t BridgeEngine::receive_chunk_(char *chunk, size_t size) {
+  ARC_PROFILE_SECTION(RX);
+  return this->transport_->receive(chunk, size);
+}
+
+size_t BridgeEngine::extract_frame_(char c, char *frame, size_t size, uint32_t now) {
+  ARC_PROFILE_SECTION(FRAMING);
+  if (!this->rx_frames_.push(c)) {
+    ESP_LOGW(TAG, "RX buffer overflow, resyncing at next frame start (overflows=%" PRIu32 ")",
+             this->rx_frames_.overflow_count());
+  }
+
+  const uint32_t resyncs_before = this->rx_frames_.resync_count();
+  const size_t length = this->rx_frames_.next_frame(frame, size);
+  if (this->rx_frames_.resync_count() != resyncs_before) {
+    ESP_LOGW(TAG, "RX frame interrupted, resynced at next frame start (resyncs=%" PRIu32 ")",
+             this->rx_frames_.resync_count());
+  }
+  if (length > 0) {
+    this->uart_trace_.record(now, TraceDirection::RX, std::string_view(frame, length));
+  }
+  return length;
+}
+
+void BridgeEngine::process_tx_watchdog_(uint32_t now, bool any_blind_moving) {
+  ARC_PROFILE_SECTION(POLL);
+  if (this->tx_scheduler_.empty() || !this->startup_guard_.cleared()) {
+    return;
+  }
+
+  // Skip watchdog entirely until the first TX occurs
+  if (this->last_tx_millis_ == this->boot_millis_) {
+    return;
+  }
+
+  // Use signed deltas so this->now_() rollover does not produce huge values
+  int32_t dt_rx = static_cast<int32_t>(now - this->last_rx_millis_);
+  int32_t dt_tx = static_cast<int32_t>(now - this->last_tx_millis_);
+  if (dt_rx < 0) {
+    dt_rx = 0;
+  }
+  if (dt_tx < 0) {
+    dt_tx = 0;
+  }
+
+  if (static_cast<uint32_t>(dt_rx) >= TX_WATCHDOG_MS &&
+      static_cast<uint32_t>(dt_tx) >= TX_WATCHDOG_MS) {
+    ESP_LOGW(TAG,
+             "TX watchdog: no RX for %" PRIu32 " ms (last TX %" PRIu32
+             " ms ago) while TX pending -> clearing queue",
+             (uint32_t) dt_rx, (uint32_t) dt_tx);
+
+    this->clear_tx_queue_();
+
+    if (!any_blind_moving && this->cover_count_ > 0) {
+      const size_t index = this->most_stale_blind_(now, 0);
+      if (index != BlindRegistry::NOT_FOUND) {
+        const BlindId blind_id = this->blinds_.id_at(index);
+        ESP_LOGW(TAG, "Watchdog: sending wake-up query to %s", blind_id.text().c_str());
+        this->records_[index].poll.mark_polled(now);
+        this->enqueue_queries_for_id_(blind_id, false, TxPriorityClass::BACKGROUND_POLL);
+      }
+    } else if (any_blind_moving) {
+      ESP_LOGW(TAG, "Watchdog: wake-up poll suppressed while blinds are moving");
+    }
+  }
+}
+
+// =========================================================
+//  COVER REGISTRATION
+// =========================================================
+
+size_t BridgeEngine::add_cover(const std::string &id) {
+  BlindRecord *record = this->register_blind_(id);
+  if (record == nullptr) {
+    return BlindRegistry::NOT_FOUND;
+  }
+  if (record->has_cover) {
+    ESP_LOGW(TAG, "Duplicate cover registration for id='%s' will replace direct lookup", id.c_str());
+  } else {
+    record->has_cover = true;
+    this->cover_count_++;
+  }
+
+  ESP_LOGD(TAG, "Registered cover id='%s'", id.c_str());
+  return this->index_of_(*record);
+}
+
+size_t BridgeEngine::map_sensor(const std::string &id, SensorKind kind) {
+  BlindRecord *record = this->register_blind_(id);
+  if (record == nullptr) {
+    return BlindRegistry::NOT_FOUND;
+  }
+  record->mapped_sensors |= 1u << static_cast<uint8_t>(kind);
+  ESP_LOGD(TAG, "Mapped %s sensor for id='%s'", sensor_kind_name(kind), id.c_str());
+  return this->index_of_(*record);
+}
+
+BridgeEngine::BlindRecord *BridgeEngine::register_blind_(BlindId id) {
+  const size_t index = this->blinds_.add(id);
+  if (index == BlindRegistry::NOT_FOUND) {
+    return nullptr;
+  }
+  if (index >= this->records_.size()) {
+    this->records_.resize(index + 1);
+  }
+  return &this->records_[index];
+}
+
+BridgeEngine::BlindRecord *BridgeEngine::register_blind_(const std::string &id) {
+  BlindRecord *record = this->register_blind_(BlindId::from_text(id));
+  if (record == nullptr) {
+    ESP_LOGW(TAG, "Ignoring blind id='%s': ids are exactly 3 characters", id.c_str());
+  }
+  return record;
+}
+
+BridgeEngine::BlindRecord *BridgeEngine::find_blind_(BlindId id) {
+  const size_t index = this->blinds_.find(id);
+  return index < this->records_.size() ? &this->records_[index] : nullptr;
+}
+
+const BridgeEngine::BlindRecord *BridgeEngine::find_blind_(BlindId id) const {
+  const size_t index = this->blinds_.find(id);
+  return index < this->records_.size() ? &this->records_[index] : nullptr;
+}
+
+size_t BridgeEngine::most_stale_blind_(uint32_t now, uint32_t min_age_ms) const {
+  size_t best = BlindRegistry::NOT_FOUND;
+  uint32_t best_urgency = 0;
+  for (size_t i = 0; i < this->records_.size(); i++) {
+    const BlindRecord &record = this->records_[i];
+    // Only blinds with a cover are polled, as with the old round robin. Moving
+    // blinds are already polled by motion tracking.
+    if (!record.has_cover || record.motion.moving) {
+      continue;
+    }
+    const uint32_t urgency = poll_urgency(record.poll, now, min_age_ms);
+    if (urgency > best_urgency) {
+      best = i;
+      best_urgency = urgency;
+    }
+  }
+  return best;
+}
+
+void BridgeEngine::set_blind_poll_policy(const std::string &id, float weight,
+                                         uint32_t max_staleness_ms) {
+  BlindRecord *record = this->register_blind_(id);
+  if (record == nullptr) {
+    return;
+  }
+  record->poll.weight = weight;
+  record->poll.max_staleness_ms = max_staleness_ms;
+}
+
+bool BridgeEngine::process_motion_(uint32_t now) {
+  ARC_PROFILE_SECTION(MOTION);
+  bool any_moving = false;
+  for (size_t i = 0; i < this->records_.size(); i++) {
+    BlindRecord &record = this->records_[i];
+    MotionState &motion = record.motion;
+    if (!motion.moving) {
+      continue;
+    }
+    const BlindId blind_id = this->blinds_.id_at(i);
+    const uint32_t timeout_ms = this->motion_timeout_for_(record);
+    if (motion.expire(now, timeout_ms)) {
+      ESP_LOGW(TAG, "[%s] No final position within %" PRIu32 " ms -> leaving motion state",
+               blind_id.text().c_str(), timeout_ms);
+      record.travel_measurement.cancel();
+      continue;
+    }
+    any_moving = true;
+    if (motion.poll_due(now, this->motion_poll_interval_ms_)) {
+      motion.mark_polled(now);
+      this->send_simple_(blind_id, 'r', "?", TxPriorityClass::INTERACTIVE_QUERY,
+                         TxPacingClass::STANDARD, true);
+    }
+  }
+  return any_moving;
+}
+
+void BridgeEngine::start_motion_(BlindId id) {
+  this->abort_startup_sweep_("a motion command");
+  BlindRecord *record = this->find_blind_(id);
+  if (record != nullptr) {
+    record->motion.start(this->now_());
+  }
+}
+
+uint32_t BridgeEngine::motion_timeout_for_(const BlindRecord &record) const {
+  // A blind quiet for longer than its slowest full travel has stopped.
+  const uint32_t slowest_ms = record.travel.slowest_ms();
+  if (slowest_ms == 0) {
+    return this->motion_timeout_ms_;
+  }
+  return std::min(this->motion_timeout_ms_, slowest_ms + TRAVEL_TIMEOUT_MARGIN_MS);
+}
+
+// =========================================================
+//  TRAVEL TIME MODEL
+// =========================================================
+
+void BridgeEngine::start_travel_(BlindRecord &record, BlindId id, int target, uint32_t now) {
+  record.travel_measurement.start(record.position, target, now);
+  const uint32_t eta_ms = record.travel.eta_ms(record.position, target);
+  if (eta_ms == 0) {
+    return;
+  }
+  record.motion.expect_arrival(now, eta_ms);
+  ESP_LOGD(TAG, "[%s] Moving %d%% -> %d%%, expected in %" PRIu32 " ms", id.text().c_str(),
+           record.position, target, eta_ms);
+}
+
+void BridgeEngine::finish_travel_(BlindRecord &record, BlindId id, int position, uint32_t now) {
+  const TravelDirection direction = record.travel_measurement.direction();
+  const uint32_t full_travel_ms = record.travel_measurement.finish(position, now);
+  if (full_travel_ms == 0) {
+    return;
+  }
+  const char *name = direction == TravelDirection::OPENING ? "open" : "close";
+  if (!record.travel.learn(direction, full_travel_ms)) {
+    ESP_LOGD(TAG, "[%s] Measured full %s of %" PRIu32 " ms not learned (model %" PRIu32 " ms)",
+             id.text().c_str(), name, full_travel_ms, record.travel.full_travel_ms(direction));
+    return;
+  }
+  record.travel_dirty = true;
+  this->travel_dirty_ = true;
+  ESP_LOGD(TAG, "[%s] Measured full %s of %" PRIu32 " ms -> model %" PRIu32 " ms",
+           id.text().c_str(), name, full_travel_ms, record.travel.full_travel_ms(direction));
+}
+
+void BridgeEngine::load_travel_models_() {
+  for (size_t i = 0; i < this->records_.size(); i++) {
+    BlindRecord &record = this->records_[i];
+    const BlindId blind_id = this->blinds_.id_at(i);
+    if (this->storage_ == nullptr ||
+        !this->storage_->load_travel_model(i, blind_id, record.travel)) {
+      record.travel = {};
+      continue;
+    }
+    ESP_LOGD(TAG, "[%s] Restored travel times open=%" PRIu32 " ms close=%" PRIu32 " ms",
+             blind_id.text().c_str(), record.travel.opening_ms, record.travel.closing_ms);
+  }
+}
+
+void BridgeEngine::save_travel_models_(uint32_t now) {
+  ARC_PROFILE_SECTION(MOTION);
+  // Batched so a busy evening of moves costs one flash write per blind.
+  size_t saved = 0;
+  for (size_t i = 0; i < this->records_.size(); i++) {
+    BlindRecord &record = this->records_[i];
+    if (!record.travel_dirty) {
+      continue;
+    }
+    if (this->storage_ != nullptr) {
+      this->storage_->save_travel_model(i, record.travel);
+    }
+    record.travel_dirty = false;
+    saved++;
+  }
+  this->travel_dirty_ = false;
+  this->last_travel_save_ms_ = now;
+  ESP_LOGD(TAG, "Saved travel times of %u blinds", static_cast<unsigned>(saved));
+}
+
+// =========================================================
+//  STATE CACHE
+// =========================================================
+
+void BridgeEngine::restore_state_snapshots_() {
+  const uint32_t now = this->now_();
+  size_t restored = 0;
+  for (size_t i = 0; i < this->records_.size(); i++) {
+    BlindRecord &record = this->records_[i];
+    const BlindId blind_id = this->blinds_.id_at(i);
+    const BlindId::Text id_text = blind_id.text();
+    const char *id = id_text.c_str();
+    BlindSnapshot saved;
+    if (this->storage_ == nullptr || !this->storage_->load_snapshot(i, blind_id, saved) ||
+        !saved.matches(blind_id)) {
+      record.snapshot = BlindSnapshot::empty(blind_id);
+      continue;
+    }
+    record.snapshot = saved;
+    record.restored = true;
+    restored++;
+
+    if (saved.has(BlindSnapshot::VERSION) || saved.has(BlindSnapshot::LIMITS)) {
+      record.static_fetched_ms = now;
+      record.static_stale = saved.static_restores >= MAX_STATIC_RESTORES;
+      if (!record.static_stale) {
+        record.snapshot.static_restores++;
+        record.snapshot_dirty = true;
+        this->state_dirty_ = true;
+      }
+    }
+
+    const char *status = blind_status_text(saved.status);
+    if (status != nullptr) {
+      this->publish_text_sensor_(&record, SensorKind::STATUS, status);
+    }
+    // Offline and unpaired blinds stay unavailable until they are heard.
+    if (saved.has(BlindSnapshot::POSITION) && saved.status == BlindStatus::ONLINE) {
+      record.position = saved.position;
+      if (record.has_cover && this->sink_ != nullptr) {
+        this->sink_->on_cover_position(i, saved.position, false);
+      }
+    }
+    if (saved.has(BlindSnapshot::VOLTAGE)) {
+      this->handle_pvc_value_(&record, id, saved.voltage_centivolts);
+    }
+    const ParsedFrame static_frame = saved.static_frame();
+    if (static_frame.has(ParsedFrame::VERSION) && record.maps(SensorKind::VERSION)) {
+      this->publish_text_sensor_(&record, SensorKind::VERSION,
+                                 format_version_text_(static_frame));
+    }
+    if (static_frame.has(ParsedFrame::LIMITS) && record.maps(SensorKind::LIMITS)) {
+      this->publish_text_sensor_(&record, SensorKind::LIMITS,
+                                 format_limits_text_(static_frame.limits_code_view()));
+    }
+    ESP_LOGD(TAG, "[%s] Restored cached state (status=%s, position=%d), awaiting the blind",
+             id, status != nullptr ? status : "unknown",
+             saved.has(BlindSnapshot::POSITION) ? saved.position : -1);
+  }
+  ESP_LOGI(TAG, "Restored cached state of %u/%u blinds", static_cast<unsigned>(restored),
+           static_cast<unsigned>(this->records_.size()));
+}
+
+void BridgeEngine::save_state_snapshots_(uint32_t now) {
+  ARC_PROFILE_SECTION(MOTION);
+  for (size_t i = 0; i < this->records_.size(); i++) {
+    BlindRecord &record = this->records_[i];
+    if (!record.snapshot_dirty) {
+      continue;
+    }
+    if (this->storage_ != nullptr) {
+      this->storage_->save_snapshot(i, record.snapshot);
+    }
+    record.snapshot_dirty = false;
+  }
+  this->state_dirty_ = false;
+  this->last_state_save_ms_ = now;
+}
+
+bool BridgeEngine::static_refresh_due_(const BlindRecord &record, uint32_t now) const {
+  if (record.static_stale) {
+    return true;
+  }
+  return this->static_refresh_interval_ms_ > 0 &&
+         now - record.static_fetched_ms >= this->static_refresh_interval_ms_;
+}
+
+uint32_t BridgeEngine::get_travel_eta_ms(BlindId id, uint8_t target) const {
+  const BlindRecord *record = this->find_blind_(id);
+  return record != nullptr ? record->travel.eta_ms(record->position, target) : 0;
+}
+
+void BridgeEngine::note_position_heard_(BlindRecord &record, uint32_t now) {
+  record.position_heard = true;
+  if (!record.has_cover) {
+    return;
+  }
+  this->covers_heard_++;
+  if (this->covers_heard_ == this->cover_count_) {
+    this->full_state_ms_ = std::max<uint32_t>(now - this->boot_millis_, 1);
+    ESP_LOGI(TAG, "All %u covers reported a position %" PRIu32 " ms after boot",
+             static_cast<unsigned>(this->cover_count_), this->full_state_ms_);
+  }
+}
+
+uint32_t BridgeEngine::get_blind_age_ms(BlindId id) const {
+  const BlindRecord *record = this->find_blind_(id);
+  return record != nullptr ? record->poll.age_ms(this->now_()) : UINT32_MAX;
+}
+
+const CommandLatency *BridgeEngine::get_blind_command_latency(BlindId id) const {
+  const BlindRecord *record = this->find_blind_(id);
+  if (record == nullptr) {
+    return nullptr;
+  }
+  const size_t index = this->index_of_(*record);
+  return index < this->blind_latency_.size() ? &this->blind_latency_[index] : nullptr;
+}
+
+void BridgeEngine::reset_command_latency() {
+  for (auto &latency : this->command_latency_) {
+    latency.clear();
+  }
+  for (auto &latency : this->blind_latency_) {
+    latency.clear();
+  }
+}
+
+// =========================================================
+//  DELIVERY TRACKING
+// =========================================================
+
+uint32_t BridgeEngine::allocate_tracking_id_() {
+  const uint32_t tracking_id = this->next_tracking_id_++;
+  if (this->next_tracking_id_ == 0) {
+    this->next_tracking_id_ = 1;
+  }
+  return tracking_id;
+}
+
+void BridgeEngine::arm_pending_delivery_(BlindRecord &record, const TxQueueItem &item,
+                                         uint32_t now) {
+  if (item.delivery_expectation == DeliveryExpectation::NONE) {
+    return;
+  }
+
+  auto &pending = record.delivery;
+  const bool same_tracking =
+      record.delivery_pending && pending.item.tracking_id == item.tracking_id;
+  if (!same_tracking) {
+    pending = {};
+  }
+  pending.item = item;
+  if (!same_tracking) {
+    pending.first_enqueued_ms = item.enqueued_ms;
+  }
+  pending.sent_ms = now;
+  this->update_latency_(record, [&item, now](CommandLatency &latency) {
+    latency.queue_wait.record(now - item.enqueued_ms);
+  });
+  if (!record.delivery_pending) {
+    record.delivery_pending = true;
+    this->pending_delivery_count_++;
+  }
+
+  pending.last_activity_ms = now;
+  pending.verification_sent = false;
+
+  ESP_LOGD(TAG, "[%s] Awaiting blind acknowledgement for %s (tracking=%" PRIu32
+                ", retries used=%u)",
+           item.blind_id.text().c_str(), item.frame.c_str(), item.tracking_id,
+           pending.retries_used);
+}
+
+void BridgeEngine::acknowledge_pending_delivery_(BlindRecord &record, const ParsedFrame &parsed) {
+  if (!record.delivery_pending) {
+    return;
+  }
+
+  const TxQueueItem &item = record.delivery.item;
+  if (!frame_confirms_delivery(parsed, item.blind_id, item.delivery_expectation,
+                               item.expected_ack_token.view(),
+                               item.expected_ack_prefix.view())) {
+    return;
+  }
+
+  const uint32_t now = this->now_();
+  const PendingCommandDelivery &pending = record.delivery;
+  if (parsed.lost_link || parsed.not_paired) {
+    this->update_latency_(record, [](CommandLatency &latency) { latency.failed++; });
+    ESP_LOGW(TAG, "[%s] Delivery check failed with explicit blind status for %s", parsed.id,
+             item.frame.c_str());
+  } else {
+    this->update_latency_(record, [&pending, now](CommandLatency &latency) {
+      latency.acknowledged++;
+      latency.ack_rtt.record(now - pending.sent_ms);
+      latency.total.record(now - pending.first_enqueued_ms);
+    });
+    ESP_LOGD(TAG, "[%s] Delivery confirmed for %s (rtt %" PRIu32 " ms, total %" PRIu32 " ms)",
+             parsed.id, item.frame.c_str(), now - pending.sent_ms,
+             now - pending.first_enqueued_ms);
+    const std::string_view token = item.expected_ack_token.view();
+    const int target = motion_target_for_token(token);
+    if (target >= 0) {
+      this->start_travel_(record, item.blind_id, target, now);
+      if (record.has_cover && this->sink_ != nullptr) {
+        this->sink_->on_cover_motion(
+            this->index_of_(record), target,
+            record.travel.full_travel_ms(record.travel_measurement.direction()),
+            this->motion_timeout_for_(record));
+      }
+    } else if (token == "s") {
+      record.travel_measurement.cancel();
+      if (record.has_cover && this->sink_ != nullptr) {
+        this->sink_->on_cover_stop(this->index_of_(record));
+      }
+    }
+  }
+
+  this->finish_pending_delivery_(record, !parsed.lost_link && !parsed.not_paired);
+}
+
+void BridgeEngine::finish_pending_delivery_(BlindRecord &record, bool acknowledged) {
+  record.delivery_pending = false;
+  this->pending_delivery_count_--;
+  if (this->motion_batches_.active() == 0) {
+    return;
+  }
+  MotionBatchStatus finished;
+  if (this->motion_batches_.resolve(record.delivery.item.tracking_id, acknowledged, finished)) {
+    this->report_motion_batch_(finished);
+  }
+}
+
+void BridgeEngine::clear_tx_queue_() {
+  // Batched commands that never went out would otherwise keep their batch
+  // open forever. Queued retries of a delivery in flight are left to it.
+  this->cleared_tracking_ids_.clear();
+  if (this->motion_batches_.active() > 0) {
+    const TxQueue &queue = this->tx_scheduler_.queue();
+    for (size_t i = 0; i < queue.size(); i++) {
+      const TxQueueItem &item = queue[i];
+      if (item.tracking_id == 0) {
+        continue;
+      }
+      const BlindRecord *record = this->find_blind_(item.blind_id);
+      if (record != nullptr && record->delivery_pending &&
+          record->delivery.item.tracking_id == item.tracking_id) {
+        continue;
+      }
+      this->cleared_tracking_ids_.push_back(item.tracking_id);
+    }
+  }
+  this->tx_scheduler_.clear();
+
+  // Reported after the clear, so a batch callback may queue new commands.
+  MotionBatchStatus finished;
+  for (uint32_t tracking_id : this->cleared_tracking_ids_) {
+    if (this->motion_batches_.resolve(tracking_id, false, finished)) {
+      this->report_motion_batch_(finished);
+    }
+  }
+}
+
+bool BridgeEngine::tx_item_fits_delivery_window_(const TxQueueItem &item) const {
+  if (item.delivery_expectation == DeliveryExpectation::NONE ||
+      this->pending_delivery_count_ == 0) {
+    return true;
+  }
+  const BlindRecord *record = this->find_blind_(item.blind_id);
+  const uint32_t blind_tracking_id =
+      record != nullptr && record->delivery_pending ? record->delivery.item.tracking_id : 0;
+  return tx_item_fits_delivery_window(item, blind_tracking_id, this->pending_delivery_count_,
+                                      this->delivery_window_);
+}
+
+void BridgeEngine::send_verification_query_(BlindId id) {
+  TxQueueItem item;
+  if (!build_command_frame(item.frame, id, 'r', "?")) {
+    return;
+  }
+  // Tagged with the blind so it can merge with an r? poll already queued.
+  item.blind_id = id;
+  this->enqueue_tx_(item, TxPriorityClass::RETRY_VERIFY);
+  ESP_LOGW(TAG, "[%s] Queued verification query -> %s", id.text().c_str(), item.frame.c_str());
+}
+
+void BridgeEngine::process_pending_deliveries_() {
+  ARC_PROFILE_SECTION(DELIVERY);
+  if (this->pending_delivery_count_ == 0 || this->command_retry_timeout_ms_ == 0) {
+    return;
+  }
+
+  const uint32_t now = this->now_();
+  for (auto &record : this->records_) {
+    if (!record.delivery_pending) {
+      continue;
+    }
+    auto &pending = record.delivery;
+    const PendingDeliveryPolicy policy{
+        pending.retries_used,
+        this->command_retry_count_,
+        pending.last_activity_ms,
+        this->command_retry_timeout_ms_,
+        pending.verification_sent,
+        pending.item.allow_retry,
+    };
+
+    switch (next_delivery_timeout_action(policy, now)) {
+      case DeliveryTimeoutAction::SEND_VERIFY_QUERY:
+        ESP_LOGW(TAG, "[%s] No qualifying blind reply for %s after %" PRIu32
+                      " ms -> verifying with r?",
+                 pending.item.blind_id.text().c_str(), pending.item.frame.c_str(),
+                 this->command_retry_timeout_ms_);
+        this->send_verification_query_(pending.item.blind_id);
+        pending.verification_sent = true;
+        pending.last_activity_ms = now;
+        break;
+
+      case DeliveryTimeoutAction::RETRY_COMMAND:
+        ESP_LOGW(TAG, "[%s] No blind acknowledgement for %s -> retry %u/%u",
+                 pending.item.blind_id.text().c_str(), pending.item.frame.c_str(),
+                 static_cast<unsigned>(pending.retries_used + 1),
+                 static_cast<unsigned>(this->command_retry_count_));
+        this->drop_pending_polls_();
+        this->enqueue_tx_(pending.item, TxPriorityClass::RETRY_VERIFY);
+        this->update_latency_(record, [](CommandLatency &latency) { latency.retries++; });
+        pending.retries_used++;
+        pending.verification_sent = false;
+        pending.last_activity_ms = now;
+        break;
+
+      case DeliveryTimeoutAction::GIVE_UP:
+        ESP_LOGW(TAG, "[%s] No blind acknowledgement for %s after verification -> giving up",
+                 pending.item.blind_id.text().c_str(), pending.item.frame.c_str());
+        this->update_latency_(record, [](CommandLatency &latency) { latency.given_up++; });
+        this->finish_pending_delivery_(record, false);
+        break;
+
+      case DeliveryTimeoutAction::NONE:
+      default:
+        break;
+    }
+  }
+}
+
+// =========================================================
+//  COMMAND SENDERS (all use queue_tx())
+// =========================================================
+
+uint32_t BridgeEngine::send_simple_(BlindId id, char command,
+                                    std::string_view payload,
+                                    TxPriorityClass priority_class,
+                                    TxPacingClass pacing_class, bool is_poll,
+                                    DeliveryExpectation delivery_expectation,
+                                    bool allow_retry,
+                                    std::string_view expected_ack_token,
+                                    std::string_view expected_ack_prefix) {
+  TxQueueItem item{{}, pacing_class, is_poll, id, delivery_expectation, allow_retry, 0,
+                   expected_ack_token, expected_ack_prefix};
+  if (!id.valid()) {
+    ESP_LOGW(TAG, "Command '%c' needs a 3 character blind id -> ignored", command);
+    return 0;
+  }
+  if (!build_command_frame(item.frame, id, command, payload)) {
+    ESP_LOGW(TAG, "[%s] Command '%c' payload too long -> ignored", id.text().c_str(), command);
+    return 0;
+  }
+  if (delivery_expectation != DeliveryExpectation::NONE) {
+    item.tracking_id = this->allocate_tracking_id_();
+  }
+
+  return this->enqueue_tx_(item, priority_class) ? item.tracking_id : 0;
+}
+
+uint32_t BridgeEngine::queue_motion_(BlindId id, char command, uint8_t percent) {
+  this->start_motion_(id);
+  if (command == 'm') {
+    // "m050": the echoed move token; the payload is the digits after the 'm'.
+    char move_token[5];
+    snprintf(move_token, sizeof(move_token), "m%03u", percent > 100 ? 100 : percent);
+    const std::string_view token(move_token);
+    this->trace_command_(id, 'm', token.substr(1));
+    return this->send_simple_(id, 'm', token.substr(1), TxPriorityClass::MOTION,
+                              TxPacingClass::MOTION, false, DeliveryExpectation::BLIND_REPLY,
+                              true, token, "m");
+  }
+  this->trace_command_(id, command, "");
+  const char token[] = {command, '\0'};
+  const TxPriorityClass priority_class =
+      command == 's' ? TxPriorityClass::EMERGENCY_STOP : TxPriorityClass::MOTION;
+  return this->send_simple_(id, command, "", priority_class, TxPacingClass::MOTION, false,
+                            DeliveryExpectation::BLIND_REPLY, true, token);
+}
+
+void BridgeEngine::send_open(BlindId id) {
+  this->drop_pending_polls_();
+  this->queue_motion_(id, 'o');
+}
+
+void BridgeEngine::send_close(BlindId id) {
+  this->drop_pending_polls_();
+  this->queue_motion_(id, 'c');
+}
+
+void BridgeEngine::send_stop(BlindId id) {
+  this->drop_pending_polls_();
+  this->queue_motion_(id, 's');
+}
+
+void BridgeEngine::send_move(BlindId id, uint8_t percent) {
+  this->drop_pending_polls_();
+  this->queue_motion_(id, 'm', percent);
+}
+
+uint32_t BridgeEngine::send_move_batch(const std::vector<MotionBatchTarget> &targets) {
+  this->drop_pending_polls_();
+  const uint32_t batch_id = this->motion_batches_.begin();
+  for (size_t i = 0; i < targets.size(); i++) {
+    const MotionBatchTarget &target = targets[i];
+    const auto earlier_end = targets.begin() + i;
+    if (std::find_if(targets.begin(), earlier_end, [&target](const MotionBatchTarget &earlier) {
+          return earlier.id == target.id;
+        }) != earlier_end) {
+      continue;
+    }
+    // Same mapping as ARCCover: the end stops use the open and close commands.
+    char command = 'm';
+    if (target.percent >= 100) {
+      command = 'c';
+    } else if (target.percent == 0) {
+      command = 'o';
+    }
+    this->motion_batches_.add(batch_id, this->queue_motion_(target.id, command, target.percent));
+  }
+  this->seal_motion_batch_(batch_id);
+  return batch_id;
+}
+
+uint32_t BridgeEngine::send_stop_batch(const std::vector<BlindId> &ids) {
+  this->drop_pending_polls_();
+  const uint32_t batch_id = this->motion_batches_.begin();
+  for (size_t i = 0; i < ids.size(); i++) {
+    if (std::find(ids.begin(), ids.begin() + i, ids[i]) != ids.begin() + i) {
+      continue;
+    }
+    this->motion_batches_.add(batch_id, this->queue_motion_(ids[i], 's'));
+  }
+  this->seal_motion_batch_(batch_id);
+  return batch_id;
+}
+
+void BridgeEngine::seal_motion_batch_(uint32_t batch_id) {
+  MotionBatchStatus finished;
+  if (this->motion_batches_.seal(batch_id, finished)) {
+    this->report_motion_batch_(finished);
+  } else {
+    ESP_LOGD(TAG, "Motion batch %" PRIu32 " queued", batch_id);
+  }
+}
+
+void BridgeEngine::report_motion_batch_(const MotionBatchStatus &status) {
+  const MotionBatchOutcome outcome = status.outcome();
+  if (outcome == MotionBatchOutcome::ALL_ACKNOWLEDGED) {
+    ESP_LOGD(TAG, "Motion batch %" PRIu32 ": all %u blinds acknowledged", status.id,
+             static_cast<unsigned>(status.total));
+  } else {
+    ESP_LOGW(TAG, "Motion batch %" PRIu32 ": %s (%u of %u blinds acknowledged)", status.id,
+             motion_batch_outcome_name(outcome), static_cast<unsigned>(status.acknowledged),
+             static_cast<unsigned>(status.total));
+  }
+  if (this->sink_ != nullptr) {
+    this->sink_->on_motion_batch(status);
+  }
+}
+
+void BridgeEngine::send_query(BlindId id) {
+  this->send_simple_(id, 'r', "?", TxPriorityClass::INTERACTIVE_QUERY, TxPacingClass::STANDARD,
+                     true);
+}
+
+void BridgeEngine::send_query_all() {
+  ARC_PROFILE_SECTION(QUERY_ALL);
+  this->drop_pending_polls_();
+
+  ESP_LOGI(TAG, "Queueing a manual query pass for %u covers", (unsigned) this->cover_count_);
+  for (size_t i = 0; i < this->records_.size(); i++) {
+    if (!this->records_[i].has_cover) {
+      continue;
+    }
+    this->enqueue_queries_for_id_(this->blinds_.id_at(i), true,
+                                  TxPriorityClass::INTERACTIVE_QUERY);
+  }
+}
+
+void BridgeEngine::send_pair_command() {
+  this->drop_pending_polls_();
+  start_pairing_session(this->pairing_session_, this->now_());
+  this->publish_pairing_status_("Pairing");
+
+  const std::string frame = build_pair_command_frame();
+  this->queue_tx(frame, TxPriorityClass::MOTION);
+  ESP_LOGI(TAG, "TX queued -> %s (pairing: random assignment)", frame.c_str());
+}
+
+void BridgeEngine::send_raw_command(const std::string &cmd) {
+  if (cmd.empty()) {
+    ESP_LOGW(TAG, "send_raw_command: empty ignored");
+    return;
+  }
+
+  TxQueueItem item;
+  if (!build_raw_frame(item.frame, cmd)) {
+    ESP_LOGW(TAG, "send_raw_command: longer than %u characters, ignored",
+             (unsigned) TxFrame::CAPACITY);
+    return;
+  }
+
+  this->drop_pending_polls_();
+  this->enqueue_tx_(item, TxPriorityClass::MOTION);
+  ESP_LOGI(TAG, "TX queued (raw) -> %s", item.frame.c_str());
+}
+
+void BridgeEngine::send_favorite(BlindId id) {
+  this->start_motion_(id);
+  this->drop_pending_polls_();
+  this->trace_command_(id, 'f', "");
+  this->send_simple_(id, 'f', "", TxPriorityClass::MOTION, TxPacingClass::MOTION, false,
+                     DeliveryExpectation::BLIND_REPLY, false, "f");
+}
+
+void BridgeEngine::send_jog_open(BlindId id) {
+  this->start_motion_(id);
+  this->drop_pending_polls_();
+  this->trace_command_(id, 'o', "A");
+  this->send_simple_(id, 'o', "A", TxPriorityClass::MOTION, TxPacingClass::MOTION, false,
+                     DeliveryExpectation::BLIND_REPLY, false, "oA");
+}
+
+void BridgeEngine::send_jog_close(BlindId id) {
+  this->start_motion_(id);
+  this->drop_pending_polls_();
+  this->trace_command_(id, 'c', "A");
+  this->send_simple_(id, 'c', "A", TxPriorityClass::MOTION, TxPacingClass::MOTION, false,
+                     DeliveryExpectation::BLIND_REPLY, false, "cA");
+}
+
+void BridgeEngine::send_voltage_query(BlindId id) {
+  this->send_simple_(id, 'p', "Vc?", TxPriorityClass::INTERACTIVE_QUERY, TxPacingClass::STANDARD,
+                     true);
+}
+
+void BridgeEngine::send_version_query(BlindId id) {
+  this->send_simple_(id, 'v', "?", TxPriorityClass::INTERACTIVE_QUERY, TxPacingClass::STANDARD,
+                     true);
+}
+
+void BridgeEngine::send_speed_query(BlindId id) {
+  this->send_simple_(id, 'p', "Sc?", TxPriorityClass::INTERACTIVE_QUERY, TxPacingClass::STANDARD,
+                     true);
+}
+
+void BridgeEngine::send_limits_query(BlindId id) {
+  this->send_simple_(id, 'p', "P?", TxPriorityClass::INTERACTIVE_QUERY, TxPacingClass::STANDARD,
+                     true);
+}
+
+void BridgeEngine::enqueue_queries_for_id_(BlindId id, bool force_static,
+                                           TxPriorityClass query_class) {
+  // Always queue the position query first so state recovers quickly after silence.
+  this->send_simple_(id, 'r', "?", query_class, TxPacingClass::STANDARD, true);
+
+  const BlindRecord *record = this->find_blind_(id);
+  if (record == nullptr) {
+    return;
+  }
+  this->queue_telemetry_queries_(id, *record, query_class);
+  this->queue_static_queries_(id, *record, force_static, query_class);
+}
+
+size_t BridgeEngine::queue_telemetry_queries_(BlindId id, const BlindRecord &record,
+                                              TxPriorityClass query_class) {
+  size_t queued = 0;
+  if (record.maps(SensorKind::VOLTAGE) || record.maps(SensorKind::BATTERY_LEVEL)) {
+    this->send_simple_(id, 'p', "Vc?", query_class, TxPacingClass::STANDARD, true);
+    queued++;
+  }
+
+  if (record.maps(SensorKind::SPEED)) {
+    this->send_simple_(id, 'p', "Sc?", query_class, TxPacingClass::STANDARD, true);
+    queued++;
+  }
+  return queued;
+}
+
+size_t BridgeEngine::queue_static_queries_(BlindId id, const BlindRecord &record,
+                                           bool force_static, TxPriorityClass query_class) {
+  // Version and limits rarely change, so they never rank above the blind's
+  // other queries. Values restored at boot are only refreshed once stale.
+  const TxPriorityClass static_class = std::max(query_class, TxPriorityClass::STATIC_QUERY);
+  const bool static_due = force_static || this->static_refresh_due_(record, this->now_());
+  size_t queued = 0;
+  if (record.maps(SensorKind::VERSION) && (static_due || !record.has_state(SensorKind::VERSION))) {
+    this->send_simple_(id, 'v', "?", static_class, TxPacingClass::STANDARD, true);
+    queued++;
+  }
+
+  if (record.maps(SensorKind::LIMITS) && (static_due || !record.has_state(SensorKind::LIMITS))) {
+    this->send_simple_(id, 'p', "P?", static_class, TxPacingClass::STANDARD, true);
+    queued++;
+  }
+  return queued;
+}
+
+// =========================================================
+//  STARTUP SWEEP
+// =========================================================
+
+void BridgeEngine::process_startup_sweep_(uint32_t now) {
+  ARC_PROFILE_SECTION(POLL);
+  size_t index = 0;
+  SweepPhase phase = SweepPhase::DONE;
+  while (this->startup_sweep_.next(index, phase)) {
+    const size_t queued = this->sweep_step_(index, phase, now);
+    if (queued > 0) {
+      this->startup_sweep_queries_ += queued;
+      return;
+    }
+  }
+  ESP_LOGI(TAG, "Startup sweep done: %" PRIu32 " queries in %" PRIu32 " ms",
+           this->startup_sweep_queries_, now - this->startup_sweep_.started_ms());
+  // Auto-poll takes over one interval from now.
+  this->last_query_millis_ = now;
+}
+
+size_t BridgeEngine::sweep_step_(size_t index, SweepPhase phase, uint32_t now) {
+  BlindRecord &record = this->records_[index];
+  const BlindId blind_id = this->blinds_.id_at(index);
+  switch (phase) {
+    case SweepPhase::POSITION:
+      // Moving blinds are already polled by motion tracking.
+      if (record.motion.moving ||
+          (!record.has_cover && !record.maps(SensorKind::LINK_QUALITY) &&
+           !record.maps(SensorKind::STATUS))) {
+        return 0;
+      }
+      record.poll.mark_polled(now);
+      this->send_simple_(blind_id, 'r', "?", TxPriorityClass::BACKGROUND_POLL,
+                         TxPacingClass::STANDARD, true);
+      return 1;
+    case SweepPhase::TELEMETRY:
+      return this->queue_telemetry_queries_(blind_id, record, TxPriorityClass::BACKGROUND_POLL);
+    case SweepPhase::STATIC:
+      return this->queue_static_queries_(blind_id, record, false,
+                                         TxPriorityClass::BACKGROUND_POLL);
+    case SweepPhase::DONE:
+    default:
+      return 0;
+  }
+}
+
+void BridgeEngine::abort_startup_sweep_(const char *reason) {
+  if (!this->startup_sweep_.active()) {
+    return;
+  }
+  this->startup_sweep_.abort();
+  this->last_query_millis_ = this->now_();
+  ESP_LOGI(TAG, "Startup sweep stopped by %s after %" PRIu32 " queries; auto-poll takes over",
+           reason, this->startup_sweep_queries_);
+}
+
+// =========================================================
+//  FRAME PARSING
+// =========================================================
+
+void BridgeEngine::handle_frame(std::string_view frame) {
+  ESP_LOGD(TAG, "RX raw -> %.*s", static_cast<int>(frame.size()), frame.data());
+  if (frame.size() < 5) {
+    return;
+  }
+  this->parse_frame(frame);
+}
+
+void BridgeEngine::parse_frame(std::string_view frame) {
+  const ParsedFrame parsed = parse_arc_frame(frame);
+  if (!parsed.valid) {
+    return;
+  }
+  this->startup_guard_.frame_received();
+
+  BlindRecord *record = this->find_blind_(parsed.blind_id);
+  if (record != nullptr) {
+    const uint32_t now = this->now_();
+    record->poll.mark_heard(now);
+    if (parsed.has(ParsedFrame::POSITION) && !record->position_heard) {
+      this->note_position_heard_(*record, now);
+    }
+    if (!parsed.has(ParsedFrame::ERROR)) {
+      record->restored = false;
+    }
+    if (record->snapshot.update(parsed)) {
+      record->snapshot_dirty = true;
+      this->state_dirty_ = true;
+    }
+    if (parsed.has(ParsedFrame::VERSION) || parsed.has(ParsedFrame::LIMITS)) {
+      record->static_fetched_ms = now;
+      record->static_stale = false;
+    } else if (parsed.not_paired) {
+      // A blind paired again may be a different motor.
+      record->static_stale = true;
+    }
+    if (parsed.lost_link || parsed.not_paired) {
+      record->motion.stop();
+      record->travel_measurement.cancel();
+    } else if (parsed.has(ParsedFrame::POSITION)) {
+      const int position = static_cast<int>(parsed.position_percent);
+      if (record->motion.report(parsed.position_in_motion, now)) {
+        ESP_LOGD(TAG, "[%s] Arrived at %d%%", parsed.id, position);
+      }
+      if (parsed.position_in_motion) {
+        record->travel_measurement.sample(position, now);
+      } else {
+        this->finish_travel_(*record, parsed.blind_id, position, now);
+      }
+      if (position >= 0 && position <= 100) {
+        record->position = static_cast<int8_t>(position);
+      }
+    }
+    this->acknowledge_pending_delivery_(*record, parsed);
+  }
+
+  const PairingOutcome pairing_outcome = handle_pairing_frame(this->pairing_session_, parsed);
+  if (pairing_outcome.type != PairingOutcomeType::NONE) {
+    this->handle_pairing_outcome_(pairing_outcome);
+    return;
+  }
+
+  if (parsed.has(ParsedFrame::ERROR)) {
+    const std::string error_text = describe_error_code(parsed.error_code_view());
+    ESP_LOGW(TAG, "[%s] Error %s -> %s", parsed.id, parsed.error_code, error_text.c_str());
+    return;
+  }
+
+  const char *id = parsed.id;
+  // Frames from blinds nothing is mapped to still get logged below.
+  static const BlindRecord UNMAPPED{};
+  const BlindRecord &mapped = record != nullptr ? *record : UNMAPPED;
+  const bool has_cover = mapped.has_cover && this->sink_ != nullptr;
+  const size_t index = record != nullptr ? this->index_of_(*record) : BlindRegistry::NOT_FOUND;
+
+  float dbm = NAN;
+  float pct = NAN;
+  if (parsed.has(ParsedFrame::RSSI)) {
+    decode_rssi(parsed.rssi_raw, dbm, pct);
+    ESP_LOGI(TAG, "[%s] R=%02X -> %.1f dBm (%.1f%%)", id,
+             parsed.rssi_raw, dbm, pct);
+  }
+
+  // Handle pVc replies before availability/status updates.
+  if (parsed.has(ParsedFrame::VOLTAGE)) {
+    this->handle_pvc_value_(record, id, parsed.voltage_centivolts);
+  }
+
+  if (parsed.has(ParsedFrame::SPEED) && mapped.maps(SensorKind::SPEED)) {
+    this->publish_sensor_(record, SensorKind::SPEED, static_cast<float>(parsed.speed_rpm));
+    ESP_LOGD(TAG, "[%s] speed=%" PRId32 " rpm", id, parsed.speed_rpm);
+  }
+
+  if (parsed.has(ParsedFrame::VERSION) && mapped.maps(SensorKind::VERSION)) {
+    const std::string version_text = format_version_text_(parsed);
+    this->publish_text_sensor_(record, SensorKind::VERSION, version_text);
+    ESP_LOGD(TAG, "[%s] version=%s", id, version_text.c_str());
+  }
+
+  if (parsed.has(ParsedFrame::LIMITS) && mapped.maps(SensorKind::LIMITS)) {
+    const std::string limits_text = format_limits_text_(parsed.limits_code_view());
+    this->publish_text_sensor_(record, SensorKind::LIMITS, limits_text);
+    ESP_LOGD(TAG, "[%s] limits=%s", id, limits_text.c_str());
+  }
+
+  if (parsed.lost_link) {
+    this->publish_text_sensor_(record, SensorKind::STATUS, "Offline");
+    this->publish_sensor_(record, SensorKind::LINK_QUALITY, NAN);
+    if (has_cover) {
+      this->sink_->on_cover_available(index, false);
+    }
+    ESP_LOGW(TAG, "[%s] Lost link", id);
+    return;
+  }
+
+  if (parsed.not_paired) {
+    this->publish_text_sensor_(record, SensorKind::STATUS, "Not Paired");
+    this->publish_sensor_(record, SensorKind::LINK_QUALITY, NAN);
+    if (has_cover) {
+      this->sink_->on_cover_available(index, false);
+    }
+    ESP_LOGW(TAG, "[%s] Not paired", id);
+    return;
+  }
+
+  if (!std::isnan(dbm)) {
+    this->publish_sensor_(record, SensorKind::LINK_QUALITY, dbm);
+  }
+
+  this->publish_text_sensor_(record, SensorKind::STATUS,
+                             parsed.no_position ? "No Position" : "Online");
+
+  if (has_cover) {
+    this->sink_->on_cover_available(index, true);
+  }
+
+  if (parsed.has(ParsedFrame::POSITION) && has_cover) {
+    this->sink_->on_cover_position(index, parsed.position_percent, parsed.position_in_motion);
+    if (parsed.position_in_motion) {
+      ESP_LOGD(TAG, "[%s] In-progress position=%" PRId32, id, parsed.position_percent);
+    }
+  }
+
+  if (parsed.no_position) {
+    ESP_LOGW(TAG, "[%s] No position/limits feedback", id);
+  }
+
+  ESP_LOGD(TAG, "Parsed id=%s pos=%" PRId32 " moving=%s RSSI=%.1f",
+           id,
+           parsed.has(ParsedFrame::POSITION) ? parsed.position_percent : -1,
+           parsed.position_in_motion ? "true" : "false",
+           dbm);
+}
+
+void BridgeEngine::publish_pairing_status_(const std::string &status) {
+  if (this->sink_ != nullptr) {
+    this->sink_->on_pairing_status(status);
+  }
+}
+
+void BridgeEngine::publish_last_paired_id_(const std::string &id) {
+  if (this->sink_ != nullptr) {
+    this->sink_->on_last_paired_id(id);
+  }
+}
+
+void BridgeEngine::handle_pairing_outcome_(const PairingOutcome &outcome) {
+  switch (outcome.type) {
+    case PairingOutcomeType::SUCCESS:
+      this->publish_pairing_status_(outcome.message);
+      this->publish_last_paired_id_(outcome.paired_id);
+      ESP_LOGI(TAG, "[%s] Pairing successful", outcome.paired_id.c_str());
+      break;
+
+    case PairingOutcomeType::ERROR:
+      this->publish_pairing_status_(outcome.message);
+      ESP_LOGW(TAG, "%s", outcome.message.c_str());
+      break;
+
+    case PairingOutcomeType::TIMEOUT:
+      this->publish_pairing_status_(outcome.message);
+      ESP_LOGW(TAG, "Pairing timed out after %" PRIu32 " ms", PAIRING_TIMEOUT_MS);
+      break;
+
+    case PairingOutcomeType::GENERIC_ACK:
+      ESP_LOGI(TAG, "[%s] Received admin acknowledgement", outcome.paired_id.c_str());
+      break;
+
+    case PairingOutcomeType::NONE:
+    default:
+      break;
+  }
+}
+
+void BridgeEngine::process_pairing_timeout_() {
+  ARC_PROFILE_SECTION(DELIVERY);
+  const PairingOutcome outcome =
+      check_pairing_timeout(this->pairing_session_, this->now_(), PAIRING_TIMEOUT_MS);
+  if (outcome.type != PairingOutcomeType::NONE) {
+    this->handle_pairing_outcome_(outcome);
+  }
+}
+
+void BridgeEngine::publish_sensor_(BlindRecord *record, SensorKind kind, float value) {
+  if (record == nullptr || !record->maps(kind)) {
+    return;
+  }
+  auto &slot = record->published[static_cast<size_t>(kind)];
+  if (this->publish_filter_.admit(slot, kind, value, this->now_()) && this->sink_ != nullptr) {
+    this->sink_->on_sensor(this->index_of_(*record), kind, value);
+  }
+}
+
+void BridgeEngine::publish_text_sensor_(BlindRecord *record, SensorKind kind,
+                                        std::string_view value) {
+  if (record == nullptr || !record->maps(kind)) {
+    return;
+  }
+  auto &slot = record->published[static_cast<size_t>(kind)];
+  if (this->publish_filter_.admit_text(slot, kind, value, this->now_()) &&
+      this->sink_ != nullptr) {
+    this->sink_->on_text_sensor(this->index_of_(*record), kind, value);
+  }
+}
+
+void BridgeEngine::handle_pvc_value_(BlindRecord *record, const char *id, int32_t raw_value) {
+  if (raw_value < 0) {
+    ESP_LOGW(TAG, "[%s] Invalid pVc value=%" PRId32, id, raw_value);
+    return;
+  }
+
+  const bool has_battery = record != nullptr && record->maps(SensorKind::BATTERY_LEVEL);
+  if (!has_battery && (record == nullptr || !record->maps(SensorKind::VOLTAGE))) {
+    ESP_LOGD(TAG, "[%s] pVc=%" PRId32 " but no mapped voltage or battery sensor", id,
+             raw_value);
+    return;
+  }
+
+  // 0 → AC motor; publish 0.0V but log as AC
+  if (raw_value == 0) {
+    this->publish_sensor_(record, SensorKind::VOLTAGE, 0.0f);
+    this->publish_sensor_(record, SensorKind::BATTERY_LEVEL, NAN);
+    ESP_LOGD(TAG, "[%s] pVc=0 -> AC motor, publishing 0.00V and leaving battery unavailable",
+             id);
+    return;
+  }
+
+  // Non-zero → scaled voltage (raw is in centivolts)
+  const float volts = static_cast<float>(raw_value) / 100.0f;
+  this->publish_sensor_(record, SensorKind::VOLTAGE, volts);
+  if (has_battery) {
+    const float battery_pct = battery_percent_from_3s_li_ion(volts);
+    this->publish_sensor_(record, SensorKind::BATTERY_LEVEL, battery_pct);
+    ESP_LOGD(TAG, "[%s] pVc raw=%" PRId32 " -> %.2fV / %.1f%%", id, raw_value, volts,
+             battery_pct);
+  } else {
+    ESP_LOGD(TAG, "[%s] pVc raw=%" PRId32 " -> %.2fV", id, raw_value, volts);
+  }
+}
+
+// =========================================================
+//  UART TRACE
+// =========================================================
+
+void BridgeEngine::trace_command_(BlindId id, char command, std::string_view payload) {
+  if (!this->uart_trace_.enabled()) {
+    return;
+  }
+  TxFrame frame;
+  if (build_command_frame(frame, id, command, payload)) {
+    this->uart_trace_.record(this->now_(), TraceDirection::COMMAND, frame.view());
+  }
+}
+
+void BridgeEngine::dump_uart_trace() {
+  if (!this->uart_trace_.enabled()) {
+    ESP_LOGW(TAG, "UART trace is disabled; set uart_trace_size to record one");
+    return;
+  }
+  std::vector<uint8_t> capture;
+  this->uart_trace_.export_capture(capture);
+  ESP_LOGI(TAG, "UART trace: %" PRIu32 " records, %u bytes, %" PRIu32 " dropped",
+           this->uart_trace_.record_count(), static_cast<unsigned>(capture.size()),
+           this->uart_trace_.dropped());
+
+  // Fixed-width hex lines that tests/run_trace_replay.py reassembles.
+  static constexpr size_t BYTES_PER_LINE = 32;
+  static const char HEX[] = "0123456789abcdef";
+  char line[BYTES_PER_LINE * 2 + 1];
+  for (size_t offset = 0; offset < capture.size(); offset += BYTES_PER_LINE) {
+    const size_t count = std::min(BYTES_PER_LINE, capture.size() - offset);
+    for (size_t i = 0; i < count; i++) {
+      line[i * 2] = HEX[capture[offset + i] >> 4];
+      line[i * 2 + 1] = HEX[capture[offset + i] & 0x0F];
+    }
+    line[count * 2] = '\0';
+    ESP_LOGI(TAG, "uart_trace %04X: %s", static_cast<unsigned>(offset), line);
+  }
+  ESP_LOGI(TAG, "UART trace end");
+}
+
+static void log_command_latency(const char *label, const CommandLatency &latency) {
+  ESP_LOGI(TAG, "command_latency %s: acked=%" PRIu32 " failed=%" PRIu32 " retries=%" PRIu32
+                " given_up=%" PRIu32,
+           label, latency.acknowledged, latency.failed, latency.retries, latency.given_up);
+  for (LatencyStage stage :
+       {LatencyStage::QUEUE_WAIT, LatencyStage::ACK_RTT, LatencyStage::TOTAL}) {
+    const LatencyHistogram &histogram = latency_stage(latency, stage);
+    if (histogram.count() == 0) {
+      continue;
+    }
+    // Non-empty buckets as "<=bound:count", the open-ended last one as ">bound:count".
+    char buckets[LATENCY_BUCKET_COUNT * 20];
+    size_t length = 0;
+    for (size_t i = 0; i < LATENCY_BUCKET_COUNT; i++) {
+      if (histogram.bucket(i) == 0) {
+        continue;
+      }
+      const bool last = i + 1 == LATENCY_BUCKET_COUNT;
+      length += snprintf(buckets + length, sizeof(buckets) - length, " %s%" PRIu32 ":%" PRIu32,
+                         last ? ">" : "<=",
+                         last ? LATENCY_BUCKET_BOUNDS_MS[i - 1] : LATENCY_BUCKET_BOUNDS_MS[i],
+                         histogram.bucket(i));
+      if (length >= sizeof(buckets)) {
+        break;
+      }
+    }
+    buckets[length < sizeof(buckets) ? length : sizeof(buckets) - 1] = '\0';
+    ESP_LOGI(TAG, "  %s: n=%" PRIu32 " p50=%" PRIu32 " p95=%" PRIu32 " max=%" PRIu32
+                  " mean=%" PRIu32 " ms,%s",
+             latency_stage_name(stage), histogram.count(), histogram.percentile_ms(50),
+             histogram.percentile_ms(95), histogram.max_ms(), histogram.mean_ms(), buckets);
+  }
+}
+
+#ifdef USE_ARC_BRIDGE_PROFILER
+void BridgeEngine::dump_loop_profile() {
+  const LoopProfiler &profiler = this->loop_profiler_;
+  ESP_LOGI(TAG, "Loop profile: %" PRIu32 " passes, %" PRIu32 " over %" PRIu32 " us",
+           profiler.stats(LoopSection::LOOP).runs, profiler.stalls(),
+           profiler.stall_threshold_us());
+  for (size_t i = 0; i < LOOP_SECTION_COUNT; i++) {
+    const LoopSection section = static_cast<LoopSection>(i);
+    const LoopSectionStats &stats = profiler.stats(section);
+    ESP_LOGI(TAG, "  %-9s runs=%" PRIu32 " mean=%" PRIu32 " us max=%" PRIu32 " us",
+             loop_section_name(section), stats.runs, profiler.to_us(stats.mean_cycles()),
+             profiler.to_us(stats.max_cycles));
+  }
+}
+
+void BridgeEngine::log_loop_stall_() {
+  const LoopProfiler &profiler = this->loop_profiler_;
+  ESP_LOGW(TAG, "Loop pass took %" PRIu32 " us: rx=%" PRIu32 " framing=%" PRIu32
+                " dispatch=%" PRIu32 " motion=%" PRIu32 " poll=%" PRIu32 " tx=%" PRIu32
+                " delivery=%" PRIu32 " query_all=%" PRIu32,
+           profiler.to_us(profiler.last_pass_cycles(LoopSection::LOOP)),
+           profiler.to_us(profiler.last_pass_cycles(LoopSection::RX)),
+           profiler.to_us(profiler.last_pass_cycles(LoopSection::FRAMING)),
+           profiler.to_us(profiler.last_pass_cycles(LoopSection::DISPATCH)),
+           profiler.to_us(profiler.last_pass_cycles(LoopSection::MOTION)),
+           profiler.to_us(profiler.last_pass_cycles(LoopSection::POLL)),
+           profiler.to_us(profiler.last_pass_cycles(LoopSection::TX)),
+           profiler.to_us(profiler.last_pass_cycles(LoopSection::DELIVERY)),
+           profiler.to_us(profiler.last_pass_cycles(LoopSection::QUERY_ALL)));
+}
+#endif
+
+void BridgeEngine::dump_command_latency() {
+  for (size_t i = 0; i < TX_PACING_CLASS_COUNT; i++) {
+    log_command_latency(tx_pacing_class_name(static_cast<TxPacingClass>(i)),
+                        this->command_latency_[i]);
+  }
+  for (size_t i = 0; i < this->blind_latency_.size(); i++) {
+    if (this->blind_latency_[i].queue_wait.count() == 0) {
+      continue;
+    }
+    log_command_latency(this->blinds_.id_at(i).text().c_str(), this->blind_latency_[i]);
+  }
+}
+
+}  // namespace arc_bridge
+}  // namespace esphome
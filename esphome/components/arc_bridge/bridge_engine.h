@@ -0,0 +1,548 @@
+#pragma once
+
+#include "blind_id.h"
+#include "blind_registry.h"
+#include "delivery.h"
+#include "frame_extractor.h"
+#include "latency_histogram.h"
+#include "loop_profiler.h"
+#include "motion_batch.h"
+#include "motion_tracker.h"
+#include "pairing.h"
+#include "poll_scheduler.h"
+#include "publish_filter.h"
+#include "startup_guard.h"
+#include "startup_sweep.h"
+#include "state_cache.h"
+#include "travel_model.h"
+#include "tx_queue.h"
+#include "uart_trace.h"
+
+// USE_ARC_BRIDGE_PROFILER comes from the generated defines on the device;
+// host builds pass it on the command line.
+#ifndef ARC_BRIDGE_HOST
+#include "esphome/core/defines.h"
+#endif
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace esphome {
+namespace arc_bridge {
+
+// Millisecond time the engine runs on. Wraps around like millis().
+class BridgeClock {
+ public:
+  virtual ~BridgeClock() = default;
+  virtual uint32_t now_ms() const = 0;
+  // Free-running CPU cycle counter and its rate, only read by the loop
+  // profiler (USE_ARC_BRIDGE_PROFILER).
+  virtual uint32_t cycle_count() const { return 0; }
+  virtual uint32_t cycles_per_us() const { return 1; }
+};
+
+// The byte link to the hub.
+class BridgeTransport {
+ public:
+  virtual ~BridgeTransport() = default;
+  // Copies up to `size` received bytes into `buffer`; returns how many.
+  virtual size_t receive(char *buffer, size_t size) = 0;
+  virtual void transmit(std::string_view bytes) = 0;
+};
+
+// Where the engine reports state. Blinds are passed by their registry index,
+// see BridgeEngine::blind_id_at(). Every event defaults to a no-op.
+class BridgeEventSink {
+ public:
+  virtual ~BridgeEventSink() = default;
+  // Only called for sensor kinds mapped with BridgeEngine::map_sensor(), and
+  // only for values the publish filter admits. NAN marks a sensor unavailable.
+  virtual void on_sensor(size_t /*blind*/, SensorKind /*kind*/, float /*value*/) {}
+  virtual void on_text_sensor(size_t /*blind*/, SensorKind /*kind*/, std::string_view /*value*/) {}
+  // Cover events are only sent for blinds added with BridgeEngine::add_cover().
+  // `in_motion` marks a "<NN" report from a blind that is still travelling.
+  virtual void on_cover_position(size_t /*blind*/, int /*position*/, bool /*in_motion*/) {}
+  // False when the blind is offline or unpaired. True on every other reply;
+  // a cover that already shows a state can ignore it.
+  virtual void on_cover_available(size_t /*blind*/, bool /*available*/) {}
+  // The blind acknowledged a move to ARC position `target`. `full_travel_ms`
+  // is its learned time for a full move that way, 0 if unknown. The engine
+  // treats the blind as stopped once it is quiet for `motion_timeout_ms`.
+  virtual void on_cover_motion(size_t /*blind*/, int /*target*/, uint32_t /*full_travel_ms*/,
+                               uint32_t /*motion_timeout_ms*/) {}
+  virtual void on_cover_stop(size_t /*blind*/) {}
+  virtual void on_pairing_status(std::string_view /*status*/) {}
+  virtual void on_last_paired_id(std::string_view /*id*/) {}
+  virtual void on_motion_batch(const MotionBatchStatus & /*status*/) {}
+};
+
+// Persistence for learned travel times and blind state. Loads return false
+// when nothing is stored.
+class BridgeStorage {
+ public:
+  virtual ~BridgeStorage() = default;
+  virtual bool load_travel_model(size_t blind, BlindId id, TravelModel &model) = 0;
+  virtual void save_travel_model(size_t blind, const TravelModel &model) = 0;
+  virtual bool load_snapshot(size_t blind, BlindId id, BlindSnapshot &snapshot) = 0;
+  virtual void save_snapshot(size_t blind, const BlindSnapshot &snapshot) = 0;
+};
+
+// The bridge's scheduling, delivery tracking and frame handling, free of any
+// framework: time, the UART and state updates all go through the interfaces
+// above, so the whole RX -> parse -> dispatch -> TX path runs on a host.
+// Register every blind, then call start() once and run() from the main loop.
+class BridgeEngine {
+ public:
+  // The clock and transport are required; the sink and storage are optional.
+  void set_clock(BridgeClock *clock) { this->clock_ = clock; }
+  void set_transport(BridgeTransport *transport) { this->transport_ = transport; }
+  void set_event_sink(BridgeEventSink *sink) { this->sink_ = sink; }
+  void set_storage(BridgeStorage *storage) { this->storage_ = storage; }
+
+  void start();
+  void run();
+  // Writes travel times and state snapshots that are still waiting for their
+  // save interval.
+  void save_pending_state();
+
+  // registration
+  // Perfect-hash parameters cover.py computed for this bridge's blinds.
+  void set_blind_hash(uint32_t multiplier, uint8_t bits) {
+    this->blinds_.set_hash(multiplier, bits);
+  }
+  // Each returns the blind's registry index, or BlindRegistry::NOT_FOUND for
+  // an invalid id.
+  size_t add_cover(const std::string &id);
+  size_t map_sensor(const std::string &id, SensorKind kind);
+  size_t blind_count() const { return this->records_.size(); }
+  BlindId blind_id_at(size_t index) const { return this->blinds_.id_at(index); }
+  size_t tx_queue_capacity() const { return this->tx_scheduler_.queue().capacity(); }
+
+  // command API
+  void send_open(BlindId id);
+  void send_close(BlindId id);
+  void send_stop(BlindId id);
+  void send_move(BlindId id, uint8_t percent);
+  void send_query(BlindId id);
+  void send_query_all();
+  void send_pair_command();
+  void send_raw_command(const std::string &cmd);
+  void send_favorite(BlindId id);
+  void send_jog_open(BlindId id);
+  void send_jog_close(BlindId id);
+
+  // Group moves. Every target is queued in one pass, in the order given, with
+  // a single poll purge; repeated blinds are skipped. Returns the batch id the
+  // motion batch event reports once every member was acknowledged or given
+  // up on.
+  uint32_t send_move_batch(const std::vector<MotionBatchTarget> &targets);
+  uint32_t send_stop_batch(const std::vector<BlindId> &ids);
+  // False once the batch was reported, including a batch with no member
+  // that could be queued, which is reported before send_*_batch() returns.
+  bool is_motion_batch_pending(uint32_t batch_id) const {
+    return this->motion_batches_.contains(batch_id);
+  }
+
+  // Query additional motor telemetry via the UART bridge.
+  void send_voltage_query(BlindId id);
+  void send_version_query(BlindId id);
+  void send_speed_query(BlindId id);
+  void send_limits_query(BlindId id);
+
+  // String forms of the command API, for YAML lambdas.
+  void send_open(const std::string &id) { this->send_open(BlindId::from_text(id)); }
+  void send_close(const std::string &id) { this->send_close(BlindId::from_text(id)); }
+  void send_stop(const std::string &id) { this->send_stop(BlindId::from_text(id)); }
+  void send_move(const std::string &id, uint8_t percent) {
+    this->send_move(BlindId::from_text(id), percent);
+  }
+  void send_query(const std::string &id) { this->send_query(BlindId::from_text(id)); }
+  void send_favorite(const std::string &id) { this->send_favorite(BlindId::from_text(id)); }
+  void send_jog_open(const std::string &id) { this->send_jog_open(BlindId::from_text(id)); }
+  void send_jog_close(const std::string &id) { this->send_jog_close(BlindId::from_text(id)); }
+  void send_voltage_query(const std::string &id) {
+    this->send_voltage_query(BlindId::from_text(id));
+  }
+  void send_version_query(const std::string &id) {
+    this->send_version_query(BlindId::from_text(id));
+  }
+  void send_speed_query(const std::string &id) { this->send_speed_query(BlindId::from_text(id)); }
+  void send_limits_query(const std::string &id) {
+    this->send_limits_query(BlindId::from_text(id));
+  }
+
+  // Runtime tuning for polling, retries, and motion pacing.
+  void set_auto_poll_enabled(bool enabled) { this->auto_poll_enabled_ = enabled; }
+  void set_auto_poll_interval(uint32_t interval_ms) { this->query_interval_ms_ = interval_ms; }
+  void set_auto_poll_min_age(uint32_t min_age_ms) { this->poll_min_age_ms_ = min_age_ms; }
+  void set_motion_poll_interval(uint32_t interval_ms) {
+    this->motion_poll_interval_ms_ = interval_ms;
+  }
+  void set_motion_timeout(uint32_t timeout_ms) { this->motion_timeout_ms_ = timeout_ms; }
+  bool is_blind_moving(BlindId id) const {
+    const BlindRecord *record = this->find_blind_(id);
+    return record != nullptr && record->motion.moving;
+  }
+  // Learned travel times are saved at most once per interval; 0 saves each
+  // change right away.
+  void set_travel_save_interval(uint32_t interval_ms) {
+    this->travel_save_interval_ms_ = interval_ms;
+  }
+  // Snapshots of changed blind state are saved at most once per interval.
+  void set_state_save_interval(uint32_t interval_ms) {
+    this->state_save_interval_ms_ = interval_ms;
+  }
+  // Uptime after which version and limits restored at boot are queried again.
+  void set_static_refresh_interval(uint32_t interval_ms) {
+    this->static_refresh_interval_ms_ = interval_ms;
+  }
+  // False while the blind's cover and sensors show state restored at boot
+  // that the blind has not confirmed yet.
+  bool is_blind_state_verified(BlindId id) const {
+    const BlindRecord *record = this->find_blind_(id);
+    return record == nullptr || !record->restored;
+  }
+  bool is_blind_state_verified(const std::string &id) const {
+    return this->is_blind_state_verified(BlindId::from_text(id));
+  }
+  // Expected milliseconds for the blind to reach `target` from its last known
+  // position, or 0 while its travel time is not learned.
+  uint32_t get_travel_eta_ms(BlindId id, uint8_t target) const;
+  uint32_t get_travel_eta_ms(const std::string &id, uint8_t target) const {
+    return this->get_travel_eta_ms(BlindId::from_text(id), target);
+  }
+  // Per-blind auto-poll tuning; see PollState for the meaning of each field.
+  void set_blind_poll_policy(const std::string &id, float weight, uint32_t max_staleness_ms);
+  // Milliseconds since any frame from the blind, UINT32_MAX if never heard.
+  uint32_t get_blind_age_ms(BlindId id) const;
+  uint32_t get_blind_age_ms(const std::string &id) const {
+    return this->get_blind_age_ms(BlindId::from_text(id));
+  }
+  void set_command_retry_count(uint8_t retry_count) { this->command_retry_count_ = retry_count; }
+  void set_command_retry_timeout(uint32_t timeout_ms) { this->command_retry_timeout_ms_ = timeout_ms; }
+  void set_delivery_window(size_t window) { this->delivery_window_ = window == 0 ? 1 : window; }
+  void set_motion_tx_gap(uint32_t gap_ms) { this->motion_tx_gap_ms_ = gap_ms; }
+  void set_tx_queue_capacity(size_t capacity) {
+    this->tx_queue_capacity_ = capacity;
+    this->tx_scheduler_.set_capacity(capacity);
+  }
+  void set_tx_class_weight(TxPriorityClass priority_class, uint16_t weight) {
+    this->tx_scheduler_.set_class_weight(priority_class, weight);
+  }
+  void set_tx_aging_interval(uint32_t interval_ms) {
+    this->tx_scheduler_.set_aging_interval(interval_ms);
+  }
+  // Per sensor kind publish tuning; see PublishPolicy.
+  void set_publish_delta(SensorKind kind, float delta) {
+    this->publish_filter_.policy(kind).delta = delta;
+  }
+  void set_publish_min_interval(SensorKind kind, uint32_t interval_ms) {
+    this->publish_filter_.policy(kind).min_interval_ms = interval_ms;
+  }
+  void set_publish_heartbeat(SensorKind kind, uint32_t heartbeat_ms) {
+    this->publish_filter_.policy(kind).heartbeat_ms = heartbeat_ms;
+  }
+  // Sensor publishes emitted and suppressed per kind since boot.
+  const PublishStats &get_publish_stats(SensorKind kind) const {
+    return this->publish_filter_.stats(kind);
+  }
+  // Queue wait times per scheduling class since boot.
+  const TxClassStats &get_tx_class_stats(TxPriorityClass priority_class) const {
+    return this->tx_scheduler_.stats(priority_class);
+  }
+
+  // The guard clears once the hub answers a readiness probe, but never before
+  // `settle_ms` and at the latest after `max_ms`.
+  void set_startup_guard_max(uint32_t max_ms) { this->startup_guard_.set_max_ms(max_ms); }
+  void set_startup_settle(uint32_t settle_ms) { this->startup_guard_.set_settle_ms(settle_ms); }
+  bool is_startup_guard_cleared() const { return this->startup_guard_.cleared(); }
+  // Milliseconds the startup guard held, 0 while it still holds.
+  uint32_t get_startup_guard_ms() const { return this->startup_guard_.duration_ms(); }
+  // Query every blind back to back once the startup guard clears.
+  void set_startup_sweep_enabled(bool enabled) { this->startup_sweep_enabled_ = enabled; }
+  bool is_startup_sweep_active() const { return this->startup_sweep_.active(); }
+  // Milliseconds from boot until every cover had reported a position, 0 until then.
+  uint32_t get_time_to_full_state_ms() const { return this->full_state_ms_; }
+
+  // RAM ring of every UART frame and API motion command; 0 bytes disables it.
+  void set_uart_trace_size(size_t bytes) { this->uart_trace_.set_capacity(bytes); }
+  const UartTrace &get_uart_trace() const { return this->uart_trace_; }
+  void clear_uart_trace() { this->uart_trace_.clear(); }
+  // Logs the trace as a binary capture in hex lines, for tests/run_trace_replay.py.
+  void dump_uart_trace();
+
+  // Queue, acknowledgement and end-to-end times of tracked commands per
+  // pacing class since boot.
+  const CommandLatency &get_command_latency(TxPacingClass pacing_class) const {
+    return this->command_latency_[static_cast<size_t>(pacing_class)];
+  }
+  // Also keep the times per blind; call before start().
+  void set_blind_latency_enabled(bool enabled) { this->blind_latency_enabled_ = enabled; }
+  // The blind's times, or nullptr when per-blind times are off or the blind
+  // is not registered.
+  const CommandLatency *get_blind_command_latency(BlindId id) const;
+  const CommandLatency *get_blind_command_latency(const std::string &id) const {
+    return this->get_blind_command_latency(BlindId::from_text(id));
+  }
+  void reset_command_latency();
+  // Logs percentiles and bucket counts for every pacing class and blind.
+  void dump_command_latency();
+
+#ifdef USE_ARC_BRIDGE_PROFILER
+  // Cycles spent per loop section since boot or the last reset.
+  const LoopProfiler &get_loop_profiler() const { return this->loop_profiler_; }
+  // A loop pass longer than this is logged with its per-section breakdown;
+  // 0 disables the warning.
+  void set_loop_stall_threshold(uint32_t threshold_us) {
+    this->loop_profiler_.set_stall_threshold_us(threshold_us);
+  }
+  void reset_loop_profile() { this->loop_profiler_.reset(); }
+  void dump_loop_profile();
+#endif
+
+  void send_simple(const std::string &id, char cmd, const std::string &arg = "") {
+    // Commands sent from lambdas are scheduled like motion commands.
+    this->send_simple_(BlindId::from_text(id), cmd, arg);
+  }
+
+ protected:
+  uint32_t now_() const { return this->clock_->now_ms(); }
+  void handle_frame(std::string_view frame);
+  void parse_frame(std::string_view frame);
+  // Returns the tracking id of a queued tracked command, otherwise 0.
+  uint32_t send_simple_(BlindId id, char command, std::string_view payload = {},
+                        TxPriorityClass priority_class = TxPriorityClass::MOTION,
+                        TxPacingClass pacing_class = TxPacingClass::STANDARD,
+                        bool is_poll = false,
+                        DeliveryExpectation delivery_expectation = DeliveryExpectation::NONE,
+                        bool allow_retry = false,
+                        std::string_view expected_ack_token = {},
+                        std::string_view expected_ack_prefix = {});
+  // Queues a tracked open ('o'), close ('c'), stop ('s') or move ('m' to
+  // `percent`) and marks the blind as moving. Does not purge polls.
+  uint32_t queue_motion_(BlindId id, char command, uint8_t percent = 0);
+  void seal_motion_batch_(uint32_t batch_id);
+  void report_motion_batch_(const MotionBatchStatus &status);
+  struct BlindRecord;
+  // Registers `id` and returns its record, or nullptr for an invalid id.
+  BlindRecord *register_blind_(BlindId id);
+  BlindRecord *register_blind_(const std::string &id);
+  // The record for a registered blind, or nullptr.
+  BlindRecord *find_blind_(BlindId id);
+  const BlindRecord *find_blind_(BlindId id) const;
+  size_t index_of_(const BlindRecord &record) const {
+    return static_cast<size_t>(&record - this->records_.data());
+  }
+  // Index of the covered blind most in need of a poll, or NOT_FOUND when
+  // every blind was heard within `min_age_ms`.
+  size_t most_stale_blind_(uint32_t now, uint32_t min_age_ms) const;
+  void start_motion_(BlindId id);
+  // Polls moving blinds and expires stale motion; returns true while any
+  // blind is moving.
+  bool process_motion_(uint32_t now);
+  // Starts timing an acknowledged move and schedules its arrival poll.
+  void start_travel_(BlindRecord &record, BlindId id, int target, uint32_t now);
+  void finish_travel_(BlindRecord &record, BlindId id, int position, uint32_t now);
+  uint32_t motion_timeout_for_(const BlindRecord &record) const;
+  void load_travel_models_();
+  void save_travel_models_(uint32_t now);
+  // Publishes each blind's saved snapshot to its cover and sensors.
+  void restore_state_snapshots_();
+  void save_state_snapshots_(uint32_t now);
+  // Whether version and limits are due for a query even though they have a state.
+  bool static_refresh_due_(const BlindRecord &record, uint32_t now) const;
+  void enqueue_queries_for_id_(BlindId id, bool force_static, TxPriorityClass query_class);
+  // Queue the blind's voltage and speed, or version and limits, queries; return
+  // how many were queued.
+  size_t queue_telemetry_queries_(BlindId id, const BlindRecord &record,
+                                  TxPriorityClass query_class);
+  size_t queue_static_queries_(BlindId id, const BlindRecord &record, bool force_static,
+                               TxPriorityClass query_class);
+  void process_startup_sweep_(uint32_t now);
+  size_t sweep_step_(size_t index, SweepPhase phase, uint32_t now);
+  void abort_startup_sweep_(const char *reason);
+  void note_position_heard_(BlindRecord &record, uint32_t now);
+  // Writes an r? straight to the UART, bypassing the held TX queue.
+  void send_startup_probe_(uint32_t now);
+  void on_startup_guard_cleared_(uint32_t now);
+  void receive_frames_(uint32_t now);
+  size_t receive_chunk_(char *chunk, size_t size);
+  // Feeds one received byte to the frame extractor; returns the length of
+  // the frame it completed, or 0.
+  size_t extract_frame_(char c, char *frame, size_t size, uint32_t now);
+  void process_tx_watchdog_(uint32_t now, bool any_blind_moving);
+  // Writes a frame to the hub and records it in the UART trace.
+  void transmit_(std::string_view frame, uint32_t now);
+  void trace_command_(BlindId id, char command, std::string_view payload);
+  // Helper to decode and publish pVc feedback.
+  void handle_pvc_value_(BlindRecord *record, const char *id, int32_t raw_value);
+  // Publish through the publish filter; no-ops for unmapped sensors.
+  void publish_sensor_(BlindRecord *record, SensorKind kind, float value);
+  void publish_text_sensor_(BlindRecord *record, SensorKind kind, std::string_view value);
+  uint32_t allocate_tracking_id_();
+  void arm_pending_delivery_(BlindRecord &record, const TxQueueItem &item, uint32_t now);
+  void acknowledge_pending_delivery_(BlindRecord &record, const ParsedFrame &parsed);
+  void finish_pending_delivery_(BlindRecord &record, bool acknowledged);
+  void process_pending_deliveries_();
+  // Applies `update` to the stats of the delivery's pacing class and blind.
+  template<typename Update> void update_latency_(const BlindRecord &record, Update update) {
+    update(this->command_latency_[static_cast<size_t>(record.delivery.item.pacing_class)]);
+    const size_t index = this->index_of_(record);
+    if (index < this->blind_latency_.size()) {
+      update(this->blind_latency_[index]);
+    }
+  }
+  bool tx_item_fits_delivery_window_(const TxQueueItem &item) const;
+  // Empties the TX queue, failing batched commands that were still queued.
+  void clear_tx_queue_();
+  void send_verification_query_(BlindId id);
+  void publish_pairing_status_(const std::string &status);
+  void publish_last_paired_id_(const std::string &id);
+  void handle_pairing_outcome_(const PairingOutcome &outcome);
+  void process_pairing_timeout_();
+
+  // ===============================
+  // CONSTANTS (Option A ordering)
+  // ===============================
+  static const uint32_t QUERY_INTERVAL_MS = 10000;      // 10 seconds
+  static const uint32_t TX_WATCHDOG_MS    = 5000;       // 5 seconds
+  static const uint32_t PAIRING_TIMEOUT_MS = 30000;     // 30 seconds
+  static const uint8_t COMMAND_RETRY_COUNT = 1;         // one resend after verification
+  static const uint32_t COMMAND_RETRY_TIMEOUT_MS = 1500;  // wait before verify/retry
+
+  // ===============================
+  // INTERNAL STATE
+  // ===============================
+  BridgeClock *clock_{nullptr};
+  BridgeTransport *transport_{nullptr};
+  BridgeEventSink *sink_{nullptr};
+  BridgeStorage *storage_{nullptr};
+
+  FrameExtractor rx_frames_;
+  uint32_t boot_millis_{0};
+  uint32_t last_query_millis_{0};
+  uint32_t last_rx_millis_{0};
+  StartupGuard startup_guard_;
+  UartTrace uart_trace_;
+#ifdef USE_ARC_BRIDGE_PROFILER
+  LoopProfiler loop_profiler_;
+  void log_loop_stall_();
+#endif
+  size_t startup_probe_cursor_{0};
+  bool auto_poll_enabled_{true};
+  uint32_t query_interval_ms_{QUERY_INTERVAL_MS};
+  uint32_t poll_min_age_ms_{DEFAULT_POLL_MIN_AGE_MS};
+  uint32_t motion_poll_interval_ms_{DEFAULT_MOTION_POLL_INTERVAL_MS};
+  uint32_t motion_timeout_ms_{DEFAULT_MOTION_TIMEOUT_MS};
+  uint8_t command_retry_count_{COMMAND_RETRY_COUNT};
+  uint32_t command_retry_timeout_ms_{COMMAND_RETRY_TIMEOUT_MS};
+  size_t delivery_window_{DEFAULT_DELIVERY_WINDOW};
+  uint32_t motion_tx_gap_ms_{DEFAULT_MOTION_TX_GAP_MS};
+
+  // Blinds with a cover.
+  size_t cover_count_{0};
+  PairingSession pairing_session_;
+  // Track motion-command delivery per blind so retries stay scoped.
+  struct PendingCommandDelivery {
+    TxQueueItem item;
+    uint8_t retries_used{0};
+    uint32_t last_activity_ms{0};
+    bool verification_sent{false};
+    // When the first attempt was queued and the latest one written.
+    uint32_t first_enqueued_ms{0};
+    uint32_t sent_ms{0};
+  };
+  // Everything the bridge keeps for one blind, so a received frame costs a
+  // single registry lookup.
+  struct BlindRecord {
+    bool has_cover{false};
+    // Bit per SensorKind mapped to a sensor.
+    uint8_t mapped_sensors{0};
+    // Only meaningful while delivery_pending is set.
+    PendingCommandDelivery delivery;
+    bool delivery_pending{false};
+    PollState poll;
+    MotionState motion;
+    // Last reported position, -1 until one arrives.
+    int8_t position{-1};
+    TravelModel travel;
+    TravelMeasurement travel_measurement;
+    // The model changed since it was last saved.
+    bool travel_dirty{false};
+    BlindSnapshot snapshot;
+    bool snapshot_dirty{false};
+    // Showing restored state the blind has not confirmed yet.
+    bool restored{false};
+    // Restored version and limits should be queried at the next poll.
+    bool static_stale{false};
+    // When version or limits were last received or restored.
+    uint32_t static_fetched_ms{0};
+    // A position was reported since boot.
+    bool position_heard{false};
+    // Indexed by SensorKind.
+    std::array<PublishSlot, SENSOR_KIND_COUNT> published{};
+    uint32_t last_tx_ms{0};
+
+    bool maps(SensorKind kind) const {
+      return (this->mapped_sensors & (1u << static_cast<uint8_t>(kind))) != 0;
+    }
+    // A mapped sensor that has been published at least once.
+    bool has_state(SensorKind kind) const {
+      return this->published[static_cast<size_t>(kind)].published;
+    }
+  };
+  // Indexed by the blind's BlindRegistry index.
+  BlindRegistry blinds_;
+  std::vector<BlindRecord> records_;
+  // Records with delivery_pending set, i.e. deliveries in flight.
+  size_t pending_delivery_count_{0};
+  uint32_t next_tracking_id_{1};
+  MotionBatchTracker motion_batches_;
+  // Scratch for clear_tx_queue_(), reserved to the queue capacity at start().
+  std::vector<uint32_t> cleared_tracking_ids_;
+  std::array<CommandLatency, TX_PACING_CLASS_COUNT> command_latency_{};
+  bool blind_latency_enabled_{false};
+  // Indexed like records_; empty unless per-blind times are enabled.
+  std::vector<CommandLatency> blind_latency_;
+  PublishFilter publish_filter_;
+  uint32_t travel_save_interval_ms_{DEFAULT_TRAVEL_SAVE_INTERVAL_MS};
+  uint32_t last_travel_save_ms_{0};
+  bool travel_dirty_{false};
+  uint32_t state_save_interval_ms_{DEFAULT_STATE_SAVE_INTERVAL_MS};
+  uint32_t static_refresh_interval_ms_{DEFAULT_STATIC_REFRESH_INTERVAL_MS};
+  uint32_t last_state_save_ms_{0};
+  bool state_dirty_{false};
+  bool startup_sweep_enabled_{true};
+  StartupSweep startup_sweep_;
+  uint32_t startup_sweep_queries_{0};
+  size_t covers_heard_{0};
+  uint32_t full_state_ms_{0};
+
+  // ===============================
+  // TX QUEUE SUPPORT
+  // ===============================
+  TxScheduler tx_scheduler_;
+  // 0 sizes the queue from the registered blinds at start().
+  size_t tx_queue_capacity_{0};
+  uint32_t last_tx_millis_{0};
+  void queue_tx(std::string_view frame,
+                TxPriorityClass priority_class,
+                TxPacingClass pacing_class = TxPacingClass::STANDARD,
+                bool is_poll = false,
+                BlindId blind_id = {},
+                DeliveryExpectation delivery_expectation = DeliveryExpectation::NONE,
+                bool allow_retry = false,
+                uint32_t tracking_id = 0,
+                std::string_view expected_ack_token = {},
+                std::string_view expected_ack_prefix = {});
+  bool enqueue_tx_(const TxQueueItem &item, TxPriorityClass priority_class);
+  void drop_pending_polls_();
+  void process_tx_queue_();
+};
+
+}  // namespace arc_bridge
+}  // namespace esphome
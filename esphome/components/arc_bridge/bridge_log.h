@@ -0,0 +1,29 @@
+#pragma once
+
+// The engine logs through ESPHome's macros on the device. Host builds define
+// ARC_BRIDGE_HOST and get stubs that format nothing, so host profiles measure
+// the engine rather than the logger.
+#ifdef ARC_BRIDGE_HOST
+
+#include <cinttypes>
+
+namespace esphome {
+namespace arc_bridge {
+
+inline void host_log_discard(const char * /*tag*/, const char * /*format*/, ...) {}
+
+}  // namespace arc_bridge
+}  // namespace esphome
+
+#define ESP_LOGE(tag, ...) ::esphome::arc_bridge::host_log_discard(tag, __VA_ARGS__)
+#define ESP_LOGW(tag, ...) ::esphome::arc_bridge::host_log_discard(tag, __VA_ARGS__)
+#define ESP_LOGI(tag, ...) ::esphome::arc_bridge::host_log_discard(tag, __VA_ARGS__)
+#define ESP_LOGD(tag, ...) ::esphome::arc_bridge::host_log_discard(tag, __VA_ARGS__)
+#define ESP_LOGV(tag, ...) ::esphome::arc_bridge::host_log_discard(tag, __VA_ARGS__)
+#define ESP_LOGVV(tag, ...) ::esphome::arc_bridge::host_log_discard(tag, __VA_ARGS__)
+
+#else
+
+#include "esphome/core/log.h"
+
+#endif
@@ -1,7 +1,8 @@
 import esphome.codegen as cg
 import esphome.config_validation as cv
 from esphome.components import cover, sensor, text_sensor
-from esphome.const import CONF_BATTERY_LEVEL, CONF_ID, CONF_POWER, CONF_VOLTAGE
+from esphome.const import CONF_BATTERY_LEVEL, CONF_ID, CONF_PLATFORM, CONF_POWER, CONF_VOLTAGE
+from esphome.core import CORE
 
 DEPENDENCIES = ["uart"]
 AUTO_LOAD = ["cover", "sensor", "text_sensor"]
@@ -14,34 +15,105 @@ CONF_VERSION = "version"
 CONF_SPEED = "speed"
 CONF_LIMITS = "limits"
 CONF_INVERT_POSITION = "invert_position"
+CONF_POLL_WEIGHT = "poll_weight"
+CONF_MAX_STALENESS = "max_staleness"
+CONF_INTERPOLATION_INTERVAL = "interpolation_interval"
+
+# Must match BLIND_HASH_SEED / BLIND_HASH_STEP in blind_registry.h.
+BLIND_HASH_SEED = 0x9E3779B1
+BLIND_HASH_STEP = 0x7F4A7C16
+BLIND_HASH_ATTEMPTS = 1024
+MAX_BLIND_HASH_BITS = 16
 
 arc_bridge_ns = cg.esphome_ns.namespace("arc_bridge")
 ARCBridgeComponent = arc_bridge_ns.class_("ARCBridgeComponent", cg.Component)
-ARCCover = arc_bridge_ns.class_("ARCCover", cover.Cover)
-
-CONFIG_SCHEMA = cover.cover_schema(ARCCover).extend(
-    {
-        cv.GenerateID(): cv.declare_id(ARCCover),
-        cv.Required(CONF_BRIDGE_ID): cv.use_id(ARCBridgeComponent),
-        cv.Required(CONF_BLIND_ID): cv.string,
-        cv.Optional(CONF_LINK_QUALITY): cv.use_id(sensor.Sensor),
-        cv.Optional(CONF_STATUS): cv.use_id(text_sensor.TextSensor),
-        cv.Optional(CONF_VERSION): cv.use_id(text_sensor.TextSensor),
-        cv.Optional(CONF_SPEED): cv.use_id(sensor.Sensor),
-        cv.Optional(CONF_LIMITS): cv.use_id(text_sensor.TextSensor),
-        cv.Optional(CONF_BATTERY_LEVEL): cv.use_id(sensor.Sensor),
-        cv.Exclusive(CONF_POWER, "voltage_sensor"): cv.use_id(sensor.Sensor),
-        cv.Exclusive(CONF_VOLTAGE, "voltage_sensor"): cv.use_id(sensor.Sensor),
-        cv.Optional(CONF_INVERT_POSITION, default=False): cv.boolean,
-    }
+ARCCover = arc_bridge_ns.class_("ARCCover", cover.Cover, cg.Component)
+
+
+def validate_blind_id(value):
+    value = cv.string_strict(value)
+    if len(value) != 3 or not value.isascii() or "\0" in value:
+        raise cv.Invalid("blind_id must be exactly 3 ASCII characters")
+    return value
+
+
+def pack_blind_id(blind_id):
+    return ord(blind_id[0]) | ord(blind_id[1]) << 8 | ord(blind_id[2]) << 16
+
+
+def blind_hash_for(blind_ids):
+    """Find (multiplier, bits) giving every id its own slot, as BlindRegistry does."""
+    keys = sorted({pack_blind_id(blind_id) for blind_id in blind_ids})
+    bits = 0
+    while (1 << bits) < len(keys) * 2:
+        bits += 1
+    while bits <= MAX_BLIND_HASH_BITS:
+        for attempt in range(BLIND_HASH_ATTEMPTS):
+            multiplier = (BLIND_HASH_SEED + attempt * BLIND_HASH_STEP) & 0xFFFFFFFF
+            slots = {
+                ((key * multiplier) & 0xFFFFFFFF) >> (32 - bits) if bits else 0 for key in keys
+            }
+            if len(slots) == len(keys):
+                return multiplier, bits
+        bits += 1
+    raise cv.Invalid("Unable to build a blind id hash table")
+
+
+def bridge_blind_ids(bridge_id):
+    return [
+        conf[CONF_BLIND_ID]
+        for conf in CORE.config.get("cover", [])
+        if conf.get(CONF_PLATFORM) == "arc_bridge" and conf[CONF_BRIDGE_ID].id == bridge_id.id
+    ]
+
+
+def add_blind_hash(bridge, bridge_id):
+    # The hash parameters are computed once per bridge, before its first cover
+    # registers, so every configured blind lands in a free slot without a search
+    # at boot.
+    emitted = CORE.data.setdefault("arc_bridge_blind_hash", set())
+    if bridge_id.id in emitted:
+        return
+    emitted.add(bridge_id.id)
+    multiplier, bits = blind_hash_for(bridge_blind_ids(bridge_id))
+    cg.add(bridge.set_blind_hash(multiplier, bits))
+
+
+CONFIG_SCHEMA = (
+    cover.cover_schema(ARCCover)
+    .extend(
+        {
+            cv.GenerateID(): cv.declare_id(ARCCover),
+            cv.Required(CONF_BRIDGE_ID): cv.use_id(ARCBridgeComponent),
+            cv.Required(CONF_BLIND_ID): validate_blind_id,
+            cv.Optional(CONF_LINK_QUALITY): cv.use_id(sensor.Sensor),
+            cv.Optional(CONF_STATUS): cv.use_id(text_sensor.TextSensor),
+            cv.Optional(CONF_VERSION): cv.use_id(text_sensor.TextSensor),
+            cv.Optional(CONF_SPEED): cv.use_id(sensor.Sensor),
+            cv.Optional(CONF_LIMITS): cv.use_id(text_sensor.TextSensor),
+            cv.Optional(CONF_BATTERY_LEVEL): cv.use_id(sensor.Sensor),
+            cv.Exclusive(CONF_POWER, "voltage_sensor"): cv.use_id(sensor.Sensor),
+            cv.Exclusive(CONF_VOLTAGE, "voltage_sensor"): cv.use_id(sensor.Sensor),
+            cv.Optional(CONF_INVERT_POSITION, default=False): cv.boolean,
+            cv.Optional(CONF_POLL_WEIGHT, default=1.0): cv.float_range(min=0.0, max=100.0),
+            cv.Optional(CONF_MAX_STALENESS): cv.positive_time_period_milliseconds,
+            cv.Optional(
+                CONF_INTERPOLATION_INTERVAL, default="1s"
+            ): cv.positive_time_period_milliseconds,
+        }
+    )
+    .extend(cv.COMPONENT_SCHEMA)
 )
 
 
 async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
     await cover.register_cover(var, config)
+    # ARCCover::loop() interpolates moves and ends them when the blind goes quiet.
+    await cg.register_component(var, config)
 
     bridge = await cg.get_variable(config[CONF_BRIDGE_ID])
+    add_blind_hash(bridge, config[CONF_BRIDGE_ID])
     cg.add(var.set_bridge(bridge))
     cg.add(var.set_blind_id(config[CONF_BLIND_ID]))
     cg.add(bridge.register_cover(config[CONF_BLIND_ID], var))
@@ -49,6 +121,19 @@ async def to_code(config):
     if CONF_INVERT_POSITION in config:
         cg.add(var.set_invert_position(config[CONF_INVERT_POSITION]))
 
+    interpolation_interval = config[CONF_INTERPOLATION_INTERVAL]
+    cg.add(var.set_interpolation_interval(interpolation_interval.total_milliseconds))
+
+    if config[CONF_POLL_WEIGHT] != 1.0 or CONF_MAX_STALENESS in config:
+        max_staleness = config.get(CONF_MAX_STALENESS)
+        cg.add(
+            bridge.set_blind_poll_policy(
+                config[CONF_BLIND_ID],
+                config[CONF_POLL_WEIGHT],
+                max_staleness.total_milliseconds if max_staleness is not None else 0,
+            )
+        )
+
     if CONF_LINK_QUALITY in config:
         lq = await cg.get_variable(config[CONF_LINK_QUALITY])
         cg.add(bridge.map_lq_sensor(config[CONF_BLIND_ID], lq))
@@ -0,0 +1,99 @@
+#include "cover_motion.h"
+
+namespace esphome {
+namespace arc_bridge {
+
+void PositionInterpolator::start(float from, float target, uint32_t now,
+                                 uint32_t full_travel_ms) {
+  this->active_ = true;
+  this->target_ = target;
+  this->anchor_position_ = from;
+  this->anchor_ms_ = now;
+  this->reported_ = false;
+  this->rate_ = 0.0f;
+  this->direction_ = from < 0.0f ? direction_between_(50.0f, target)
+                                 : direction_between_(from, target);
+  if (from >= 0.0f && this->direction_ == TravelDirection::NONE) {
+    this->active_ = false;
+  }
+  if (from >= 0.0f && full_travel_ms > 0) {
+    const float rate = 100.0f / static_cast<float>(full_travel_ms);
+    this->rate_ = this->direction_ == TravelDirection::CLOSING ? rate : -rate;
+  }
+}
+
+void PositionInterpolator::report(float position, uint32_t now) {
+  if (!this->active_) {
+    if (this->anchor_position_ < 0.0f || position == this->anchor_position_) {
+      // Nothing to tell the direction from yet.
+      this->anchor_position_ = position;
+      this->anchor_ms_ = now;
+      return;
+    }
+    this->start(this->anchor_position_, position > this->anchor_position_ ? 100.0f : 0.0f,
+                this->anchor_ms_);
+  }
+
+  if (this->reported_ && now != this->anchor_ms_) {
+    const float rate =
+        (position - this->anchor_position_) / static_cast<float>(now - this->anchor_ms_);
+    // A report against the direction of travel leaves the estimate still.
+    const bool towards_target =
+        this->direction_ == TravelDirection::CLOSING ? rate > 0.0f : rate < 0.0f;
+    this->rate_ = towards_target ? rate : 0.0f;
+  }
+  this->anchor_position_ = position;
+  this->anchor_ms_ = now;
+  this->reported_ = true;
+}
+
+void PositionInterpolator::arrive(float position, uint32_t now) {
+  this->active_ = false;
+  this->anchor_position_ = position;
+  this->anchor_ms_ = now;
+}
+
+float PositionInterpolator::estimate(uint32_t now) const {
+  if (!this->active_ || this->rate_ == 0.0f) {
+    return this->anchor_position_;
+  }
+  const float position =
+      this->anchor_position_ + this->rate_ * static_cast<float>(now - this->anchor_ms_);
+  if (this->direction_ == TravelDirection::CLOSING) {
+    return position > this->target_ ? this->target_ : position;
+  }
+  return position < this->target_ ? this->target_ : position;
+}
+
+TravelDirection PositionInterpolator::direction_between_(float from, float to) {
+  if (to > from) {
+    return TravelDirection::CLOSING;
+  }
+  if (to < from) {
+    return TravelDirection::OPENING;
+  }
+  return TravelDirection::NONE;
+}
+
+int motion_target_for_token(std::string_view token) {
+  if (token == "o") {
+    return 0;
+  }
+  if (token == "c") {
+    return 100;
+  }
+  if (token.size() == 4 && token[0] == 'm') {
+    int target = 0;
+    for (size_t i = 1; i < token.size(); i++) {
+      if (token[i] < '0' || token[i] > '9') {
+        return -1;
+      }
+      target = target * 10 + (token[i] - '0');
+    }
+    return target <= 100 ? target : -1;
+  }
+  return -1;
+}
+
+}  // namespace arc_bridge
+}  // namespace esphome
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace esphome {
+namespace arc_bridge {
+
+// Default spacing of interpolated cover publishes while a blind moves.
+static constexpr uint32_t DEFAULT_INTERPOLATION_INTERVAL_MS = 1000;
+
+enum class TravelDirection : uint8_t {
+  NONE = 0,
+  // Towards 0 (fully open).
+  OPENING = 1,
+  // Towards 100 (fully closed).
+  CLOSING = 2,
+};
+
+// Estimates a moving blind's position between reports. Positions are ARC
+// percentages (0 open, 100 closed); the travel rate is measured from
+// consecutive in-motion reports, so without a learned travel time no estimate
+// moves before two arrive.
+class PositionInterpolator {
+ public:
+  // Motion towards `target` began at `now` from `from` (negative if unknown).
+  // A learned `full_travel_ms` moves the estimate from the start.
+  void start(float from, float target, uint32_t now, uint32_t full_travel_ms = 0);
+  // An in-motion report. Starts tracking towards the end stop in the
+  // direction of travel when no command did, e.g. for a remote-control move.
+  void report(float position, uint32_t now);
+  // A final position report.
+  void arrive(float position, uint32_t now);
+  void stop() { this->active_ = false; }
+
+  bool active() const { return this->active_; }
+  TravelDirection direction() const { return this->direction_; }
+  float target() const { return this->target_; }
+  // Milliseconds since the last start or report.
+  uint32_t idle_ms(uint32_t now) const { return now - this->anchor_ms_; }
+  // Position estimate at `now`, never past the target. Negative while the
+  // start position is still unknown.
+  float estimate(uint32_t now) const;
+
+ protected:
+  static TravelDirection direction_between_(float from, float to);
+
+  bool active_{false};
+  TravelDirection direction_{TravelDirection::NONE};
+  float target_{0.0f};
+  // Last known position and when it was known.
+  float anchor_position_{-1.0f};
+  uint32_t anchor_ms_{0};
+  bool reported_{false};
+  // Percent per millisecond; 0 until measured.
+  float rate_{0.0f};
+};
+
+// The target position a tracked motion command's ack token names: 0 for
+// "o", 100 for "c" and NNN for "mNNN". Negative for anything else.
+int motion_target_for_token(std::string_view token);
+
+}  // namespace arc_bridge
+}  // namespace esphome
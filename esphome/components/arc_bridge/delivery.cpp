@@ -5,30 +5,30 @@ namespace arc_bridge {
 
 namespace {
 
-bool matches_prefix_(const std::string &value, const std::string &prefix) {
-  return !prefix.empty() && value.rfind(prefix, 0) == 0;
+bool matches_prefix_(std::string_view value, std::string_view prefix) {
+  return !prefix.empty() && value.substr(0, prefix.size()) == prefix;
 }
 
 }  // namespace
 
-bool frame_confirms_delivery(const ParsedFrame &parsed, const std::string &blind_id,
+bool frame_confirms_delivery(const ParsedFrame &parsed, BlindId blind_id,
                              DeliveryExpectation expectation,
-                             const std::string &expected_ack_token,
-                             const std::string &expected_ack_prefix) {
-  if (parsed.id != blind_id) {
+                             std::string_view expected_ack_token,
+                             std::string_view expected_ack_prefix) {
+  if (!blind_id.valid() || parsed.blind_id != blind_id) {
     return false;
   }
 
   switch (expectation) {
     case DeliveryExpectation::BLIND_REPLY:
-      if (!expected_ack_token.empty() && parsed.reply_token == expected_ack_token) {
+      if (!expected_ack_token.empty() && parsed.reply_token_view() == expected_ack_token) {
         return true;
       }
-      if (matches_prefix_(parsed.reply_token, expected_ack_prefix)) {
+      if (matches_prefix_(parsed.reply_token_view(), expected_ack_prefix)) {
         return true;
       }
       return parsed.lost_link || parsed.not_paired || parsed.no_position ||
-             static_cast<bool>(parsed.position_percent);
+             parsed.has(ParsedFrame::POSITION);
     case DeliveryExpectation::NONE:
     default:
       return false;
@@ -3,6 +3,7 @@
 #include "protocol.h"
 
 #include <cstdint>
+#include <string_view>
 
 namespace esphome {
 namespace arc_bridge {
@@ -28,10 +29,10 @@ struct PendingDeliveryPolicy {
   bool allow_retry{false};
 };
 
-bool frame_confirms_delivery(const ParsedFrame &parsed, const std::string &blind_id,
+bool frame_confirms_delivery(const ParsedFrame &parsed, BlindId blind_id,
                              DeliveryExpectation expectation,
-                             const std::string &expected_ack_token = "",
-                             const std::string &expected_ack_prefix = "");
+                             std::string_view expected_ack_token = {},
+                             std::string_view expected_ack_prefix = {});
 DeliveryTimeoutAction next_delivery_timeout_action(const PendingDeliveryPolicy &policy, uint32_t now_ms);
 
 }  // namespace arc_bridge
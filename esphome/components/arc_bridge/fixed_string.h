@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace esphome {
+namespace arc_bridge {
+
+// NUL-terminated string stored inline with a fixed capacity. Text longer than
+// the capacity is truncated; callers that must not truncate check fits() first.
+template<size_t N> class FixedString {
+  static_assert(N < 256, "FixedString length is stored in a uint8_t");
+
+ public:
+  static constexpr size_t CAPACITY = N;
+
+  constexpr FixedString() = default;
+  constexpr FixedString(const char *text) : FixedString(std::string_view(text)) {}
+  constexpr FixedString(std::string_view text) { this->assign(text); }
+
+  constexpr void assign(std::string_view text) {
+    const size_t length = text.size() < N ? text.size() : N;
+    for (size_t i = 0; i < length; i++) {
+      this->data_[i] = text[i];
+    }
+    this->data_[length] = '\0';
+    this->size_ = static_cast<uint8_t>(length);
+  }
+
+  bool append(char c) {
+    if (this->size_ >= N) {
+      return false;
+    }
+    this->data_[this->size_++] = c;
+    this->data_[this->size_] = '\0';
+    return true;
+  }
+
+  bool append(std::string_view text) {
+    for (const char c : text) {
+      if (!this->append(c)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void clear() {
+    this->data_[0] = '\0';
+    this->size_ = 0;
+  }
+
+  static constexpr bool fits(std::string_view text) { return text.size() <= N; }
+
+  const char *c_str() const { return this->data_; }
+  std::string_view view() const { return {this->data_, this->size_}; }
+  size_t size() const { return this->size_; }
+  bool empty() const { return this->size_ == 0; }
+
+  friend bool operator==(const FixedString &lhs, std::string_view rhs) { return lhs.view() == rhs; }
+  friend bool operator!=(const FixedString &lhs, std::string_view rhs) { return lhs.view() != rhs; }
+
+ protected:
+  char data_[N + 1]{};
+  uint8_t size_{0};
+};
+
+}  // namespace arc_bridge
+}  // namespace esphome
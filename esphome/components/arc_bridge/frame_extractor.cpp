@@ -0,0 +1,91 @@
+#include "frame_extractor.h"
+
+namespace esphome {
+namespace arc_bridge {
+
+bool FrameExtractor::push(char c) {
+  bool stored_cleanly = true;
+  if (this->size_ == CAPACITY) {
+    this->overflow_count_++;
+    this->resync_();
+    stored_cleanly = false;
+  }
+
+  this->buffer_[(this->head_ + this->size_) % CAPACITY] = c;
+  this->size_++;
+  return stored_cleanly;
+}
+
+size_t FrameExtractor::next_frame(char *out, size_t out_size) {
+  while (this->scanned_ < this->size_) {
+    const char c = this->at_(this->scanned_);
+
+    if (this->scanned_ == 0) {
+      // Skip line noise until a frame start is at the head of the buffer.
+      if (c != '!') {
+        this->discard_(1);
+        continue;
+      }
+      this->scanned_ = 1;
+      continue;
+    }
+
+    if (c == '!') {
+      // A new frame started before the current one terminated.
+      this->discard_(this->scanned_);
+      this->resync_count_++;
+      continue;
+    }
+
+    if (c != ';') {
+      this->scanned_++;
+      continue;
+    }
+
+    const size_t length = this->scanned_ + 1;
+    if (length > out_size) {
+      this->overflow_count_++;
+      this->discard_(length);
+      continue;
+    }
+
+    for (size_t i = 0; i < length; i++) {
+      out[i] = this->at_(i);
+    }
+    this->discard_(length);
+    return length;
+  }
+
+  return 0;
+}
+
+void FrameExtractor::clear() {
+  this->head_ = 0;
+  this->size_ = 0;
+  this->scanned_ = 0;
+}
+
+void FrameExtractor::discard_(size_t count) {
+  if (count >= this->size_) {
+    this->clear();
+    return;
+  }
+  this->head_ = (this->head_ + count) % CAPACITY;
+  this->size_ -= count;
+  this->scanned_ = 0;
+}
+
+void FrameExtractor::resync_() {
+  // Drop the oldest partial frame but keep anything from the next `!` onward.
+  for (size_t i = 1; i < this->size_; i++) {
+    if (this->at_(i) == '!') {
+      this->discard_(i);
+      this->resync_count_++;
+      return;
+    }
+  }
+  this->clear();
+}
+
+}  // namespace arc_bridge
+}  // namespace esphome
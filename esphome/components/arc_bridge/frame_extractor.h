@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace arc_bridge {
+
+// Splits the UART byte stream into `!...;` frames using a fixed-size ring
+// buffer. Each byte is scanned once; a frame that is interrupted by a new `!`
+// or that outgrows the buffer is dropped and extraction resyncs at the next
+// frame start instead of discarding everything that was buffered.
+class FrameExtractor {
+ public:
+  static constexpr size_t CAPACITY = 256;
+
+  // Appends one received byte. Returns false when the buffer was full and the
+  // oldest partial frame had to be discarded to make room.
+  bool push(char c);
+
+  // Copies the next complete frame (including `!` and `;`) into `out` and
+  // returns its length, or 0 when no complete frame is buffered yet. Frames
+  // longer than `out_size` are dropped and counted as an overflow.
+  size_t next_frame(char *out, size_t out_size);
+
+  void clear();
+
+  size_t size() const { return this->size_; }
+  uint32_t overflow_count() const { return this->overflow_count_; }
+  uint32_t resync_count() const { return this->resync_count_; }
+
+ protected:
+  char at_(size_t offset) const { return this->buffer_[(this->head_ + offset) % CAPACITY]; }
+  void discard_(size_t count);
+  void resync_();
+
+  char buffer_[CAPACITY]{};
+  size_t head_{0};
+  size_t size_{0};
+  // Bytes from head_ already scanned without finding a frame terminator.
+  size_t scanned_{0};
+  uint32_t overflow_count_{0};
+  uint32_t resync_count_{0};
+};
+
+}  // namespace arc_bridge
+}  // namespace esphome
@@ -0,0 +1,61 @@
+#include "latency_histogram.h"
+
+namespace esphome {
+namespace arc_bridge {
+
+void LatencyHistogram::record(uint32_t ms) {
+  size_t index = 0;
+  while (ms > LATENCY_BUCKET_BOUNDS_MS[index]) {
+    index++;
+  }
+  this->buckets_[index]++;
+  this->count_++;
+  this->total_ms_ += ms;
+  if (ms > this->max_ms_) {
+    this->max_ms_ = ms;
+  }
+}
+
+uint32_t LatencyHistogram::percentile_ms(uint8_t percent) const {
+  if (this->count_ == 0) {
+    return 0;
+  }
+  // Rank of the sample the percentile falls on, rounded up.
+  const uint64_t rank = (static_cast<uint64_t>(this->count_) * percent + 99) / 100;
+  uint64_t seen = 0;
+  for (size_t i = 0; i < LATENCY_BUCKET_COUNT; i++) {
+    seen += this->buckets_[i];
+    if (seen >= rank && seen > 0) {
+      const uint32_t bound = LATENCY_BUCKET_BOUNDS_MS[i];
+      return bound < this->max_ms_ ? bound : this->max_ms_;
+    }
+  }
+  return this->max_ms_;
+}
+
+const LatencyHistogram &latency_stage(const CommandLatency &latency, LatencyStage stage) {
+  switch (stage) {
+    case LatencyStage::QUEUE_WAIT:
+      return latency.queue_wait;
+    case LatencyStage::ACK_RTT:
+      return latency.ack_rtt;
+    case LatencyStage::TOTAL:
+    default:
+      return latency.total;
+  }
+}
+
+const char *latency_stage_name(LatencyStage stage) {
+  switch (stage) {
+    case LatencyStage::QUEUE_WAIT:
+      return "queue_wait";
+    case LatencyStage::ACK_RTT:
+      return "ack_rtt";
+    case LatencyStage::TOTAL:
+    default:
+      return "total";
+  }
+}
+
+}  // namespace arc_bridge
+}  // namespace esphome
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace arc_bridge {
+
+// Upper bucket bounds in ms, dense around the default 200 ms motion gap and
+// 1500 ms retry timeout; the last bucket takes everything longer.
+static constexpr size_t LATENCY_BUCKET_COUNT = 16;
+static constexpr std::array<uint32_t, LATENCY_BUCKET_COUNT> LATENCY_BUCKET_BOUNDS_MS = {
+    10, 25, 50, 100, 150, 200, 300, 500, 750, 1000, 1500, 2000, 3000, 5000, 10000, UINT32_MAX};
+
+// Fixed-bucket histogram of millisecond durations. Recording is a short scan
+// and never allocates; percentiles resolve to a bucket's upper bound, capped
+// at the largest sample seen.
+class LatencyHistogram {
+ public:
+  void record(uint32_t ms);
+  void clear() { *this = LatencyHistogram{}; }
+
+  uint32_t count() const { return this->count_; }
+  uint32_t max_ms() const { return this->max_ms_; }
+  uint32_t mean_ms() const {
+    return this->count_ == 0 ? 0 : static_cast<uint32_t>(this->total_ms_ / this->count_);
+  }
+  // Smallest bucket bound that covers `percent` of the samples; 0 when empty.
+  uint32_t percentile_ms(uint8_t percent) const;
+  uint32_t bucket(size_t index) const { return this->buckets_[index]; }
+
+ protected:
+  std::array<uint32_t, LATENCY_BUCKET_COUNT> buckets_{};
+  uint32_t count_{0};
+  uint32_t max_ms_{0};
+  uint64_t total_ms_{0};
+};
+
+// Timing of tracked commands through each stage: queued -> written to the
+// UART -> acknowledged by the blind.
+struct CommandLatency {
+  // Enqueue to transmit, for every attempt including retries.
+  LatencyHistogram queue_wait;
+  // Last transmit to the confirming reply.
+  LatencyHistogram ack_rtt;
+  // First enqueue to the confirming reply, across retries.
+  LatencyHistogram total;
+  uint32_t acknowledged{0};
+  // Answered with an explicit offline or not-paired status.
+  uint32_t failed{0};
+  uint32_t retries{0};
+  uint32_t given_up{0};
+
+  void clear() { *this = CommandLatency{}; }
+};
+
+// Which histogram a latency sensor reads.
+enum class LatencyStage : uint8_t {
+  QUEUE_WAIT = 0,
+  ACK_RTT = 1,
+  TOTAL = 2,
+};
+
+const LatencyHistogram &latency_stage(const CommandLatency &latency, LatencyStage stage);
+const char *latency_stage_name(LatencyStage stage);
+
+}  // namespace arc_bridge
+}  // namespace esphome
@@ -0,0 +1,66 @@
+#include "loop_profiler.h"
+
+namespace esphome {
+namespace arc_bridge {
+
+bool LoopProfiler::end_pass(uint32_t cycles) {
+  this->add(LoopSection::LOOP, cycles - this->pass_start_);
+  this->last_pass_ = this->pass_cycles_;
+  for (size_t i = 0; i < LOOP_SECTION_COUNT; i++) {
+    if ((this->pass_ran_ & (1u << i)) == 0) {
+      continue;
+    }
+    LoopSectionStats &stats = this->stats_[i];
+    const uint32_t pass_cycles = this->pass_cycles_[i];
+    stats.runs++;
+    stats.total_cycles += pass_cycles;
+    if (pass_cycles > stats.max_cycles) {
+      stats.max_cycles = pass_cycles;
+    }
+    this->pass_cycles_[i] = 0;
+  }
+  this->pass_ran_ = 0;
+
+  const bool stalled = this->stall_threshold_us_ > 0 &&
+                       this->to_us(this->last_pass_cycles(LoopSection::LOOP)) >
+                           this->stall_threshold_us_;
+  if (stalled) {
+    this->stalls_++;
+  }
+  return stalled;
+}
+
+void LoopProfiler::reset() {
+  this->stats_ = {};
+  this->pass_cycles_ = {};
+  this->last_pass_ = {};
+  this->pass_ran_ = 0;
+  this->stalls_ = 0;
+}
+
+const char *loop_section_name(LoopSection section) {
+  switch (section) {
+    case LoopSection::RX:
+      return "rx";
+    case LoopSection::FRAMING:
+      return "framing";
+    case LoopSection::DISPATCH:
+      return "dispatch";
+    case LoopSection::MOTION:
+      return "motion";
+    case LoopSection::POLL:
+      return "poll";
+    case LoopSection::TX:
+      return "tx";
+    case LoopSection::DELIVERY:
+      return "delivery";
+    case LoopSection::QUERY_ALL:
+      return "query_all";
+    case LoopSection::LOOP:
+    default:
+      return "loop";
+  }
+}
+
+}  // namespace arc_bridge
+}  // namespace esphome
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace arc_bridge {
+
+// A pass whose total exceeds this is logged with its per-section breakdown.
+static constexpr uint32_t DEFAULT_LOOP_STALL_THRESHOLD_US = 30000;
+
+// Parts of BridgeEngine::run() the loop profiler times separately.
+enum class LoopSection : uint8_t {
+  // Reading bytes from the transport.
+  RX = 0,
+  // Frame extraction and recording frames in the UART trace.
+  FRAMING = 1,
+  // Parsing a frame and handling it, including its sensor and cover events.
+  DISPATCH = 2,
+  // Motion polls and expiry, and saving travel times and snapshots.
+  MOTION = 3,
+  // Startup probes, auto-poll, the startup sweep and the TX watchdog.
+  POLL = 4,
+  // Picking and writing the next queued frame.
+  TX = 5,
+  // Delivery retries and give-ups, and the pairing timeout.
+  DELIVERY = 6,
+  // send_query_all(), which runs outside the loop from lambdas.
+  QUERY_ALL = 7,
+  // The whole pass.
+  LOOP = 8,
+};
+static constexpr size_t LOOP_SECTION_COUNT = 9;
+
+struct LoopSectionStats {
+  // Passes the section ran in.
+  uint32_t runs{0};
+  uint32_t max_cycles{0};
+  uint64_t total_cycles{0};
+
+  uint32_t mean_cycles() const {
+    return this->runs == 0 ? 0 : static_cast<uint32_t>(this->total_cycles / this->runs);
+  }
+};
+
+// Running cost of each loop section in CPU cycles. Costs are summed per
+// pass, since a section such as DISPATCH can run several times in one, and
+// folded into the stats by end_pass().
+class LoopProfiler {
+ public:
+  void set_cycles_per_us(uint32_t cycles_per_us) {
+    this->cycles_per_us_ = cycles_per_us == 0 ? 1 : cycles_per_us;
+  }
+  void set_stall_threshold_us(uint32_t threshold_us) { this->stall_threshold_us_ = threshold_us; }
+  uint32_t stall_threshold_us() const { return this->stall_threshold_us_; }
+
+  void begin_pass(uint32_t cycles) { this->pass_start_ = cycles; }
+  void add(LoopSection section, uint32_t cycles) {
+    const size_t index = static_cast<size_t>(section);
+    this->pass_cycles_[index] += cycles;
+    this->pass_ran_ |= 1u << index;
+  }
+  // Returns true when the pass took longer than the stall threshold.
+  bool end_pass(uint32_t cycles);
+  void reset();
+
+  const LoopSectionStats &stats(LoopSection section) const {
+    return this->stats_[static_cast<size_t>(section)];
+  }
+  // The section's cycles in the last finished pass, 0 if it did not run.
+  uint32_t last_pass_cycles(LoopSection section) const {
+    return this->last_pass_[static_cast<size_t>(section)];
+  }
+  uint32_t to_us(uint32_t cycles) const { return cycles / this->cycles_per_us_; }
+  uint32_t stalls() const { return this->stalls_; }
+
+ protected:
+  std::array<LoopSectionStats, LOOP_SECTION_COUNT> stats_{};
+  std::array<uint32_t, LOOP_SECTION_COUNT> pass_cycles_{};
+  std::array<uint32_t, LOOP_SECTION_COUNT> last_pass_{};
+  uint32_t pass_ran_{0};
+  uint32_t pass_start_{0};
+  uint32_t cycles_per_us_{1};
+  uint32_t stall_threshold_us_{DEFAULT_LOOP_STALL_THRESHOLD_US};
+  uint32_t stalls_{0};
+};
+
+// Adds the cycles between construction and destruction to a section.
+template<typename Clock> class LoopSectionScope {
+ public:
+  LoopSectionScope(LoopProfiler &profiler, const Clock &clock, LoopSection section)
+      : profiler_(profiler), clock_(clock), section_(section), start_(clock.cycle_count()) {}
+  ~LoopSectionScope() {
+    this->profiler_.add(this->section_, this->clock_.cycle_count() - this->start_);
+  }
+  LoopSectionScope(const LoopSectionScope &) = delete;
+  LoopSectionScope &operator=(const LoopSectionScope &) = delete;
+
+ protected:
+  LoopProfiler &profiler_;
+  const Clock &clock_;
+  LoopSection section_;
+  uint32_t start_;
+};
+
+const char *loop_section_name(LoopSection section);
+
+}  // namespace arc_bridge
+}  // namespace esphome
@@ -0,0 +1,91 @@
+#include "motion_batch.h"
+
+namespace esphome {
+namespace arc_bridge {
+
+uint32_t MotionBatchTracker::begin() {
+  MotionBatchStatus status;
+  status.id = this->next_id_++;
+  if (this->next_id_ == 0) {
+    this->next_id_ = 1;
+  }
+  this->batches_.push_back(status);
+  return status.id;
+}
+
+void MotionBatchTracker::add(uint32_t batch_id, uint32_t tracking_id) {
+  const size_t index = this->find_batch_(batch_id);
+  if (index == SIZE_MAX) {
+    return;
+  }
+  MotionBatchStatus &status = this->batches_[index];
+  status.total++;
+  if (tracking_id == 0) {
+    status.failed++;
+    return;
+  }
+  this->members_.push_back({batch_id, tracking_id});
+}
+
+bool MotionBatchTracker::seal(uint32_t batch_id, MotionBatchStatus &finished) {
+  const size_t index = this->find_batch_(batch_id);
+  return index != SIZE_MAX && this->finish_if_done_(index, finished);
+}
+
+bool MotionBatchTracker::resolve(uint32_t tracking_id, bool acknowledged,
+                                 MotionBatchStatus &finished) {
+  for (size_t i = 0; i < this->members_.size(); i++) {
+    if (this->members_[i].tracking_id != tracking_id) {
+      continue;
+    }
+    const uint32_t batch_id = this->members_[i].batch_id;
+    this->members_[i] = this->members_.back();
+    this->members_.pop_back();
+
+    const size_t index = this->find_batch_(batch_id);
+    if (index == SIZE_MAX) {
+      return false;
+    }
+    MotionBatchStatus &status = this->batches_[index];
+    if (acknowledged) {
+      status.acknowledged++;
+    } else {
+      status.failed++;
+    }
+    return this->finish_if_done_(index, finished);
+  }
+  return false;
+}
+
+size_t MotionBatchTracker::find_batch_(uint32_t batch_id) const {
+  for (size_t i = 0; i < this->batches_.size(); i++) {
+    if (this->batches_[i].id == batch_id) {
+      return i;
+    }
+  }
+  return SIZE_MAX;
+}
+
+bool MotionBatchTracker::finish_if_done_(size_t index, MotionBatchStatus &finished) {
+  if (!this->batches_[index].done()) {
+    return false;
+  }
+  finished = this->batches_[index];
+  this->batches_.erase(this->batches_.begin() + index);
+  return true;
+}
+
+const char *motion_batch_outcome_name(MotionBatchOutcome outcome) {
+  switch (outcome) {
+    case MotionBatchOutcome::ALL_ACKNOWLEDGED:
+      return "all acknowledged";
+    case MotionBatchOutcome::PARTIAL:
+      return "partial";
+    case MotionBatchOutcome::FAILED:
+    default:
+      return "failed";
+  }
+}
+
+}  // namespace arc_bridge
+}  // namespace esphome
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "blind_id.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace esphome {
+namespace arc_bridge {
+
+enum class MotionBatchOutcome : uint8_t {
+  ALL_ACKNOWLEDGED,
+  // Some members replied, the rest were given up on.
+  PARTIAL,
+  FAILED,
+};
+
+// One member of a batched move.
+struct MotionBatchTarget {
+  BlindId id;
+  // ARC position: 0 is fully open, 100 fully closed.
+  uint8_t percent{0};
+};
+
+struct MotionBatchStatus {
+  uint32_t id{0};
+  uint16_t total{0};
+  uint16_t acknowledged{0};
+  uint16_t failed{0};
+
+  bool done() const { return this->acknowledged + this->failed >= this->total; }
+  MotionBatchOutcome outcome() const {
+    if (this->failed == 0) {
+      return MotionBatchOutcome::ALL_ACKNOWLEDGED;
+    }
+    return this->acknowledged == 0 ? MotionBatchOutcome::FAILED : MotionBatchOutcome::PARTIAL;
+  }
+};
+
+// Maps the tracking id of each batched motion command to its batch, so the
+// bridge can report a batch once every member was acknowledged or given up
+// on. Idle trackers cost one empty check per finished delivery.
+class MotionBatchTracker {
+ public:
+  // Opens a batch and returns its id.
+  uint32_t begin();
+  // Adds a member by the tracking id of its command; 0 records a member that
+  // could not be queued, which counts as failed.
+  void add(uint32_t batch_id, uint32_t tracking_id);
+  // Call once every member was added. Returns true and fills `finished` when
+  // nothing is left to wait for, e.g. when no member could be queued.
+  bool seal(uint32_t batch_id, MotionBatchStatus &finished);
+  // Records the end of a delivery. Returns true and fills `finished` when it
+  // was the last outstanding member of its batch.
+  bool resolve(uint32_t tracking_id, bool acknowledged, MotionBatchStatus &finished);
+
+  size_t active() const { return this->batches_.size(); }
+  bool contains(uint32_t batch_id) const { return this->find_batch_(batch_id) != SIZE_MAX; }
+
+ protected:
+  struct Member {
+    uint32_t batch_id;
+    uint32_t tracking_id;
+  };
+
+  size_t find_batch_(uint32_t batch_id) const;
+  bool finish_if_done_(size_t index, MotionBatchStatus &finished);
+
+  std::vector<MotionBatchStatus> batches_;
+  std::vector<Member> members_;
+  uint32_t next_id_{1};
+};
+
+const char *motion_batch_outcome_name(MotionBatchOutcome outcome);
+
+}  // namespace arc_bridge
+}  // namespace esphome
@@ -0,0 +1,39 @@
+#include "motion_tracker.h"
+
+namespace esphome {
+namespace arc_bridge {
+
+bool MotionState::report(bool in_motion, uint32_t now) {
+  if (in_motion) {
+    // Blinds moved by a remote or another controller are tracked too.
+    this->moving = true;
+    this->last_activity_ms = now;
+    return false;
+  }
+  const bool arrived = this->moving;
+  this->moving = false;
+  return arrived;
+}
+
+bool MotionState::expire(uint32_t now, uint32_t timeout_ms) {
+  if (!this->moving || now - this->last_activity_ms < timeout_ms) {
+    return false;
+  }
+  this->moving = false;
+  return true;
+}
+
+bool MotionState::poll_due(uint32_t now, uint32_t interval_ms) const {
+  if (!this->moving || interval_ms == 0) {
+    return false;
+  }
+  uint32_t spacing = interval_ms;
+  const int32_t remaining = static_cast<int32_t>(this->arrival_ms - now);
+  if (this->arrival_known && remaining > 0 && static_cast<uint32_t>(remaining) / 2 > spacing) {
+    spacing = static_cast<uint32_t>(remaining) / 2;
+  }
+  return now - this->last_poll_ms >= spacing;
+}
+
+}  // namespace arc_bridge
+}  // namespace esphome
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace arc_bridge {
+
+static constexpr uint32_t DEFAULT_MOTION_POLL_INTERVAL_MS = 2000;
+// A blind leaves motion state after this long without an in-motion report, in
+// case its final position never arrives.
+static constexpr uint32_t DEFAULT_MOTION_TIMEOUT_MS = 90000;
+
+// Per-blind motion state, driven by motion commands and by the in-motion
+// ("<NN") and final ("rNNN") position replies.
+struct MotionState {
+  bool moving{false};
+  // Last motion command or in-motion report.
+  uint32_t last_activity_ms{0};
+  uint32_t last_poll_ms{0};
+  // When the blind should arrive, from its learned travel time.
+  uint32_t arrival_ms{0};
+  bool arrival_known{false};
+
+  // A motion command was queued for the blind.
+  void start(uint32_t now) {
+    this->moving = true;
+    this->last_activity_ms = now;
+    this->last_poll_ms = now;
+    this->arrival_known = false;
+  }
+  // The blind acknowledged a move it should finish within `eta_ms`.
+  void expect_arrival(uint32_t now, uint32_t eta_ms) {
+    this->arrival_ms = now + eta_ms;
+    this->arrival_known = true;
+  }
+  // Feeds a position reply; returns true when it ends the motion.
+  bool report(bool in_motion, uint32_t now);
+  // Leaves motion state without an arrival, e.g. when the link drops.
+  void stop() { this->moving = false; }
+  // Leaves motion state once `timeout_ms` passed without activity; returns
+  // true if that happened now.
+  bool expire(uint32_t now, uint32_t timeout_ms);
+  // Polls every `interval_ms`. Before a known arrival the spacing is half the
+  // remaining travel instead, so polls close in on the arrival.
+  bool poll_due(uint32_t now, uint32_t interval_ms) const;
+  void mark_polled(uint32_t now) { this->last_poll_ms = now; }
+};
+
+}  // namespace arc_bridge
+}  // namespace esphome
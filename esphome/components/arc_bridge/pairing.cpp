@@ -21,7 +21,7 @@ void start_pairing_session(PairingSession &session, uint32_t now_ms) {
   session.started_ms = now_ms;
 }
 
-std::string describe_error_code(const std::string &code) {
+std::string describe_error_code(std::string_view code) {
   if (code == "bz") {
     return "Hub busy";
   }
@@ -58,22 +58,22 @@ std::string describe_error_code(const std::string &code) {
   if (code == "ec") {
     return "Undefined error";
   }
-  return "Protocol error " + code;
+  return "Protocol error " + std::string(code);
 }
 
 PairingOutcome handle_pairing_frame(PairingSession &session, const ParsedFrame &parsed) {
   if (parsed.address_ack) {
     if (!session.active) {
-      return {PairingOutcomeType::GENERIC_ACK, "", parsed.id};
+      return {PairingOutcomeType::GENERIC_ACK, "", std::string(parsed.id_view())};
     }
 
-    const std::string paired_id = parsed.id;
+    const std::string paired_id(parsed.id_view());
     clear_pairing_session_(session);
     return {PairingOutcomeType::SUCCESS, "Paired", paired_id};
   }
 
-  if (session.active && static_cast<bool>(parsed.error_code)) {
-    const std::string message = "Error: " + describe_error_code(*parsed.error_code);
+  if (session.active && parsed.has(ParsedFrame::ERROR)) {
+    const std::string message = "Error: " + describe_error_code(parsed.error_code_view());
     clear_pairing_session_(session);
     return {PairingOutcomeType::ERROR, message, ""};
   }
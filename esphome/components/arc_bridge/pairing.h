@@ -4,6 +4,7 @@
 
 #include <cstdint>
 #include <string>
+#include <string_view>
 
 namespace esphome {
 namespace arc_bridge {
@@ -31,7 +32,7 @@ std::string build_pair_command_frame();
 void start_pairing_session(PairingSession &session, uint32_t now_ms);
 PairingOutcome handle_pairing_frame(PairingSession &session, const ParsedFrame &parsed);
 PairingOutcome check_pairing_timeout(PairingSession &session, uint32_t now_ms, uint32_t timeout_ms);
-std::string describe_error_code(const std::string &code);
+std::string describe_error_code(std::string_view code);
 
 }  // namespace arc_bridge
 }  // namespace esphome
@@ -0,0 +1,38 @@
+#include "poll_scheduler.h"
+
+namespace esphome {
+namespace arc_bridge {
+
+uint32_t poll_urgency(const PollState &state, uint32_t now, uint32_t min_age_ms) {
+  const bool has_target = state.max_staleness_ms > 0;
+  const uint32_t skip_below =
+      has_target && state.max_staleness_ms < min_age_ms ? state.max_staleness_ms : min_age_ms;
+
+  // A query is already on its way; give the blind time to answer.
+  if (state.polled && now - state.last_polled_ms < skip_below) {
+    return 0;
+  }
+  if (!state.heard) {
+    return POLL_URGENCY_NEVER_HEARD;
+  }
+
+  const uint32_t age = now - state.last_heard_ms;
+  if (age < skip_below) {
+    return 0;
+  }
+  if (has_target && age >= state.max_staleness_ms) {
+    const uint32_t overdue = age - state.max_staleness_ms;
+    return POLL_URGENCY_OVERDUE +
+           (overdue < POLL_URGENCY_OVERDUE ? overdue : POLL_URGENCY_OVERDUE - 1);
+  }
+
+  const float weighted = static_cast<float>(age) * (state.weight > 0.0f ? state.weight : 0.0f);
+  if (weighted >= static_cast<float>(POLL_URGENCY_OVERDUE - 1)) {
+    return POLL_URGENCY_OVERDUE - 1;
+  }
+  // Anything old enough to poll stays above 0, however small its weight.
+  return weighted < 1.0f ? 1 : static_cast<uint32_t>(weighted);
+}
+
+}  // namespace arc_bridge
+}  // namespace esphome
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace arc_bridge {
+
+// Blinds heard from within this window are not polled.
+static constexpr uint32_t DEFAULT_POLL_MIN_AGE_MS = 60000;
+
+// Urgency bands: a never-heard blind outranks one past its max_staleness
+// target, which outranks every blind still within its target.
+static constexpr uint32_t POLL_URGENCY_NEVER_HEARD = UINT32_MAX;
+static constexpr uint32_t POLL_URGENCY_OVERDUE = 1UL << 30;
+
+// Auto-poll bookkeeping for one blind.
+struct PollState {
+  uint32_t last_heard_ms{0};
+  uint32_t last_polled_ms{0};
+  bool heard{false};
+  bool polled{false};
+  // Scales the blind's age when ranking; 2.0 polls it twice as eagerly.
+  float weight{1.0f};
+  // Once this stale the blind is polled ahead of every blind within its
+  // target, even inside the minimum age. 0 disables the target.
+  uint32_t max_staleness_ms{0};
+
+  void mark_heard(uint32_t now) {
+    this->last_heard_ms = now;
+    this->heard = true;
+  }
+  void mark_polled(uint32_t now) {
+    this->last_polled_ms = now;
+    this->polled = true;
+  }
+  // Milliseconds since any frame from the blind, UINT32_MAX if never heard.
+  uint32_t age_ms(uint32_t now) const {
+    return this->heard ? now - this->last_heard_ms : UINT32_MAX;
+  }
+};
+
+// How urgently a blind needs polling `now`. 0 means skip it: it was heard or
+// asked within `min_age_ms` (or its shorter max_staleness target).
+uint32_t poll_urgency(const PollState &state, uint32_t now, uint32_t min_age_ms);
+
+}  // namespace arc_bridge
+}  // namespace esphome
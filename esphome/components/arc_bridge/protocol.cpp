@@ -1,127 +1,217 @@
 #include "protocol.h"
 
-#include <cctype>
-#include <cstdlib>
+#include <climits>
 
 namespace esphome {
 namespace arc_bridge {
 
 namespace {
 
-esphome_arc_bridge_std_optional::optional<int> parse_decimal_after_(const std::string &text, size_t start) {
+constexpr size_t NPOS = std::string_view::npos;
+
+bool is_digit_(char c) { return c >= '0' && c <= '9'; }
+
+bool is_alpha_(char c) { return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z'); }
+
+bool is_alnum_(char c) { return is_digit_(c) || is_alpha_(c); }
+
+int hex_value_(char c) {
+  if (is_digit_(c)) {
+    return c - '0';
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  return -1;
+}
+
+void remember_first_(size_t &slot, size_t offset) {
+  if (slot == NPOS) {
+    slot = offset;
+  }
+}
+
+bool parse_decimal_after_(std::string_view text, size_t start, int32_t &value) {
   size_t end = start;
-  while (end < text.size() && std::isdigit(static_cast<unsigned char>(text[end]))) {
+  int64_t result = 0;
+  while (end < text.size() && is_digit_(text[end])) {
+    if (result <= INT32_MAX) {
+      result = result * 10 + (text[end] - '0');
+    }
     end++;
   }
   if (end == start) {
-    return esphome_arc_bridge_std_optional::nullopt;
+    return false;
   }
-  return std::atoi(text.substr(start, end - start).c_str());
+  value = result > INT32_MAX ? INT32_MAX : static_cast<int32_t>(result);
+  return true;
 }
 
-esphome_arc_bridge_std_optional::optional<int> parse_hex_byte_after_(const std::string &text, size_t start) {
+bool parse_hex_byte_after_(std::string_view text, size_t start, uint8_t &value) {
   if (start + 2 > text.size()) {
-    return esphome_arc_bridge_std_optional::nullopt;
+    return false;
   }
-  const char hi = text[start];
-  const char lo = text[start + 1];
-  if (!std::isxdigit(static_cast<unsigned char>(hi)) ||
-      !std::isxdigit(static_cast<unsigned char>(lo))) {
-    return esphome_arc_bridge_std_optional::nullopt;
+  const int hi = hex_value_(text[start]);
+  const int lo = hex_value_(text[start + 1]);
+  if (hi < 0 || lo < 0) {
+    return false;
   }
-  return std::strtol(text.substr(start, 2).c_str(), nullptr, 16);
+  value = static_cast<uint8_t>((hi << 4) | lo);
+  return true;
+}
+
+// First offset of every marker the decoder looks at, gathered in one pass.
+struct MarkerOffsets {
+  size_t reply_end{NPOS};
+  size_t voltage{NPOS};
+  size_t speed{NPOS};
+  size_t limits{NPOS};
+  size_t version{NPOS};
+  size_t move{NPOS};
+  size_t position{NPOS};
+  size_t tilt{NPOS};
+  size_t rssi{NPOS};
+  bool lost_link{false};
+  bool not_paired{false};
+};
+
+MarkerOffsets scan_markers_(std::string_view rest) {
+  MarkerOffsets markers;
+  const size_t size = rest.size();
+  for (size_t i = 0; i < size; i++) {
+    switch (rest[i]) {
+      case ',':
+        remember_first_(markers.reply_end, i);
+        break;
+      case '<':
+        remember_first_(markers.move, i);
+        break;
+      case 'r':
+        remember_first_(markers.position, i);
+        break;
+      case 'b':
+        remember_first_(markers.tilt, i);
+        break;
+      case 'R':
+        remember_first_(markers.rssi, i);
+        break;
+      case 'v':
+        remember_first_(markers.version, i);
+        break;
+      case 'p':
+        if (i + 1 < size && rest[i + 1] == 'P') {
+          remember_first_(markers.limits, i);
+        } else if (i + 2 < size && rest[i + 2] == 'c') {
+          if (rest[i + 1] == 'V') {
+            remember_first_(markers.voltage, i);
+          } else if (rest[i + 1] == 'S') {
+            remember_first_(markers.speed, i);
+          }
+        }
+        break;
+      case 'E':
+        if (i + 2 < size && rest[i + 1] == 'n') {
+          markers.lost_link |= rest[i + 2] == 'l';
+          markers.not_paired |= rest[i + 2] == 'p';
+        }
+        break;
+      default:
+        break;
+    }
+  }
+  return markers;
 }
 
 }  // namespace
 
-ParsedFrame parse_arc_frame(const std::string &frame) {
+ParsedFrame parse_arc_frame(std::string_view frame) {
   ParsedFrame parsed;
 
   if (frame.size() < 5 || frame.front() != '!' || frame.back() != ';') {
     return parsed;
   }
 
-  const std::string body = frame.substr(1, frame.size() - 2);
-  if (body.size() < 3) {
-    return parsed;
-  }
-
-  parsed.id = body.substr(0, 3);
-  const std::string rest = body.substr(3);
+  const std::string_view body = frame.substr(1, frame.size() - 2);
+  parsed.set_id(body.substr(0, 3));
+  const std::string_view rest = body.substr(3);
   parsed.valid = true;
-  const size_t reply_end = rest.find(',');
-  parsed.reply_token = rest.substr(0, reply_end == std::string::npos ? rest.size() : reply_end);
 
-  parsed.address_ack = parsed.reply_token == "A";
-  parsed.lost_link = parsed.reply_token == "Enl" || rest.find("Enl") != std::string::npos;
-  parsed.not_paired = parsed.reply_token == "Enp" || rest.find("Enp") != std::string::npos;
-  parsed.no_position = parsed.reply_token == "U";
-  if (!parsed.lost_link && !parsed.not_paired && parsed.reply_token.size() == 3 &&
-      parsed.reply_token.front() == 'E') {
-    parsed.error_code = parsed.reply_token.substr(1);
+  const MarkerOffsets markers = scan_markers_(rest);
+  const std::string_view reply_token = rest.substr(0, markers.reply_end);
+  parsed.set_reply_token(reply_token);
+
+  parsed.address_ack = reply_token == "A";
+  parsed.lost_link = markers.lost_link;
+  parsed.not_paired = markers.not_paired;
+  parsed.no_position = reply_token == "U";
+  if (!parsed.lost_link && !parsed.not_paired && reply_token.size() == 3 &&
+      reply_token.front() == 'E') {
+    parsed.error_code[0] = reply_token[1];
+    parsed.error_code[1] = reply_token[2];
+    parsed.present |= ParsedFrame::ERROR;
   }
 
-  size_t pvc_pos = rest.find("pVc");
-  if (pvc_pos != std::string::npos) {
-    parsed.voltage_centivolts = parse_decimal_after_(rest, pvc_pos + 3);
+  if (markers.voltage != NPOS &&
+      parse_decimal_after_(rest, markers.voltage + 3, parsed.voltage_centivolts)) {
+    parsed.present |= ParsedFrame::VOLTAGE;
   }
 
-  size_t speed_pos = rest.find("pSc");
-  if (speed_pos != std::string::npos) {
-    parsed.speed_rpm = parse_decimal_after_(rest, speed_pos + 3);
+  if (markers.speed != NPOS && parse_decimal_after_(rest, markers.speed + 3, parsed.speed_rpm)) {
+    parsed.present |= ParsedFrame::SPEED;
   }
 
-  size_t limits_pos = rest.find("pP");
-  if (limits_pos != std::string::npos && limits_pos + 4 <= rest.size()) {
-    const std::string code = rest.substr(limits_pos + 2, 2);
-    if (std::isalnum(static_cast<unsigned char>(code[0])) &&
-        std::isalnum(static_cast<unsigned char>(code[1]))) {
-      parsed.limits_code = code;
+  if (markers.limits != NPOS && markers.limits + 4 <= rest.size()) {
+    const char hi = rest[markers.limits + 2];
+    const char lo = rest[markers.limits + 3];
+    if (is_alnum_(hi) && is_alnum_(lo)) {
+      parsed.limits_code[0] = hi;
+      parsed.limits_code[1] = lo;
+      parsed.present |= ParsedFrame::LIMITS;
     }
   }
 
-  size_t version_pos = rest.find('v');
-  if (version_pos != std::string::npos && version_pos + 2 < rest.size()) {
-    const char type_code = rest[version_pos + 1];
-    if (std::isalpha(static_cast<unsigned char>(type_code))) {
-      size_t digit_start = version_pos + 2;
-      size_t digit_end = digit_start;
-      while (digit_end < rest.size() &&
-             std::isdigit(static_cast<unsigned char>(rest[digit_end]))) {
-        digit_end++;
-      }
-      if (digit_end > digit_start) {
-        parsed.motor_type_code = type_code;
-        parsed.version_code = rest.substr(version_pos + 1, digit_end - (version_pos + 1));
-        if (digit_end - digit_start >= 2) {
-          parsed.version_major = rest[digit_start] - '0';
-          parsed.version_minor = rest[digit_start + 1] - '0';
-        }
+  if (markers.version != NPOS && markers.version + 2 < rest.size()) {
+    const char type_code = rest[markers.version + 1];
+    const size_t digit_start = markers.version + 2;
+    size_t digit_end = digit_start;
+    while (digit_end < rest.size() && is_digit_(rest[digit_end])) {
+      digit_end++;
+    }
+    if (is_alpha_(type_code) && digit_end > digit_start) {
+      const size_t code_length = digit_end - (markers.version + 1);
+      const size_t stored = code_length < ParsedFrame::MAX_VERSION_CODE_LENGTH
+                                ? code_length
+                                : ParsedFrame::MAX_VERSION_CODE_LENGTH;
+      rest.copy(parsed.version_code, stored, markers.version + 1);
+      parsed.version_code_length = static_cast<uint8_t>(stored);
+      parsed.motor_type_code = type_code;
+      parsed.present |= ParsedFrame::VERSION;
+      if (digit_end - digit_start >= 2) {
+        parsed.version_major = static_cast<uint8_t>(rest[digit_start] - '0');
+        parsed.version_minor = static_cast<uint8_t>(rest[digit_start + 1] - '0');
+        parsed.present |= ParsedFrame::VERSION_NUMBER;
       }
     }
   }
 
-  size_t move_pos = rest.find('<');
-  if (move_pos != std::string::npos) {
-    parsed.position_percent = parse_decimal_after_(rest, move_pos + 1);
-    parsed.position_in_motion = static_cast<bool>(parsed.position_percent);
-  }
-
-  if (!parsed.position_percent) {
-    size_t pos = rest.find('r');
-    if (pos != std::string::npos) {
-      parsed.position_percent = parse_decimal_after_(rest, pos + 1);
-    } 
+  if (markers.move != NPOS &&
+      parse_decimal_after_(rest, markers.move + 1, parsed.position_percent)) {
+    parsed.position_in_motion = true;
+    parsed.present |= ParsedFrame::POSITION;
+  } else if (markers.position != NPOS &&
+             parse_decimal_after_(rest, markers.position + 1, parsed.position_percent)) {
+    parsed.present |= ParsedFrame::POSITION;
   }
 
-  size_t tilt_pos = rest.find('b');
-  if (tilt_pos != std::string::npos) {
-    parsed.tilt_degrees = parse_decimal_after_(rest, tilt_pos + 1);
+  if (markers.tilt != NPOS && parse_decimal_after_(rest, markers.tilt + 1, parsed.tilt_degrees)) {
+    parsed.present |= ParsedFrame::TILT;
   }
 
-  size_t rssi_pos = rest.find('R');
-  if (rssi_pos != std::string::npos) {
-    parsed.rssi_raw = parse_hex_byte_after_(rest, rssi_pos + 1);
+  if (markers.rssi != NPOS && parse_hex_byte_after_(rest, markers.rssi + 1, parsed.rssi_raw)) {
+    parsed.present |= ParsedFrame::RSSI;
   }
 
   return parsed;
@@ -1,48 +1,89 @@
 #pragma once
 
-#include <string>
-
-#if __has_include(<optional>)
-#include <optional>
-namespace esphome_arc_bridge_std_optional = std;
-#elif __has_include(<experimental/optional>)
-#include <experimental/optional>
-namespace esphome_arc_bridge_std_optional = std::experimental;
-#else
-#error "An optional implementation is required to build protocol.h"
-#endif
+#include "blind_id.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
 
 namespace esphome {
 namespace arc_bridge {
 
+// Decoded ARC reply. Optional values are flagged in `present` instead of being
+// wrapped in optionals, and all text is stored inline, so a ParsedFrame is
+// trivially copyable and never touches the heap.
 struct ParsedFrame {
+  enum Field : uint16_t {
+    POSITION = 1 << 0,
+    TILT = 1 << 1,
+    RSSI = 1 << 2,
+    VOLTAGE = 1 << 3,
+    SPEED = 1 << 4,
+    VERSION = 1 << 5,
+    VERSION_NUMBER = 1 << 6,
+    LIMITS = 1 << 7,
+    ERROR = 1 << 8,
+  };
+
+  // Longer reply tokens and version codes are truncated to these lengths.
+  static constexpr size_t MAX_REPLY_TOKEN_LENGTH = 15;
+  static constexpr size_t MAX_VERSION_CODE_LENGTH = 7;
+
   bool valid{false};
-  std::string id;
-  std::string reply_token;
   bool address_ack{false};
-
-  esphome_arc_bridge_std_optional::optional<int> position_percent;
   bool position_in_motion{false};
-  esphome_arc_bridge_std_optional::optional<int> tilt_degrees;
-  esphome_arc_bridge_std_optional::optional<int> rssi_raw;
-
   bool lost_link{false};
   bool not_paired{false};
   bool no_position{false};
+  uint16_t present{0};
+
+  BlindId blind_id;
+  char id[4]{};
+  char reply_token[MAX_REPLY_TOKEN_LENGTH + 1]{};
+  uint8_t reply_token_length{0};
+
+  int32_t position_percent{0};
+  int32_t tilt_degrees{0};
+  int32_t voltage_centivolts{0};
+  int32_t speed_rpm{0};
+  uint8_t rssi_raw{0};
+
+  char motor_type_code{0};
+  uint8_t version_major{0};
+  uint8_t version_minor{0};
+  char version_code[MAX_VERSION_CODE_LENGTH + 1]{};
+  uint8_t version_code_length{0};
+
+  char limits_code[3]{};
+  char error_code[3]{};
+
+  bool has(Field field) const { return (this->present & field) != 0; }
 
-  esphome_arc_bridge_std_optional::optional<int> voltage_centivolts;
-  esphome_arc_bridge_std_optional::optional<int> speed_rpm;
+  std::string_view id_view() const { return this->id; }
+  std::string_view reply_token_view() const { return {this->reply_token, this->reply_token_length}; }
+  std::string_view version_code_view() const {
+    return {this->version_code, this->version_code_length};
+  }
+  std::string_view limits_code_view() const { return this->limits_code; }
+  std::string_view error_code_view() const { return this->error_code; }
 
-  esphome_arc_bridge_std_optional::optional<std::string> version_code;
-  esphome_arc_bridge_std_optional::optional<char> motor_type_code;
-  esphome_arc_bridge_std_optional::optional<int> version_major;
-  esphome_arc_bridge_std_optional::optional<int> version_minor;
+  void set_id(std::string_view value) {
+    for (size_t i = 0; i < 3; i++) {
+      this->id[i] = i < value.size() ? value[i] : '\0';
+    }
+    this->blind_id = BlindId::from_text(value);
+  }
 
-  esphome_arc_bridge_std_optional::optional<std::string> limits_code;
-  esphome_arc_bridge_std_optional::optional<std::string> error_code;
+  void set_reply_token(std::string_view value) {
+    const size_t length =
+        value.size() < MAX_REPLY_TOKEN_LENGTH ? value.size() : MAX_REPLY_TOKEN_LENGTH;
+    value.copy(this->reply_token, length);
+    this->reply_token[length] = '\0';
+    this->reply_token_length = static_cast<uint8_t>(length);
+  }
 };
 
-ParsedFrame parse_arc_frame(const std::string &frame);
+ParsedFrame parse_arc_frame(std::string_view frame);
 
 }  // namespace arc_bridge
 }  // namespace esphome
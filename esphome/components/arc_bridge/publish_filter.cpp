@@ -0,0 +1,95 @@
+#include "publish_filter.h"
+
+#include <cmath>
+
+namespace esphome {
+namespace arc_bridge {
+
+bool PublishFilter::admit(PublishSlot &slot, SensorKind kind, float value, uint32_t now) {
+  bool changed;
+  bool urgent = false;
+  if (!slot.published) {
+    changed = true;
+  } else if (std::isnan(value) || std::isnan(slot.value)) {
+    changed = std::isnan(value) != std::isnan(slot.value);
+    urgent = changed;
+  } else {
+    const float difference = std::fabs(value - slot.value);
+    const float delta = this->policy(kind).delta;
+    changed = delta > 0.0f ? difference >= delta : difference > 0.0f;
+  }
+
+  if (!this->decide_(slot, kind, changed, urgent, now)) {
+    return false;
+  }
+  slot.value = value;
+  return true;
+}
+
+bool PublishFilter::admit_text(PublishSlot &slot, SensorKind kind, std::string_view value,
+                               uint32_t now) {
+  const uint32_t hash = publish_text_hash(value);
+  const bool changed = !slot.published || hash != slot.text_hash;
+  if (!this->decide_(slot, kind, changed, false, now)) {
+    return false;
+  }
+  slot.text_hash = hash;
+  return true;
+}
+
+bool PublishFilter::decide_(PublishSlot &slot, SensorKind kind, bool changed, bool urgent,
+                            uint32_t now) {
+  const PublishPolicy &policy = this->policy(kind);
+  PublishStats &stats = this->stats_[static_cast<size_t>(kind)];
+  const uint32_t since_publish = now - slot.last_publish_ms;
+
+  bool publish;
+  if (!slot.published || urgent) {
+    publish = true;
+  } else if (changed) {
+    publish = since_publish >= policy.min_interval_ms;
+  } else {
+    publish = policy.heartbeat_ms > 0 && since_publish >= policy.heartbeat_ms;
+  }
+
+  if (!publish) {
+    stats.suppressed++;
+    return false;
+  }
+  slot.published = true;
+  slot.last_publish_ms = now;
+  stats.emitted++;
+  return true;
+}
+
+uint32_t publish_text_hash(std::string_view text) {
+  uint32_t hash = 2166136261u;
+  for (const char c : text) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+const char *sensor_kind_name(SensorKind kind) {
+  switch (kind) {
+    case SensorKind::LINK_QUALITY:
+      return "link_quality";
+    case SensorKind::STATUS:
+      return "status";
+    case SensorKind::VOLTAGE:
+      return "voltage";
+    case SensorKind::BATTERY_LEVEL:
+      return "battery_level";
+    case SensorKind::SPEED:
+      return "speed";
+    case SensorKind::VERSION:
+      return "version";
+    case SensorKind::LIMITS:
+    default:
+      return "limits";
+  }
+}
+
+}  // namespace arc_bridge
+}  // namespace esphome
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace esphome {
+namespace arc_bridge {
+
+// The per-blind sensors the bridge publishes, each with its own policy.
+enum class SensorKind : uint8_t {
+  LINK_QUALITY = 0,
+  STATUS = 1,
+  VOLTAGE = 2,
+  BATTERY_LEVEL = 3,
+  SPEED = 4,
+  VERSION = 5,
+  LIMITS = 6,
+};
+static constexpr size_t SENSOR_KIND_COUNT = 7;
+
+struct PublishPolicy {
+  // Smallest change in a numeric value that is published; 0 publishes any
+  // change. Text sensors publish on any change.
+  float delta{0.0f};
+  // A change within this long of the last publish is held back until a later
+  // report. Becoming (un)available is never held back.
+  uint32_t min_interval_ms{0};
+  // An unchanged value is published again after this long; 0 never repeats.
+  uint32_t heartbeat_ms{0};
+};
+
+static constexpr std::array<PublishPolicy, SENSOR_KIND_COUNT> DEFAULT_PUBLISH_POLICIES = {{
+    {2.0f, 30000, 900000},  // link_quality, dBm
+    {0.0f, 0, 900000},      // status
+    {0.05f, 0, 3600000},    // voltage, V
+    {1.0f, 0, 3600000},     // battery_level, %
+    {1.0f, 0, 3600000},     // speed, rpm
+    {0.0f, 0, 3600000},     // version
+    {0.0f, 0, 3600000},     // limits
+}};
+
+// What was last published to one sensor.
+struct PublishSlot {
+  bool published{false};
+  // Last numeric value, or the hash of the last text.
+  float value{0.0f};
+  uint32_t text_hash{0};
+  uint32_t last_publish_ms{0};
+};
+
+struct PublishStats {
+  uint32_t emitted{0};
+  uint32_t suppressed{0};
+};
+
+// Decides which sensor reports reach Home Assistant: changes beyond the
+// kind's delta, rate limited per sensor, plus a periodic heartbeat.
+class PublishFilter {
+ public:
+  void set_policy(SensorKind kind, const PublishPolicy &policy) {
+    this->policies_[static_cast<size_t>(kind)] = policy;
+  }
+  PublishPolicy &policy(SensorKind kind) { return this->policies_[static_cast<size_t>(kind)]; }
+  const PublishPolicy &policy(SensorKind kind) const {
+    return this->policies_[static_cast<size_t>(kind)];
+  }
+
+  // Return true when the value should be published, and record it as such.
+  bool admit(PublishSlot &slot, SensorKind kind, float value, uint32_t now);
+  bool admit_text(PublishSlot &slot, SensorKind kind, std::string_view value, uint32_t now);
+
+  const PublishStats &stats(SensorKind kind) const {
+    return this->stats_[static_cast<size_t>(kind)];
+  }
+  void reset_stats() { this->stats_ = {}; }
+
+ protected:
+  // `urgent` changes skip the minimum interval.
+  bool decide_(PublishSlot &slot, SensorKind kind, bool changed, bool urgent, uint32_t now);
+
+  std::array<PublishPolicy, SENSOR_KIND_COUNT> policies_{DEFAULT_PUBLISH_POLICIES};
+  std::array<PublishStats, SENSOR_KIND_COUNT> stats_{};
+};
+
+// 32-bit FNV-1a, used to compare text sensor values without storing them.
+uint32_t publish_text_hash(std::string_view text);
+const char *sensor_kind_name(SensorKind kind);
+
+}  // namespace arc_bridge
+}  // namespace esphome
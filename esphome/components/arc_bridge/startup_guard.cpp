@@ -0,0 +1,50 @@
+#include "startup_guard.h"
+
+namespace esphome {
+namespace arc_bridge {
+
+void StartupGuard::begin(uint32_t now) {
+  this->state_ = StartupGuardState::SETTLING;
+  this->hub_answered_ = false;
+  this->begin_ms_ = now;
+  this->last_probe_ms_ = now;
+  this->probes_sent_ = 0;
+  this->duration_ms_ = 0;
+}
+
+bool StartupGuard::update(uint32_t now) {
+  if (this->cleared()) {
+    return false;
+  }
+  const uint32_t elapsed = now - this->begin_ms_;
+  if (elapsed < this->settle_ms_) {
+    return false;
+  }
+  if (this->hub_answered_ || elapsed >= this->max_ms_) {
+    this->state_ =
+        this->hub_answered_ ? StartupGuardState::HUB_READY : StartupGuardState::TIMED_OUT;
+    // Never 0, so a cleared guard always reports a duration.
+    this->duration_ms_ = elapsed > 0 ? elapsed : 1;
+    return true;
+  }
+  this->state_ = StartupGuardState::PROBING;
+  return false;
+}
+
+const char *startup_guard_state_name(StartupGuardState state) {
+  switch (state) {
+    case StartupGuardState::SETTLING:
+      return "settling";
+    case StartupGuardState::PROBING:
+      return "probing";
+    case StartupGuardState::HUB_READY:
+      return "hub ready";
+    case StartupGuardState::TIMED_OUT:
+      return "timed out";
+    default:
+      return "unknown";
+  }
+}
+
+}  // namespace arc_bridge
+}  // namespace esphome
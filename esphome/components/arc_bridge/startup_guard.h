@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace arc_bridge {
+
+// Upper bound: the guard clears after this long even if the hub never answers.
+static constexpr uint32_t DEFAULT_STARTUP_GUARD_MS = 10000;
+// Lower bound, for the UART lines to settle after boot.
+static constexpr uint32_t DEFAULT_STARTUP_SETTLE_MS = 500;
+// Spacing of readiness probes while the hub stays silent.
+static constexpr uint32_t STARTUP_PROBE_INTERVAL_MS = 1000;
+
+enum class StartupGuardState : uint8_t {
+  SETTLING = 0,
+  PROBING = 1,
+  // Cleared by a valid frame from the hub.
+  HUB_READY = 2,
+  // Cleared by the upper bound.
+  TIMED_OUT = 3,
+};
+
+// Holds commands and polling back after boot until the hub has answered a
+// readiness probe, or until the upper bound passed without an answer.
+class StartupGuard {
+ public:
+  void set_settle_ms(uint32_t settle_ms) { this->settle_ms_ = settle_ms; }
+  void set_max_ms(uint32_t max_ms) { this->max_ms_ = max_ms; }
+  uint32_t settle_ms() const { return this->settle_ms_; }
+  uint32_t max_ms() const { return this->max_ms_; }
+
+  void begin(uint32_t now);
+  // A valid frame arrived from the hub.
+  void frame_received() {
+    if (!this->cleared()) {
+      this->hub_answered_ = true;
+    }
+  }
+  // Advances the guard; returns true if it cleared at `now`.
+  bool update(uint32_t now);
+  bool probe_due(uint32_t now) const {
+    return this->state_ == StartupGuardState::PROBING &&
+           (this->probes_sent_ == 0 || now - this->last_probe_ms_ >= STARTUP_PROBE_INTERVAL_MS);
+  }
+  void mark_probed(uint32_t now) {
+    this->last_probe_ms_ = now;
+    this->probes_sent_++;
+  }
+
+  bool cleared() const {
+    return this->state_ == StartupGuardState::HUB_READY ||
+           this->state_ == StartupGuardState::TIMED_OUT;
+  }
+  StartupGuardState state() const { return this->state_; }
+  // Milliseconds from begin() until the guard cleared, 0 while it holds.
+  uint32_t duration_ms() const { return this->duration_ms_; }
+  uint32_t probes_sent() const { return this->probes_sent_; }
+
+ protected:
+  uint32_t settle_ms_{DEFAULT_STARTUP_SETTLE_MS};
+  uint32_t max_ms_{DEFAULT_STARTUP_GUARD_MS};
+  StartupGuardState state_{StartupGuardState::SETTLING};
+  bool hub_answered_{false};
+  uint32_t begin_ms_{0};
+  uint32_t last_probe_ms_{0};
+  uint32_t probes_sent_{0};
+  uint32_t duration_ms_{0};
+};
+
+const char *startup_guard_state_name(StartupGuardState state);
+
+}  // namespace arc_bridge
+}  // namespace esphome
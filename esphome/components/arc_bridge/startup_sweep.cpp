@@ -0,0 +1,49 @@
+#include "startup_sweep.h"
+
+namespace esphome {
+namespace arc_bridge {
+
+void StartupSweep::begin(size_t blind_count, uint32_t now) {
+  this->blind_count_ = blind_count;
+  this->cursor_ = 0;
+  this->aborted_ = false;
+  this->started_ms_ = now;
+  this->phase_ = blind_count == 0 ? SweepPhase::DONE : SweepPhase::POSITION;
+}
+
+bool StartupSweep::next(size_t &blind, SweepPhase &phase) {
+  if (this->phase_ == SweepPhase::DONE) {
+    return false;
+  }
+  blind = this->cursor_;
+  phase = this->phase_;
+  if (++this->cursor_ >= this->blind_count_) {
+    this->cursor_ = 0;
+    this->phase_ = static_cast<SweepPhase>(static_cast<uint8_t>(this->phase_) + 1);
+  }
+  return true;
+}
+
+void StartupSweep::abort() {
+  if (this->phase_ != SweepPhase::DONE) {
+    this->phase_ = SweepPhase::DONE;
+    this->aborted_ = true;
+  }
+}
+
+const char *sweep_phase_name(SweepPhase phase) {
+  switch (phase) {
+    case SweepPhase::POSITION:
+      return "position";
+    case SweepPhase::TELEMETRY:
+      return "telemetry";
+    case SweepPhase::STATIC:
+      return "static";
+    case SweepPhase::DONE:
+    default:
+      return "done";
+  }
+}
+
+}  // namespace arc_bridge
+}  // namespace esphome
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace arc_bridge {
+
+// The order the startup sweep fills blind state in: every blind's position
+// (and link quality, which rides on the same reply) before any telemetry, and
+// static values last.
+enum class SweepPhase : uint8_t {
+  POSITION = 0,
+  TELEMETRY = 1,
+  STATIC = 2,
+  DONE = 3,
+};
+
+// Walks every registered blind once per phase after boot. The bridge takes
+// one step whenever its TX queue runs empty, so the sweep goes back to back at
+// the standard TX gap without flooding the queue ahead of commands.
+class StartupSweep {
+ public:
+  void begin(size_t blind_count, uint32_t now);
+  // The next blind and phase to query; false once every phase is done.
+  bool next(size_t &blind, SweepPhase &phase);
+  // Ends the sweep early, e.g. for a motion command.
+  void abort();
+
+  bool active() const { return this->phase_ != SweepPhase::DONE; }
+  bool aborted() const { return this->aborted_; }
+  uint32_t started_ms() const { return this->started_ms_; }
+
+ protected:
+  size_t blind_count_{0};
+  size_t cursor_{0};
+  SweepPhase phase_{SweepPhase::DONE};
+  bool aborted_{false};
+  uint32_t started_ms_{0};
+};
+
+const char *sweep_phase_name(SweepPhase phase);
+
+}  // namespace arc_bridge
+}  // namespace esphome
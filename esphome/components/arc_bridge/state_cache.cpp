@@ -0,0 +1,105 @@
+#include "state_cache.h"
+
+#include <cstring>
+
+namespace esphome {
+namespace arc_bridge {
+
+const char *blind_status_text(BlindStatus status) {
+  switch (status) {
+    case BlindStatus::ONLINE:
+      return "Online";
+    case BlindStatus::OFFLINE:
+      return "Offline";
+    case BlindStatus::NOT_PAIRED:
+      return "Not Paired";
+    case BlindStatus::NO_POSITION:
+      return "No Position";
+    case BlindStatus::UNKNOWN:
+    default:
+      return nullptr;
+  }
+}
+
+BlindSnapshot BlindSnapshot::empty(BlindId id) {
+  BlindSnapshot snapshot;
+  snapshot.format = BLIND_SNAPSHOT_FORMAT;
+  snapshot.blind = id.packed();
+  return snapshot;
+}
+
+bool BlindSnapshot::update(const ParsedFrame &parsed) {
+  if (!parsed.valid || parsed.has(ParsedFrame::ERROR)) {
+    return false;
+  }
+  const BlindSnapshot before = *this;
+
+  if (parsed.lost_link) {
+    this->status = BlindStatus::OFFLINE;
+  } else if (parsed.not_paired) {
+    this->status = BlindStatus::NOT_PAIRED;
+  } else {
+    this->status = parsed.no_position ? BlindStatus::NO_POSITION : BlindStatus::ONLINE;
+  }
+
+  // In-motion positions are not worth a save; the final one follows.
+  if (parsed.has(ParsedFrame::POSITION) && !parsed.position_in_motion &&
+      parsed.position_percent >= 0 && parsed.position_percent <= 100) {
+    this->position = static_cast<int8_t>(parsed.position_percent);
+    this->present |= POSITION;
+  }
+  if (parsed.has(ParsedFrame::VOLTAGE) && parsed.voltage_centivolts >= 0) {
+    this->voltage_centivolts = parsed.voltage_centivolts;
+    this->present |= VOLTAGE;
+  }
+  if (parsed.has(ParsedFrame::VERSION)) {
+    this->motor_type_code = parsed.motor_type_code;
+    this->version_major = parsed.version_major;
+    this->version_minor = parsed.version_minor;
+    std::memset(this->version_code, 0, sizeof(this->version_code));
+    std::memcpy(this->version_code, parsed.version_code, parsed.version_code_length);
+    this->present |= VERSION;
+    if (parsed.has(ParsedFrame::VERSION_NUMBER)) {
+      this->present |= VERSION_NUMBER;
+    } else {
+      this->present &= ~VERSION_NUMBER;
+    }
+    this->static_restores = 0;
+  }
+  if (parsed.has(ParsedFrame::LIMITS)) {
+    std::memset(this->limits_code, 0, sizeof(this->limits_code));
+    std::memcpy(this->limits_code, parsed.limits_code, sizeof(parsed.limits_code));
+    this->present |= LIMITS;
+    this->static_restores = 0;
+  }
+
+  return std::memcmp(&before, this, sizeof(BlindSnapshot)) != 0;
+}
+
+ParsedFrame BlindSnapshot::static_frame() const {
+  ParsedFrame frame;
+  frame.valid = true;
+  if (this->has(VERSION)) {
+    frame.present |= ParsedFrame::VERSION;
+    if (this->has(VERSION_NUMBER)) {
+      frame.present |= ParsedFrame::VERSION_NUMBER;
+    }
+    frame.motor_type_code = this->motor_type_code;
+    frame.version_major = this->version_major;
+    frame.version_minor = this->version_minor;
+    size_t length = 0;
+    while (length < ParsedFrame::MAX_VERSION_CODE_LENGTH && this->version_code[length] != '\0') {
+      length++;
+    }
+    std::memcpy(frame.version_code, this->version_code, length);
+    frame.version_code_length = static_cast<uint8_t>(length);
+  }
+  if (this->has(LIMITS)) {
+    frame.present |= ParsedFrame::LIMITS;
+    std::memcpy(frame.limits_code, this->limits_code, sizeof(frame.limits_code) - 1);
+  }
+  return frame;
+}
+
+}  // namespace arc_bridge
+}  // namespace esphome
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "blind_id.h"
+#include "protocol.h"
+
+#include <cstdint>
+#include <type_traits>
+
+namespace esphome {
+namespace arc_bridge {
+
+// Bump whenever the BlindSnapshot layout changes; snapshots in any other
+// format are discarded at boot.
+static constexpr uint8_t BLIND_SNAPSHOT_FORMAT = 1;
+// Changed snapshots are saved at most this often.
+static constexpr uint32_t DEFAULT_STATE_SAVE_INTERVAL_MS = 30000;
+// Restored version and limits are queried again after this much uptime, or
+// after MAX_STATIC_RESTORES boots that restored them without the blind ever
+// confirming them.
+static constexpr uint32_t DEFAULT_STATIC_REFRESH_INTERVAL_MS = 24 * 60 * 60 * 1000;
+static constexpr uint8_t MAX_STATIC_RESTORES = 8;
+
+enum class BlindStatus : uint8_t {
+  UNKNOWN = 0,
+  ONLINE = 1,
+  OFFLINE = 2,
+  NOT_PAIRED = 3,
+  NO_POSITION = 4,
+};
+
+// The status sensor text for `status`, nullptr for UNKNOWN.
+const char *blind_status_text(BlindStatus status);
+
+// The last known state of one blind, saved to preferences so covers and
+// sensors come back at boot before the blind is heard from again.
+struct BlindSnapshot {
+  enum Field : uint8_t {
+    POSITION = 1 << 0,
+    VOLTAGE = 1 << 1,
+    VERSION = 1 << 2,
+    VERSION_NUMBER = 1 << 3,
+    LIMITS = 1 << 4,
+  };
+
+  uint8_t format{0};
+  uint8_t present{0};
+  BlindStatus status{BlindStatus::UNKNOWN};
+  // Boots that restored version or limits since the blind last sent them.
+  uint8_t static_restores{0};
+  // Packed BlindId, so a hash collision between preference keys is caught.
+  uint32_t blind{0};
+  int32_t voltage_centivolts{0};
+  int8_t position{0};
+  char motor_type_code{0};
+  uint8_t version_major{0};
+  uint8_t version_minor{0};
+  char version_code[ParsedFrame::MAX_VERSION_CODE_LENGTH + 1]{};
+  char limits_code[4]{};
+
+  bool has(Field field) const { return (this->present & field) != 0; }
+  // An empty snapshot for `id` in the current format.
+  static BlindSnapshot empty(BlindId id);
+  // True if this snapshot was saved for `id` in the current format.
+  bool matches(BlindId id) const {
+    return this->format == BLIND_SNAPSHOT_FORMAT && this->blind == id.packed();
+  }
+  // Takes the status and any final position, voltage, version and limits
+  // `parsed` carries. Returns true if the snapshot changed.
+  bool update(const ParsedFrame &parsed);
+  // The version and limits as a frame, for the bridge's reply formatters.
+  ParsedFrame static_frame() const;
+};
+
+// No padding, so snapshots compare and save byte for byte.
+static_assert(sizeof(BlindSnapshot) == 28, "BlindSnapshot must stay free of padding");
+static_assert(std::is_trivially_copyable<BlindSnapshot>::value,
+              "BlindSnapshot is saved to preferences byte for byte");
+
+}  // namespace arc_bridge
+}  // namespace esphome
@@ -0,0 +1,148 @@
+#include "travel_model.h"
+
+#include <cstdlib>
+
+namespace esphome {
+namespace arc_bridge {
+
+namespace {
+
+TravelDirection direction_between_(int from, int to) {
+  if (to > from) {
+    return TravelDirection::CLOSING;
+  }
+  if (to < from) {
+    return TravelDirection::OPENING;
+  }
+  return TravelDirection::NONE;
+}
+
+uint32_t scale_to_full_travel_(uint32_t elapsed_ms, int distance) {
+  return static_cast<uint32_t>(static_cast<uint64_t>(elapsed_ms) * 100 /
+                               static_cast<uint32_t>(distance));
+}
+
+}  // namespace
+
+uint32_t TravelModel::eta_ms(int from, int target) const {
+  if (from < 0) {
+    // Unknown start: the blind may have to cross the whole range.
+    return target >= 50 ? this->closing_ms : this->opening_ms;
+  }
+  const uint32_t full = this->full_travel_ms(direction_between_(from, target));
+  return static_cast<uint32_t>(static_cast<uint64_t>(full) * std::abs(target - from) / 100);
+}
+
+bool TravelModel::learn(TravelDirection direction, uint32_t full_travel_ms) {
+  if (full_travel_ms < MIN_TRAVEL_TIME_MS || full_travel_ms > MAX_TRAVEL_TIME_MS) {
+    return false;
+  }
+  uint32_t *learned = nullptr;
+  uint8_t *samples = nullptr;
+  uint8_t *outliers = nullptr;
+  if (direction == TravelDirection::OPENING) {
+    learned = &this->opening_ms;
+    samples = &this->opening_samples;
+    outliers = &this->opening_outliers;
+  } else if (direction == TravelDirection::CLOSING) {
+    learned = &this->closing_ms;
+    samples = &this->closing_samples;
+    outliers = &this->closing_outliers;
+  } else {
+    return false;
+  }
+
+  if (*samples > 0 && (full_travel_ms > *learned * 2 || full_travel_ms < *learned / 2)) {
+    if (++*outliers < TRAVEL_RELEARN_OUTLIERS) {
+      return false;
+    }
+    *samples = 0;
+  }
+  *outliers = 0;
+  if (*samples == 0) {
+    *learned = full_travel_ms;
+    *samples = 1;
+    return true;
+  }
+
+  // Running mean over the first few samples, then an exponential average that
+  // follows slow drift such as a weakening battery.
+  const uint32_t weight = *samples < 4 ? *samples + 1 : 4;
+  const int64_t delta = static_cast<int64_t>(full_travel_ms) - *learned;
+  const uint32_t previous = *learned;
+  *learned = static_cast<uint32_t>(*learned + delta / static_cast<int64_t>(weight));
+  if (*samples < UINT8_MAX) {
+    (*samples)++;
+  }
+  return *learned != previous;
+}
+
+void TravelMeasurement::start(int from, int target, uint32_t now) {
+  this->active_ = true;
+  this->spoiled_ = false;
+  this->target_ = target;
+  this->start_position_ = from;
+  this->start_ms_ = now;
+  this->samples_ = 0;
+  this->direction_ = from < 0 ? direction_between_(50, target) : direction_between_(from, target);
+  if (this->direction_ == TravelDirection::NONE) {
+    this->active_ = false;
+  }
+}
+
+void TravelMeasurement::sample(int position, uint32_t now) {
+  if (!this->active_) {
+    return;
+  }
+  const int previous = this->samples_ > 0 ? this->last_sample_ : this->start_position_;
+  if (previous >= 0 && direction_between_(previous, position) != TravelDirection::NONE &&
+      direction_between_(previous, position) != this->direction_) {
+    this->spoiled_ = true;
+  }
+  if (this->samples_ == 0) {
+    this->first_sample_ = position;
+    this->first_sample_ms_ = now;
+  }
+  this->last_sample_ = position;
+  this->last_sample_ms_ = now;
+  if (this->samples_ < UINT8_MAX) {
+    this->samples_++;
+  }
+}
+
+uint32_t TravelMeasurement::finish(int position, uint32_t now) {
+  if (!this->active_) {
+    return 0;
+  }
+  this->active_ = false;
+  if (this->spoiled_ || std::abs(position - this->target_) > TRAVEL_ARRIVAL_TOLERANCE_PERCENT) {
+    return 0;
+  }
+
+  // In-motion reports time the travel itself, without the polling delay of
+  // the final reply, so they win when they span enough of the move.
+  if (this->samples_ >= 2) {
+    const int span = std::abs(this->last_sample_ - this->first_sample_);
+    if (span >= MIN_MEASURED_TRAVEL_PERCENT) {
+      return scale_to_full_travel_(this->last_sample_ms_ - this->first_sample_ms_, span);
+    }
+  }
+
+  int from = this->start_position_;
+  uint32_t from_ms = this->start_ms_;
+  if (from < 0) {
+    if (this->samples_ == 0) {
+      return 0;
+    }
+    from = this->first_sample_;
+    from_ms = this->first_sample_ms_;
+  }
+  const int distance = std::abs(position - from);
+  if (distance < MIN_MEASURED_TRAVEL_PERCENT) {
+    return 0;
+  }
+  return scale_to_full_travel_(now - from_ms, distance);
+}
+
+}  // namespace arc_bridge
+}  // namespace esphome
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "cover_motion.h"
+
+#include <cstdint>
+#include <type_traits>
+
+namespace esphome {
+namespace arc_bridge {
+
+// Learned models are written to flash at most this often.
+static constexpr uint32_t DEFAULT_TRAVEL_SAVE_INTERVAL_MS = 15 * 60 * 1000;
+// Full 0-100% travel times outside these bounds are measurement errors.
+static constexpr uint32_t MIN_TRAVEL_TIME_MS = 2000;
+static constexpr uint32_t MAX_TRAVEL_TIME_MS = 300000;
+// Shorter moves are dominated by RF and motor start-up latency.
+static constexpr int MIN_MEASURED_TRAVEL_PERCENT = 20;
+// A final position this close to the target still counts as arrived.
+static constexpr int TRAVEL_ARRIVAL_TOLERANCE_PERCENT = 2;
+// Consecutive outliers after which the model starts over from the newest one,
+// e.g. after a motor or fabric change.
+static constexpr uint8_t TRAVEL_RELEARN_OUTLIERS = 3;
+// Slack a learned travel time gets before a quiet blind leaves motion state.
+static constexpr uint32_t TRAVEL_TIMEOUT_MARGIN_MS = 10000;
+
+// Learned full travel times of one blind, stored as-is in preferences.
+struct TravelModel {
+  // Milliseconds for a full move in each direction; 0 until learned.
+  uint32_t opening_ms{0};
+  uint32_t closing_ms{0};
+  uint8_t opening_samples{0};
+  uint8_t closing_samples{0};
+  uint8_t opening_outliers{0};
+  uint8_t closing_outliers{0};
+
+  uint32_t full_travel_ms(TravelDirection direction) const {
+    switch (direction) {
+      case TravelDirection::OPENING:
+        return this->opening_ms;
+      case TravelDirection::CLOSING:
+        return this->closing_ms;
+      case TravelDirection::NONE:
+      default:
+        return 0;
+    }
+  }
+  // The slower learned direction, 0 while neither is learned.
+  uint32_t slowest_ms() const {
+    return this->opening_ms > this->closing_ms ? this->opening_ms : this->closing_ms;
+  }
+  // Expected milliseconds from acknowledgement to arrival at `target`. Assumes
+  // a full move when `from` is unknown (negative); 0 while unlearned.
+  uint32_t eta_ms(int from, int target) const;
+  // Feeds one measured full travel time. Samples more than twice or less than
+  // half the learned time are rejected until TRAVEL_RELEARN_OUTLIERS arrive in
+  // a row. Returns true when the learned time changed.
+  bool learn(TravelDirection direction, uint32_t full_travel_ms);
+};
+
+static_assert(std::is_trivially_copyable<TravelModel>::value,
+              "TravelModel is saved to preferences byte for byte");
+
+// Times one acknowledged move up to its final position reply.
+class TravelMeasurement {
+ public:
+  // The blind acknowledged a move from `from` (negative if unknown) to `target`.
+  void start(int from, int target, uint32_t now);
+  // An in-motion report. A report against the direction of travel, e.g. a
+  // remote reversing the blind, spoils the measurement.
+  void sample(int position, uint32_t now);
+  // The final position reply. Returns the measured time scaled to a full move,
+  // or 0 if the move cannot be measured: it stopped short of its target, was
+  // too short, or neither the start nor an in-motion report is known.
+  uint32_t finish(int position, uint32_t now);
+  void cancel() { this->active_ = false; }
+
+  bool active() const { return this->active_; }
+  TravelDirection direction() const { return this->direction_; }
+
+ protected:
+  bool active_{false};
+  bool spoiled_{false};
+  TravelDirection direction_{TravelDirection::NONE};
+  int target_{0};
+  int start_position_{-1};
+  uint32_t start_ms_{0};
+  uint8_t samples_{0};
+  int first_sample_{0};
+  uint32_t first_sample_ms_{0};
+  int last_sample_{0};
+  uint32_t last_sample_ms_{0};
+};
+
+}  // namespace arc_bridge
+}  // namespace esphome
@@ -5,6 +5,243 @@
 namespace esphome {
 namespace arc_bridge {
 
+void TxQueue::set_capacity(size_t capacity) {
+  this->slots_.assign(capacity == 0 ? 1 : capacity, TxQueueItem{});
+  this->clear();
+}
+
+bool TxQueue::push_back(const TxQueueItem &item) {
+  if (this->full()) {
+    return false;
+  }
+  this->slots_[this->slot_(this->size_)] = item;
+  this->size_++;
+  return true;
+}
+
+void TxQueue::erase(size_t index) {
+  if (index >= this->size_) {
+    return;
+  }
+  for (size_t i = index + 1; i < this->size_; i++) {
+    (*this)[i - 1] = (*this)[i];
+  }
+  this->size_--;
+}
+
+void TxQueue::clear() {
+  this->head_ = 0;
+  this->size_ = 0;
+}
+
+TxQueryKind tx_query_kind(const TxQueueItem &item) {
+  // "!" + id + query + ";"
+  const std::string_view frame = item.frame.view();
+  if (!item.blind_id.valid() || frame.size() < BlindId::LENGTH + 3) {
+    return TxQueryKind::NONE;
+  }
+  const std::string_view query =
+      frame.substr(BlindId::LENGTH + 1, frame.size() - BlindId::LENGTH - 2);
+  if (query == "r?") {
+    return TxQueryKind::POSITION;
+  }
+  if (query == "pVc?") {
+    return TxQueryKind::VOLTAGE;
+  }
+  if (query == "pSc?") {
+    return TxQueryKind::SPEED;
+  }
+  if (query == "v?") {
+    return TxQueryKind::VERSION;
+  }
+  if (query == "pP?") {
+    return TxQueryKind::LIMITS;
+  }
+  return TxQueryKind::NONE;
+}
+
+void TxQueryIndex::reserve(size_t count) {
+  this->bits_ = 1;
+  while ((static_cast<size_t>(1) << this->bits_) < count * 2) {
+    this->bits_++;
+  }
+  this->keys_.assign(static_cast<size_t>(1) << this->bits_, 0);
+  this->size_ = 0;
+}
+
+size_t TxQueryIndex::find_(uint32_t key) const {
+  if (this->keys_.empty()) {
+    return NONE;
+  }
+  const size_t mask = this->keys_.size() - 1;
+  for (size_t slot = this->home_(key);; slot = (slot + 1) & mask) {
+    if (this->keys_[slot] == key) {
+      return slot;
+    }
+    if (this->keys_[slot] == 0) {
+      return NONE;
+    }
+  }
+}
+
+bool TxQueryIndex::insert(uint32_t key) {
+  if (this->keys_.empty() || this->size_ + 1 >= this->keys_.size()) {
+    return false;
+  }
+  const size_t mask = this->keys_.size() - 1;
+  size_t slot = this->home_(key);
+  for (; this->keys_[slot] != 0; slot = (slot + 1) & mask) {
+    if (this->keys_[slot] == key) {
+      return false;
+    }
+  }
+  this->keys_[slot] = key;
+  this->size_++;
+  return true;
+}
+
+void TxQueryIndex::erase(uint32_t key) {
+  size_t hole = this->find_(key);
+  if (hole == NONE) {
+    return;
+  }
+  // Backward-shift deletion: pull later keys of the probe run into the hole
+  // so lookups never need tombstones.
+  const size_t mask = this->keys_.size() - 1;
+  for (size_t slot = (hole + 1) & mask; this->keys_[slot] != 0; slot = (slot + 1) & mask) {
+    const size_t home = this->home_(this->keys_[slot]);
+    // Keys whose home lies cyclically in (hole, slot] must stay put.
+    const bool stays = hole <= slot ? (home > hole && home <= slot) : (home > hole || home <= slot);
+    if (!stays) {
+      this->keys_[hole] = this->keys_[slot];
+      hole = slot;
+    }
+  }
+  this->keys_[hole] = 0;
+  this->size_--;
+}
+
+void TxQueryIndex::clear() {
+  std::fill(this->keys_.begin(), this->keys_.end(), 0);
+  this->size_ = 0;
+}
+
+TxPushResult TxScheduler::push(const TxQueueItem &item, TxPriorityClass priority_class,
+                               uint32_t now) {
+  const TxQueryKind kind = tx_query_kind(item);
+  if (kind != TxQueryKind::NONE &&
+      this->queries_.contains(TxQueryIndex::key(item.blind_id, kind))) {
+    return this->merge_(item, kind, priority_class);
+  }
+
+  if (!item.is_poll && this->queue_.full()) {
+    for (size_t i = this->queue_.size(); i-- > 0;) {
+      if (this->queue_[i].is_poll) {
+        this->forget_(this->queue_[i]);
+        this->queue_.erase(i);
+        break;
+      }
+    }
+  }
+  if (!this->queue_.push_back(item)) {
+    return TxPushResult::DROPPED;
+  }
+  TxQueueItem &queued = this->queue_[this->queue_.size() - 1];
+  queued.priority_class = priority_class;
+  queued.enqueued_ms = now;
+  if (kind != TxQueryKind::NONE) {
+    this->queries_.insert(TxQueryIndex::key(item.blind_id, kind));
+  }
+  return TxPushResult::QUEUED;
+}
+
+TxPushResult TxScheduler::merge_(const TxQueueItem &item, TxQueryKind kind,
+                                 TxPriorityClass priority_class) {
+  this->stats_[static_cast<size_t>(priority_class)].merged++;
+  for (size_t i = 0; i < this->queue_.size(); i++) {
+    TxQueueItem &queued = this->queue_[i];
+    if (queued.blind_id != item.blind_id || tx_query_kind(queued) != kind) {
+      continue;
+    }
+    const bool promote = priority_class < queued.priority_class;
+    // A request that must survive drop_polls() pins the query it merged into.
+    const bool pin = queued.is_poll && !item.is_poll;
+    if (!promote && !pin) {
+      return TxPushResult::MERGED;
+    }
+    if (promote) {
+      queued.priority_class = priority_class;
+    }
+    if (pin) {
+      queued.is_poll = false;
+    }
+    return TxPushResult::PROMOTED;
+  }
+  return TxPushResult::MERGED;
+}
+
+void TxScheduler::forget_(const TxQueueItem &item) {
+  const TxQueryKind kind = tx_query_kind(item);
+  if (kind != TxQueryKind::NONE) {
+    this->queries_.erase(TxQueryIndex::key(item.blind_id, kind));
+  }
+}
+
+void TxScheduler::complete(size_t index, uint32_t now) {
+  if (index >= this->queue_.size()) {
+    return;
+  }
+  const TxQueueItem &item = this->queue_[index];
+  TxClassStats &stats = this->stats_[static_cast<size_t>(item.priority_class)];
+  const uint32_t waited = now - item.enqueued_ms;
+  stats.sent++;
+  stats.last_wait_ms = waited;
+  stats.total_wait_ms += waited;
+  if (waited > stats.max_wait_ms) {
+    stats.max_wait_ms = waited;
+  }
+  this->forget_(item);
+  this->queue_.erase(index);
+}
+
+size_t TxScheduler::drop_polls() {
+  return this->queue_.remove_if([this](const TxQueueItem &item) {
+    if (!item.is_poll) {
+      return false;
+    }
+    this->forget_(item);
+    return true;
+  });
+}
+
+const char *tx_priority_class_name(TxPriorityClass priority_class) {
+  switch (priority_class) {
+    case TxPriorityClass::EMERGENCY_STOP:
+      return "stop";
+    case TxPriorityClass::MOTION:
+      return "motion";
+    case TxPriorityClass::RETRY_VERIFY:
+      return "retry";
+    case TxPriorityClass::INTERACTIVE_QUERY:
+      return "query";
+    case TxPriorityClass::STATIC_QUERY:
+      return "static query";
+    case TxPriorityClass::BACKGROUND_POLL:
+    default:
+      return "poll";
+  }
+}
+
+const char *tx_pacing_class_name(TxPacingClass pacing_class) {
+  switch (pacing_class) {
+    case TxPacingClass::MOTION:
+      return "motion";
+    case TxPacingClass::STANDARD:
+    default:
+      return "standard";
+  }
+}
+
 uint32_t tx_gap_ms_for(TxPacingClass pacing_class, uint32_t motion_tx_gap_ms) {
   switch (pacing_class) {
     case TxPacingClass::MOTION:
@@ -15,23 +252,49 @@ uint32_t tx_gap_ms_for(TxPacingClass pacing_class, uint32_t motion_tx_gap_ms) {
   }
 }
 
-void drop_pending_poll_items(std::deque<TxQueueItem> &queue) {
-  queue.erase(
-      std::remove_if(queue.begin(), queue.end(),
-                     [](const TxQueueItem &item) { return item.is_poll; }),
-      queue.end());
+bool build_command_frame(TxFrame &frame, BlindId id, char command, std::string_view payload) {
+  frame.clear();
+  if (!id.valid() || BlindId::LENGTH + payload.size() + 3 > TxFrame::CAPACITY) {
+    return false;
+  }
+  frame.append('!');
+  frame.append(id.text().view());
+  frame.append(command);
+  frame.append(payload);
+  frame.append(';');
+  return true;
 }
 
-bool tx_item_can_send_while_delivery_pending(const TxQueueItem &item,
-                                             const std::string &pending_blind_id,
-                                             uint32_t pending_tracking_id) {
-  if (pending_blind_id.empty() || pending_tracking_id == 0) {
-    return true;
+bool build_raw_frame(TxFrame &frame, std::string_view command) {
+  frame.clear();
+  if (command.empty()) {
+    return false;
+  }
+  const bool needs_start = command.front() != '!';
+  const bool needs_end = command.back() != ';';
+  if (command.size() + needs_start + needs_end > TxFrame::CAPACITY) {
+    return false;
+  }
+  if (needs_start) {
+    frame.append('!');
   }
+  frame.append(command);
+  if (needs_end) {
+    frame.append(';');
+  }
+  return true;
+}
+
+bool tx_item_fits_delivery_window(const TxQueueItem &item, uint32_t blind_tracking_id,
+                                  size_t in_flight, size_t window) {
   if (item.delivery_expectation == DeliveryExpectation::NONE) {
     return true;
   }
-  return item.blind_id == pending_blind_id && item.tracking_id == pending_tracking_id;
+  if (blind_tracking_id != 0) {
+    // At most one delivery per blind; only its own retry may go out.
+    return item.tracking_id == blind_tracking_id;
+  }
+  return in_flight < window;
 }
 
 }  // namespace arc_bridge
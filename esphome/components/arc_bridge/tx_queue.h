@@ -1,40 +1,309 @@
 #pragma once
 
+#include "blind_id.h"
 #include "delivery.h"
+#include "fixed_string.h"
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
-#include <deque>
-#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
 namespace esphome {
 namespace arc_bridge {
 
 static constexpr uint32_t DEFAULT_TX_GAP_MS = 800;
 static constexpr uint32_t DEFAULT_MOTION_TX_GAP_MS = 200;
+// Longest frame a queue item stores inline, including the '!' and ';'. The
+// longest frame the bridge builds itself is "!USZm100;".
+static constexpr size_t MAX_TX_FRAME_LENGTH = 23;
+// Floor for the queue capacity; the bridge grows it to fit a send_query_all()
+// pass over every blind unless tx_queue_capacity is configured.
+static constexpr size_t DEFAULT_TX_QUEUE_CAPACITY = 192;
+// Queries a send_query_all() pass queues per blind.
+static constexpr size_t TX_QUERIES_PER_BLIND = 5;
+// Tracked commands that may await a blind reply at once, each to a different
+// blind. 1 restores strict one-at-a-time delivery.
+static constexpr size_t DEFAULT_DELIVERY_WINDOW = 4;
 
 enum class TxPacingClass : uint8_t {
   STANDARD = 0,
   MOTION = 1,
 };
+static constexpr size_t TX_PACING_CLASS_COUNT = 2;
 
+// Scheduling classes, most urgent first; a larger value is less urgent.
+enum class TxPriorityClass : uint8_t {
+  EMERGENCY_STOP = 0,
+  MOTION = 1,
+  RETRY_VERIFY = 2,
+  INTERACTIVE_QUERY = 3,
+  STATIC_QUERY = 4,
+  BACKGROUND_POLL = 5,
+};
+static constexpr size_t TX_PRIORITY_CLASS_COUNT = 6;
+
+// Base scores per class. A queued item gains one point per aging interval it
+// waits (capped at MAX_TX_AGING_BOOST), so a poll that waited long enough
+// still overtakes fresh motion traffic, while a stop is never overtaken.
+static constexpr std::array<uint16_t, TX_PRIORITY_CLASS_COUNT> DEFAULT_TX_CLASS_WEIGHTS = {
+    10000, 1000, 800, 600, 400, 200};
+static constexpr uint32_t DEFAULT_TX_AGING_INTERVAL_MS = 50;
+static constexpr uint32_t MAX_TX_AGING_BOOST = 5000;
+
+using TxFrame = FixedString<MAX_TX_FRAME_LENGTH>;
+
+// Queue items keep every string inline so queueing and sending never allocate.
 struct TxQueueItem {
-  std::string frame;
+  TxFrame frame;
   TxPacingClass pacing_class{TxPacingClass::STANDARD};
   bool is_poll{false};
-  std::string blind_id;
+  BlindId blind_id;
   DeliveryExpectation delivery_expectation{DeliveryExpectation::NONE};
   bool allow_retry{false};
   uint32_t tracking_id{0};
-  std::string expected_ack_token;
-  std::string expected_ack_prefix;
+  FixedString<5> expected_ack_token;
+  FixedString<2> expected_ack_prefix;
+  // Filled in by TxScheduler::push().
+  TxPriorityClass priority_class{TxPriorityClass::INTERACTIVE_QUERY};
+  uint32_t enqueued_ms{0};
+};
+
+// Slots are overwritten in place, so moving an item is a plain copy.
+static_assert(std::is_trivially_copyable<TxQueueItem>::value,
+              "TxQueueItem must stay free of owning members");
+
+// Fixed-capacity FIFO of queue items backed by storage allocated once at
+// construction. Pushes fail instead of growing when the queue is full.
+class TxQueue {
+ public:
+  explicit TxQueue(size_t capacity = DEFAULT_TX_QUEUE_CAPACITY)
+      : slots_(capacity == 0 ? 1 : capacity) {}
+
+  // Reallocates the slots and drops every queued item; call before setup().
+  void set_capacity(size_t capacity);
+
+  bool push_back(const TxQueueItem &item);
+  // Removes the item at `index`, keeping the order of the rest.
+  void erase(size_t index);
+  void clear();
+
+  TxQueueItem &front() { return this->slots_[this->head_]; }
+  const TxQueueItem &front() const { return this->slots_[this->head_]; }
+  TxQueueItem &operator[](size_t index) { return this->slots_[this->slot_(index)]; }
+  const TxQueueItem &operator[](size_t index) const { return this->slots_[this->slot_(index)]; }
+
+  size_t size() const { return this->size_; }
+  size_t capacity() const { return this->slots_.size(); }
+  bool empty() const { return this->size_ == 0; }
+  bool full() const { return this->size_ == this->slots_.size(); }
+
+  // Removes matching items in place, keeping the order of the rest.
+  template<typename Predicate> size_t remove_if(Predicate predicate) {
+    size_t kept = 0;
+    for (size_t i = 0; i < this->size_; i++) {
+      TxQueueItem &item = (*this)[i];
+      if (predicate(item)) {
+        continue;
+      }
+      if (kept != i) {
+        (*this)[kept] = item;
+      }
+      kept++;
+    }
+    const size_t removed = this->size_ - kept;
+    this->size_ = kept;
+    return removed;
+  }
+
+ protected:
+  size_t slot_(size_t index) const { return (this->head_ + index) % this->slots_.size(); }
+
+  std::vector<TxQueueItem> slots_;
+  size_t head_{0};
+  size_t size_{0};
+};
+
+// Read-only queries the bridge polls for. A blind never has two of the same
+// kind queued.
+enum class TxQueryKind : uint8_t {
+  NONE = 0,
+  POSITION = 1,  // r?
+  VOLTAGE = 2,   // pVc?
+  SPEED = 3,     // pSc?
+  VERSION = 4,   // v?
+  LIMITS = 5,    // pP?
+};
+
+// The query `item` carries, or NONE for commands and frames without a blind.
+TxQueryKind tx_query_kind(const TxQueueItem &item);
+
+// Open-addressed set of the (blind, query kind) pairs waiting in the queue,
+// so a duplicate query is caught without scanning the queue.
+class TxQueryIndex {
+ public:
+  static constexpr uint32_t key(BlindId id, TxQueryKind kind) {
+    return id.packed() | static_cast<uint32_t>(kind) << 24;
+  }
+
+  // Sizes the table for `count` keys at a load factor of at most one half and
+  // empties it.
+  void reserve(size_t count);
+  bool contains(uint32_t key) const { return this->find_(key) != NONE; }
+  // Returns false when the key was already present or the table is full.
+  bool insert(uint32_t key);
+  void erase(uint32_t key);
+  void clear();
+  size_t size() const { return this->size_; }
+
+ protected:
+  static constexpr size_t NONE = SIZE_MAX;
+
+  size_t home_(uint32_t key) const { return (key * 0x9E3779B1u) >> (32 - this->bits_); }
+  size_t find_(uint32_t key) const;
+
+  // 0 marks an empty slot; real keys always carry a query kind.
+  std::vector<uint32_t> keys_;
+  uint8_t bits_{0};
+  size_t size_{0};
+};
+
+enum class TxPushResult : uint8_t {
+  QUEUED,
+  // The same query was already queued; nothing was added.
+  MERGED,
+  // As MERGED, and the queued query moved up to the more urgent class.
+  PROMOTED,
+  DROPPED,
+};
+
+// How long items of one class waited between being queued and being sent.
+struct TxClassStats {
+  uint32_t sent{0};
+  // Requests of this class absorbed by an identical queued query.
+  uint32_t merged{0};
+  uint32_t last_wait_ms{0};
+  uint32_t max_wait_ms{0};
+  uint64_t total_wait_ms{0};
+
+  uint32_t average_wait_ms() const {
+    return this->sent == 0 ? 0 : static_cast<uint32_t>(this->total_wait_ms / this->sent);
+  }
+};
+
+// Picks the next frame to send from a TxQueue by class weight plus aging
+// instead of strict arrival order. Items stay in arrival order in the queue,
+// so equal scores are sent oldest first.
+class TxScheduler {
+ public:
+  static constexpr size_t NONE = SIZE_MAX;
+
+  explicit TxScheduler(size_t capacity = DEFAULT_TX_QUEUE_CAPACITY) : queue_(capacity) {
+    this->queries_.reserve(this->queue_.capacity());
+  }
+
+  void set_capacity(size_t capacity) {
+    this->queue_.set_capacity(capacity);
+    this->queries_.reserve(this->queue_.capacity());
+  }
+  void set_class_weight(TxPriorityClass priority_class, uint16_t weight) {
+    this->weights_[static_cast<size_t>(priority_class)] = weight;
+  }
+  uint16_t class_weight(TxPriorityClass priority_class) const {
+    return this->weights_[static_cast<size_t>(priority_class)];
+  }
+  // 0 disables aging.
+  void set_aging_interval(uint32_t interval_ms) { this->aging_interval_ms_ = interval_ms; }
+
+  // Queues a copy of `item` in `priority_class`. A query already waiting for
+  // the same blind absorbs the request instead, moving up to `priority_class`
+  // if that is more urgent. A command arriving at a full queue displaces the
+  // newest poll.
+  TxPushResult push(const TxQueueItem &item, TxPriorityClass priority_class, uint32_t now);
+
+  uint32_t score(const TxQueueItem &item, uint32_t now) const {
+    uint32_t boost = 0;
+    if (this->aging_interval_ms_ > 0) {
+      boost = (now - item.enqueued_ms) / this->aging_interval_ms_;
+      if (boost > MAX_TX_AGING_BOOST) {
+        boost = MAX_TX_AGING_BOOST;
+      }
+    }
+    return this->class_weight(item.priority_class) + boost;
+  }
+
+  // Index of the highest scoring item `eligible` accepts, or NONE.
+  template<typename Eligible> size_t select(uint32_t now, Eligible eligible) const {
+    size_t best = NONE;
+    uint32_t best_score = 0;
+    for (size_t i = 0; i < this->queue_.size(); i++) {
+      const TxQueueItem &item = this->queue_[i];
+      if (!eligible(item)) {
+        continue;
+      }
+      const uint32_t item_score = this->score(item, now);
+      if (best == NONE || item_score > best_score) {
+        best = i;
+        best_score = item_score;
+      }
+    }
+    return best;
+  }
+  size_t select(uint32_t now) const {
+    return this->select(now, [](const TxQueueItem &) { return true; });
+  }
+
+  // Removes a sent item and records its wait in the stats of its class.
+  void complete(size_t index, uint32_t now);
+  // Removes every queued poll; returns how many were dropped.
+  size_t drop_polls();
+
+  const TxClassStats &stats(TxPriorityClass priority_class) const {
+    return this->stats_[static_cast<size_t>(priority_class)];
+  }
+  void reset_stats() { this->stats_ = {}; }
+
+  // Read-only: every removal has to go through the scheduler to keep the
+  // query index in step with the queue.
+  const TxQueue &queue() const { return this->queue_; }
+  size_t size() const { return this->queue_.size(); }
+  bool empty() const { return this->queue_.empty(); }
+  size_t pending_queries() const { return this->queries_.size(); }
+  void clear() {
+    this->queue_.clear();
+    this->queries_.clear();
+  }
+
+ protected:
+  TxPushResult merge_(const TxQueueItem &item, TxQueryKind kind, TxPriorityClass priority_class);
+  void forget_(const TxQueueItem &item);
+
+  TxQueue queue_;
+  TxQueryIndex queries_;
+  std::array<uint16_t, TX_PRIORITY_CLASS_COUNT> weights_{DEFAULT_TX_CLASS_WEIGHTS};
+  uint32_t aging_interval_ms_{DEFAULT_TX_AGING_INTERVAL_MS};
+  std::array<TxClassStats, TX_PRIORITY_CLASS_COUNT> stats_{};
 };
 
+const char *tx_priority_class_name(TxPriorityClass priority_class);
+const char *tx_pacing_class_name(TxPacingClass pacing_class);
 uint32_t tx_gap_ms_for(TxPacingClass pacing_class,
                        uint32_t motion_tx_gap_ms = DEFAULT_MOTION_TX_GAP_MS);
-void drop_pending_poll_items(std::deque<TxQueueItem> &queue);
-bool tx_item_can_send_while_delivery_pending(const TxQueueItem &item,
-                                             const std::string &pending_blind_id,
-                                             uint32_t pending_tracking_id);
+// Writes "!<id><command><payload>;" into `frame`. Returns false for an invalid
+// id or when the frame does not fit.
+bool build_command_frame(TxFrame &frame, BlindId id, char command,
+                         std::string_view payload = {});
+// Adds the '!' and ';' delimiters a raw command is missing. Returns false if
+// the command is empty or does not fit.
+bool build_raw_frame(TxFrame &frame, std::string_view command);
+// Delivery window admission. Untracked frames always pass. A tracked frame
+// passes if it retries the delivery already pending for its blind
+// (`blind_tracking_id`, 0 when none), or if its blind has nothing pending and
+// fewer than `window` deliveries are in flight.
+bool tx_item_fits_delivery_window(const TxQueueItem &item, uint32_t blind_tracking_id,
+                                  size_t in_flight, size_t window);
 
 }  // namespace arc_bridge
 }  // namespace esphome
@@ -0,0 +1,216 @@
+#include "uart_trace.h"
+
+#include <cstring>
+#include <iterator>
+
+namespace esphome {
+namespace arc_bridge {
+
+namespace {
+
+constexpr uint8_t MAGIC[] = {'A', 'R', 'C', 'T'};
+
+size_t encode_delta(uint32_t value, uint8_t *out) {
+  size_t length = 0;
+  do {
+    uint8_t byte = value & 0x7F;
+    value >>= 7;
+    if (value != 0) {
+      byte |= 0x80;
+    }
+    out[length++] = byte;
+  } while (value != 0);
+  return length;
+}
+
+void append_u32(std::vector<uint8_t> &out, uint32_t value) {
+  for (int shift = 0; shift < 32; shift += 8) {
+    out.push_back(static_cast<uint8_t>(value >> shift));
+  }
+}
+
+uint32_t read_u32(const uint8_t *data) {
+  return static_cast<uint32_t>(data[0]) | static_cast<uint32_t>(data[1]) << 8 |
+         static_cast<uint32_t>(data[2]) << 16 | static_cast<uint32_t>(data[3]) << 24;
+}
+
+}  // namespace
+
+void UartTrace::set_capacity(size_t bytes) {
+  this->buffer_.assign(bytes > MAX_UART_TRACE_SIZE ? MAX_UART_TRACE_SIZE : bytes, 0);
+  this->buffer_.shrink_to_fit();
+  this->clear();
+}
+
+void UartTrace::clear() {
+  this->head_ = 0;
+  this->used_ = 0;
+  this->records_ = 0;
+  this->dropped_ = 0;
+}
+
+void UartTrace::record(uint32_t now_ms, TraceDirection direction, std::string_view frame) {
+  if (this->buffer_.empty()) {
+    return;
+  }
+  const size_t length =
+      frame.size() > UART_TRACE_MAX_FRAME ? UART_TRACE_MAX_FRAME : frame.size();
+  uint8_t delta[5];
+  const size_t delta_length =
+      encode_delta(this->records_ == 0 ? 0 : now_ms - this->last_ms_, delta);
+  const size_t size = 2 + delta_length + length;
+  if (size > this->buffer_.size()) {
+    this->dropped_++;
+    return;
+  }
+  while (this->used_ + size > this->buffer_.size()) {
+    this->drop_oldest_();
+  }
+
+  if (this->records_ == 0) {
+    this->first_ms_ = now_ms;
+  }
+  this->put_(static_cast<uint8_t>(direction));
+  this->put_(static_cast<uint8_t>(length));
+  for (size_t i = 0; i < delta_length; i++) {
+    this->put_(delta[i]);
+  }
+  for (size_t i = 0; i < length; i++) {
+    this->put_(static_cast<uint8_t>(frame[i]));
+  }
+  this->records_++;
+  this->last_ms_ = now_ms;
+}
+
+void UartTrace::put_(uint8_t value) {
+  size_t index = this->head_ + this->used_;
+  if (index >= this->buffer_.size()) {
+    index -= this->buffer_.size();
+  }
+  this->buffer_[index] = value;
+  this->used_++;
+}
+
+size_t UartTrace::record_size_at_(size_t offset, uint32_t *delta_ms) const {
+  const size_t length = this->at_(offset + 1);
+  uint32_t delta = 0;
+  size_t delta_length = 0;
+  uint8_t byte;
+  do {
+    byte = this->at_(offset + 2 + delta_length);
+    delta |= static_cast<uint32_t>(byte & 0x7F) << (7 * delta_length);
+    delta_length++;
+  } while ((byte & 0x80) != 0);
+  if (delta_ms != nullptr) {
+    *delta_ms = delta;
+  }
+  return 2 + delta_length + length;
+}
+
+void UartTrace::drop_oldest_() {
+  const size_t size = this->record_size_at_(0, nullptr);
+  this->head_ = (this->head_ + size) % this->buffer_.size();
+  this->used_ -= size;
+  this->records_--;
+  this->dropped_++;
+  if (this->records_ > 0) {
+    // The new oldest record's delta now moves the capture's first timestamp.
+    uint32_t delta;
+    this->record_size_at_(0, &delta);
+    this->first_ms_ += delta;
+  }
+}
+
+void UartTrace::export_capture(std::vector<uint8_t> &out) const {
+  out.reserve(out.size() + UART_TRACE_HEADER_SIZE + this->used_);
+  out.insert(out.end(), std::begin(MAGIC), std::end(MAGIC));
+  out.push_back(UART_TRACE_VERSION);
+  append_u32(out, this->origin_ms_);
+  append_u32(out, this->first_ms_);
+  append_u32(out, this->dropped_);
+
+  size_t offset = 0;
+  for (uint32_t i = 0; i < this->records_; i++) {
+    const size_t size = this->record_size_at_(offset, nullptr);
+    const size_t length = this->at_(offset + 1);
+    if (i == 0) {
+      // The oldest record's stored delta points at a record that is gone.
+      out.push_back(this->at_(offset));
+      out.push_back(static_cast<uint8_t>(length));
+      out.push_back(0);
+      for (size_t j = size - length; j < size; j++) {
+        out.push_back(this->at_(offset + j));
+      }
+    } else {
+      for (size_t j = 0; j < size; j++) {
+        out.push_back(this->at_(offset + j));
+      }
+    }
+    offset += size;
+  }
+}
+
+UartTraceReader::UartTraceReader(const uint8_t *data, size_t size) : data_(data), size_(size) {
+  if (size < UART_TRACE_HEADER_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0 ||
+      data[4] != UART_TRACE_VERSION) {
+    return;
+  }
+  this->valid_ = true;
+  this->origin_ms_ = read_u32(data + 5);
+  this->at_ms_ = read_u32(data + 9);
+  this->dropped_ = read_u32(data + 13);
+}
+
+bool UartTraceReader::next(TraceRecord &record) {
+  if (!this->valid_ || this->truncated_ || this->offset_ >= this->size_) {
+    return false;
+  }
+  size_t offset = this->offset_;
+  if (this->size_ - offset < 3) {
+    this->truncated_ = true;
+    return false;
+  }
+  const uint8_t direction = this->data_[offset];
+  const size_t length = this->data_[offset + 1];
+  offset += 2;
+
+  uint32_t delta = 0;
+  for (size_t shift = 0;; shift += 7) {
+    if (offset >= this->size_ || shift > 28) {
+      this->truncated_ = true;
+      return false;
+    }
+    const uint8_t byte = this->data_[offset++];
+    delta |= static_cast<uint32_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) {
+      break;
+    }
+  }
+  if (direction > static_cast<uint8_t>(TraceDirection::COMMAND) ||
+      this->size_ - offset < length) {
+    this->truncated_ = true;
+    return false;
+  }
+
+  this->at_ms_ += delta;
+  record.at_ms = this->at_ms_;
+  record.direction = static_cast<TraceDirection>(direction);
+  record.frame = std::string_view(reinterpret_cast<const char *>(this->data_ + offset), length);
+  this->offset_ = offset + length;
+  return true;
+}
+
+const char *trace_direction_name(TraceDirection direction) {
+  switch (direction) {
+    case TraceDirection::RX:
+      return "rx";
+    case TraceDirection::TX:
+      return "tx";
+    case TraceDirection::COMMAND:
+    default:
+      return "command";
+  }
+}
+
+}  // namespace arc_bridge
+}  // namespace esphome
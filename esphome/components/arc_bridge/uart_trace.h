@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace esphome {
+namespace arc_bridge {
+
+// Byte budget for the UART trace ring; 0 disables tracing.
+static constexpr size_t DEFAULT_UART_TRACE_SIZE = 0;
+static constexpr size_t MAX_UART_TRACE_SIZE = 32768;
+
+enum class TraceDirection : uint8_t {
+  // A complete frame from the hub.
+  RX = 0,
+  // A frame written to the hub.
+  TX = 1,
+  // A motion command requested through the API, recorded as its frame so a
+  // replay can request it again.
+  COMMAND = 2,
+};
+
+struct TraceRecord {
+  uint32_t at_ms{0};
+  TraceDirection direction{TraceDirection::RX};
+  std::string_view frame;
+};
+
+// Capture layout, all integers little endian:
+//   "ARCT", version (1 byte), origin_ms (4), first_ms (4), dropped (4)
+//   then per record: direction (1), length (1), delta_ms (LEB128), frame.
+// `origin_ms` is when the engine started, `first_ms` the time of the oldest
+// record and each delta is relative to the record before; the first record's
+// delta is 0. `dropped` counts records overwritten or too large to keep.
+static constexpr uint8_t UART_TRACE_VERSION = 1;
+static constexpr size_t UART_TRACE_HEADER_SIZE = 17;
+// Frames longer than this are truncated.
+static constexpr size_t UART_TRACE_MAX_FRAME = 255;
+
+// Fixed-size ring of UART frames in the capture record layout. Recording
+// copies the frame and a few header bytes; once full, the oldest records are
+// overwritten. The ring is allocated once by set_capacity().
+class UartTrace {
+ public:
+  // Reallocates and clears the ring.
+  void set_capacity(size_t bytes);
+  size_t capacity() const { return this->buffer_.size(); }
+  bool enabled() const { return !this->buffer_.empty(); }
+
+  void set_origin(uint32_t origin_ms) { this->origin_ms_ = origin_ms; }
+  void record(uint32_t now_ms, TraceDirection direction, std::string_view frame);
+  void clear();
+
+  size_t used() const { return this->used_; }
+  uint32_t record_count() const { return this->records_; }
+  uint32_t dropped() const { return this->dropped_; }
+
+  // Appends the capture, oldest record first.
+  void export_capture(std::vector<uint8_t> &out) const;
+
+ protected:
+  uint8_t at_(size_t offset) const {
+    return this->buffer_[(this->head_ + offset) % this->buffer_.size()];
+  }
+  void put_(uint8_t value);
+  // Size and delta of the record `offset` bytes after the head.
+  size_t record_size_at_(size_t offset, uint32_t *delta_ms) const;
+  void drop_oldest_();
+
+  std::vector<uint8_t> buffer_;
+  size_t head_{0};
+  size_t used_{0};
+  uint32_t records_{0};
+  uint32_t dropped_{0};
+  uint32_t origin_ms_{0};
+  uint32_t first_ms_{0};
+  uint32_t last_ms_{0};
+};
+
+// Walks a capture made by UartTrace::export_capture(). Frames point into the
+// capture, which must outlive the records.
+class UartTraceReader {
+ public:
+  UartTraceReader(const uint8_t *data, size_t size);
+
+  // False for a missing or unknown header.
+  bool valid() const { return this->valid_; }
+  uint32_t origin_ms() const { return this->origin_ms_; }
+  uint32_t dropped() const { return this->dropped_; }
+  // False at the end of the capture or on a truncated record; see truncated().
+  bool next(TraceRecord &record);
+  bool truncated() const { return this->truncated_; }
+
+ protected:
+  const uint8_t *data_;
+  size_t size_;
+  size_t offset_{UART_TRACE_HEADER_SIZE};
+  bool valid_{false};
+  bool truncated_{false};
+  uint32_t origin_ms_{0};
+  uint32_t dropped_{0};
+  uint32_t at_ms_{0};
+};
+
+const char *trace_direction_name(TraceDirection direction);
+
+}  // namespace arc_bridge
+}  // namespace esphome
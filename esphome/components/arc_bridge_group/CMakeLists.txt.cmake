@@ -1,6 +1,6 @@
 esphome_component(
   NAME arc_bridge_group
-  SRCS "arc_bridge_group_cover.cpp"
-  HDRS "arc_bridge_group_cover.h"
+  SRCS "arc_bridge_group_cover.cpp" "group_aggregate.cpp"
+  HDRS "arc_bridge_group_cover.h" "group_aggregate.h"
   REQUIRES "arc_bridge;cover"
 )
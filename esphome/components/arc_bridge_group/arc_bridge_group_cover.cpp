@@ -1,7 +1,9 @@
 #include "arc_bridge_group_cover.h"
 
+#include "esphome/core/hal.h"
 #include "esphome/core/log.h"
 
+#include <algorithm>
 #include <cmath>
 
 namespace esphome {
@@ -10,20 +12,36 @@ namespace arc_bridge_group {
 static const char *const TAG = "arc_bridge_group";
 
 void ARCBridgeGroupCover::setup() {
-  for (auto *member : this->members_) {
+  this->aggregate_.reset(this->members_.size());
+  for (size_t i = 0; i < this->members_.size(); i++) {
+    auto *member = this->members_[i];
     if (member == nullptr) {
       continue;
     }
-    member->add_on_state_callback([this]() { this->recompute_state_(); });
+    member->add_on_state_callback([this, i]() { this->on_member_state_(i); });
+    this->on_member_state_(i);
+    auto *bridge = member->get_bridge();
+    if (bridge != nullptr &&
+        std::find(this->bridges_.begin(), this->bridges_.end(), bridge) == this->bridges_.end()) {
+      this->bridges_.push_back(bridge);
+    }
+  }
+
+  for (auto *bridge : this->bridges_) {
+    bridge->add_on_motion_batch_callback(
+        [this, bridge](const arc_bridge::MotionBatchStatus &status) {
+          this->on_motion_batch_(bridge, status);
+        });
   }
 
-  this->recompute_state_();
+  this->publish_group_state_();
   this->disable_loop();
 }
 
 void ARCBridgeGroupCover::dump_config() {
   LOG_COVER("", "ARC Bridge Group Cover", this);
   ESP_LOGCONFIG(TAG, "  Members: %u", static_cast<unsigned>(this->members_.size()));
+  ESP_LOGCONFIG(TAG, "  Min publish interval: %" PRIu32 " ms", this->min_publish_interval_ms_);
 }
 
 cover::CoverTraits ARCBridgeGroupCover::get_traits() {
@@ -35,49 +53,100 @@ cover::CoverTraits ARCBridgeGroupCover::get_traits() {
 }
 
 void ARCBridgeGroupCover::control(const cover::CoverCall &call) {
-  for (auto *member : this->members_) {
-    if (member == nullptr) {
-      continue;
+  const bool stop = call.get_stop();
+  if (!stop && !call.get_position().has_value()) {
+    return;
+  }
+
+  // One batch per bridge: a single poll purge and every member queued back to
+  // back in configuration order, instead of one cover call per member.
+  for (auto *bridge : this->bridges_) {
+    if (!bridge->is_startup_guard_cleared()) {
+      ESP_LOGI(TAG, "Group command held until the startup guard clears");
     }
 
-    auto member_call = member->make_call();
-    if (call.get_stop()) {
-      member_call.set_stop(true);
-    } else if (call.get_position().has_value()) {
-      member_call.set_position(*call.get_position());
+    uint32_t batch_id;
+    if (stop) {
+      std::vector<arc_bridge::BlindId> ids;
+      for (auto *member : this->members_) {
+        if (member != nullptr && member->get_bridge() == bridge) {
+          ids.push_back(member->get_blind_id());
+        }
+      }
+      batch_id = bridge->send_stop_batch(ids);
     } else {
-      continue;
+      const float position = *call.get_position();
+      std::vector<arc_bridge::MotionBatchTarget> targets;
+      for (auto *member : this->members_) {
+        if (member != nullptr && member->get_bridge() == bridge) {
+          targets.push_back({member->get_blind_id(), member->arc_percent_for(position)});
+        }
+      }
+      batch_id = bridge->send_move_batch(targets);
+    }
+
+    if (bridge->is_motion_batch_pending(batch_id)) {
+      this->pending_batches_.push_back({bridge, batch_id});
     }
-    member_call.perform();
   }
 }
 
-void ARCBridgeGroupCover::recompute_state_() {
-  float position_total = 0.0f;
-  size_t positioned_members = 0;
-  bool any_opening = false;
-  bool any_closing = false;
+void ARCBridgeGroupCover::on_motion_batch_(arc_bridge::ARCBridgeComponent *bridge,
+                                           const arc_bridge::MotionBatchStatus &status) {
+  auto it = std::find_if(this->pending_batches_.begin(), this->pending_batches_.end(),
+                         [bridge, &status](const PendingBatch &pending) {
+                           return pending.bridge == bridge && pending.id == status.id;
+                         });
+  if (it == this->pending_batches_.end()) {
+    return;
+  }
+  this->pending_batches_.erase(it);
 
-  for (auto *member : this->members_) {
-    if (member == nullptr) {
-      continue;
-    }
+  const arc_bridge::MotionBatchOutcome outcome = status.outcome();
+  if (outcome == arc_bridge::MotionBatchOutcome::ALL_ACKNOWLEDGED) {
+    ESP_LOGD(TAG, "Group command acknowledged by all %u members",
+             static_cast<unsigned>(status.total));
+  } else {
+    ESP_LOGW(TAG, "Group command %s: %u of %u members acknowledged",
+             arc_bridge::motion_batch_outcome_name(outcome),
+             static_cast<unsigned>(status.acknowledged), static_cast<unsigned>(status.total));
+  }
+}
 
-    if (member->current_operation == cover::COVER_OPERATION_OPENING) {
-      any_opening = true;
-    } else if (member->current_operation == cover::COVER_OPERATION_CLOSING) {
-      any_closing = true;
-    }
+void ARCBridgeGroupCover::on_member_state_(size_t index) {
+  const auto *member = this->members_[index];
+  MemberSnapshot snapshot;
+  snapshot.positioned = member->has_state() && !std::isnan(member->position);
+  snapshot.position = snapshot.positioned ? member->position : 0.0f;
+  if (member->current_operation == cover::COVER_OPERATION_OPENING) {
+    snapshot.operation = GroupOperation::OPENING;
+  } else if (member->current_operation == cover::COVER_OPERATION_CLOSING) {
+    snapshot.operation = GroupOperation::CLOSING;
+  }
 
-    if (!member->has_state() || std::isnan(member->position)) {
-      continue;
-    }
+  if (this->aggregate_.update(index, snapshot) && !this->publish_pending_) {
+    this->publish_pending_ = true;
+    this->enable_loop();
+  }
+}
 
-    position_total += member->position;
-    positioned_members++;
+void ARCBridgeGroupCover::loop() {
+  if (!this->publish_pending_) {
+    this->disable_loop();
+    return;
   }
+  if (millis() - this->last_publish_ms_ < this->min_publish_interval_ms_) {
+    return;
+  }
+  this->publish_group_state_();
+  this->disable_loop();
+}
 
-  if (positioned_members == 0) {
+void ARCBridgeGroupCover::publish_group_state_() {
+  this->publish_pending_ = false;
+  this->last_publish_ms_ = millis();
+
+  if (this->aggregate_.positioned() == 0) {
     this->status_set_warning();
     this->current_operation = cover::COVER_OPERATION_IDLE;
     this->position = NAN;
@@ -88,14 +157,19 @@ void ARCBridgeGroupCover::recompute_state_() {
 
   this->status_clear_warning();
   this->set_has_state(true);
-  this->position = position_total / static_cast<float>(positioned_members);
-
-  if (any_opening && !any_closing) {
-    this->current_operation = cover::COVER_OPERATION_OPENING;
-  } else if (any_closing && !any_opening) {
-    this->current_operation = cover::COVER_OPERATION_CLOSING;
-  } else {
-    this->current_operation = cover::COVER_OPERATION_IDLE;
+  this->position = this->aggregate_.position();
+
+  switch (this->aggregate_.operation()) {
+    case GroupOperation::OPENING:
+      this->current_operation = cover::COVER_OPERATION_OPENING;
+      break;
+    case GroupOperation::CLOSING:
+      this->current_operation = cover::COVER_OPERATION_CLOSING;
+      break;
+    case GroupOperation::IDLE:
+    default:
+      this->current_operation = cover::COVER_OPERATION_IDLE;
+      break;
   }
 
   this->publish_state();
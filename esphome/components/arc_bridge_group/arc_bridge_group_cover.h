@@ -1,9 +1,12 @@
 #pragma once
 
 #include "esphome/core/component.h"
+#include "esphome/components/arc_bridge/arc_bridge.h"
 #include "esphome/components/arc_bridge/arc_cover.h"
 #include "esphome/components/cover/cover.h"
 
+#include "group_aggregate.h"
+
 #include <vector>
 
 namespace esphome {
@@ -12,16 +15,39 @@ namespace arc_bridge_group {
 class ARCBridgeGroupCover : public cover::Cover, public Component {
  public:
   void add_member(arc_bridge::ARCCover *member) { this->members_.push_back(member); }
+  // Member reports within this window of the last group publish are folded
+  // into one publish; 0 still publishes at most once per loop.
+  void set_min_publish_interval(uint32_t interval_ms) {
+    this->min_publish_interval_ms_ = interval_ms;
+  }
 
   void setup() override;
+  void loop() override;
   void dump_config() override;
   cover::CoverTraits get_traits() override;
 
  protected:
   void control(const cover::CoverCall &call) override;
-  void recompute_state_();
+  // Folds member `index`'s current state into the aggregate and schedules a
+  // publish if the group changed.
+  void on_member_state_(size_t index);
+  void publish_group_state_();
+  void on_motion_batch_(arc_bridge::ARCBridgeComponent *bridge,
+                        const arc_bridge::MotionBatchStatus &status);
+
+  struct PendingBatch {
+    arc_bridge::ARCBridgeComponent *bridge;
+    uint32_t id;
+  };
 
   std::vector<arc_bridge::ARCCover *> members_;
+  // Members normally share one bridge; each bridge gets one batch per call.
+  std::vector<arc_bridge::ARCBridgeComponent *> bridges_;
+  std::vector<PendingBatch> pending_batches_;
+  GroupAggregate aggregate_;
+  uint32_t min_publish_interval_ms_{0};
+  uint32_t last_publish_ms_{0};
+  bool publish_pending_{false};
 };
 
 }  // namespace arc_bridge_group
@@ -10,6 +10,7 @@ AUTO_LOAD = ["cover"]
 DEPENDENCIES = ["arc_bridge"]
 
 CONF_MEMBERS = "members"
+CONF_MIN_PUBLISH_INTERVAL = "min_publish_interval"
 
 ARCBridgeGroupCover = arc_bridge_group_ns.class_("ARCBridgeGroupCover", cover.Cover, cg.Component)
 
@@ -28,6 +29,9 @@ CONFIG_SCHEMA = (
     .extend(
         {
             cv.Required(CONF_MEMBERS): validate_members,
+            cv.Optional(
+                CONF_MIN_PUBLISH_INTERVAL, default="250ms"
+            ): cv.positive_time_period_milliseconds,
         }
     )
     .extend(cv.COMPONENT_SCHEMA)
@@ -42,3 +46,6 @@ async def to_code(config):
     for member_id in config[CONF_MEMBERS]:
         member = await cg.get_variable(member_id)
         cg.add(var.add_member(member))
+
+    min_publish_interval = config[CONF_MIN_PUBLISH_INTERVAL]
+    cg.add(var.set_min_publish_interval(min_publish_interval.total_milliseconds))
@@ -0,0 +1,42 @@
+#include "group_aggregate.h"
+
+namespace esphome {
+namespace arc_bridge_group {
+
+void GroupAggregate::reset(size_t members) {
+  this->members_.assign(members, MemberSnapshot{});
+  this->position_total_ = 0.0;
+  this->positioned_ = 0;
+  this->opening_ = 0;
+  this->closing_ = 0;
+}
+
+bool GroupAggregate::update(size_t index, const MemberSnapshot &snapshot) {
+  if (index >= this->members_.size() || this->members_[index] == snapshot) {
+    return false;
+  }
+  this->count_(this->members_[index], false);
+  this->members_[index] = snapshot;
+  this->count_(snapshot, true);
+  if (this->positioned_ == 0) {
+    // Nothing left to average; drop any accumulated rounding error.
+    this->position_total_ = 0.0;
+  }
+  return true;
+}
+
+void GroupAggregate::count_(const MemberSnapshot &snapshot, bool add) {
+  if (snapshot.positioned) {
+    const double position = static_cast<double>(snapshot.position);
+    this->position_total_ += add ? position : -position;
+    add ? this->positioned_++ : this->positioned_--;
+  }
+  if (snapshot.operation == GroupOperation::OPENING) {
+    add ? this->opening_++ : this->opening_--;
+  } else if (snapshot.operation == GroupOperation::CLOSING) {
+    add ? this->closing_++ : this->closing_--;
+  }
+}
+
+}  // namespace arc_bridge_group
+}  // namespace esphome
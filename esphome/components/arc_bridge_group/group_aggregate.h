@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace esphome {
+namespace arc_bridge_group {
+
+enum class GroupOperation : uint8_t {
+  IDLE = 0,
+  OPENING = 1,
+  CLOSING = 2,
+};
+
+// What one member last reported.
+struct MemberSnapshot {
+  // The member has a state and a position.
+  bool positioned{false};
+  float position{0.0f};
+  GroupOperation operation{GroupOperation::IDLE};
+
+  bool operator==(const MemberSnapshot &other) const {
+    return this->positioned == other.positioned && this->operation == other.operation &&
+           (!this->positioned || this->position == other.position);
+  }
+  bool operator!=(const MemberSnapshot &other) const { return !(*this == other); }
+};
+
+// Group position and operation kept as running sums and counts, so a member
+// report costs O(1) instead of a walk over every member.
+class GroupAggregate {
+ public:
+  // Sizes the aggregate for `members` members, all unpositioned and idle.
+  void reset(size_t members);
+  // Replaces the snapshot of member `index`; returns true if it changed.
+  bool update(size_t index, const MemberSnapshot &snapshot);
+
+  size_t size() const { return this->members_.size(); }
+  size_t positioned() const { return this->positioned_; }
+  // Mean position of the positioned members; only valid when positioned() > 0.
+  float position() const {
+    return static_cast<float>(this->position_total_ / static_cast<double>(this->positioned_));
+  }
+  // Opening or closing only when every moving member agrees.
+  GroupOperation operation() const {
+    if (this->opening_ > 0 && this->closing_ == 0) {
+      return GroupOperation::OPENING;
+    }
+    if (this->closing_ > 0 && this->opening_ == 0) {
+      return GroupOperation::CLOSING;
+    }
+    return GroupOperation::IDLE;
+  }
+
+ protected:
+  void count_(const MemberSnapshot &snapshot, bool add);
+
+  std::vector<MemberSnapshot> members_;
+  // Double keeps the drift from repeated add/subtract far below a publish step.
+  double position_total_{0.0};
+  size_t positioned_{0};
+  size_t opening_{0};
+  size_t closing_{0};
+};
+
+}  // namespace arc_bridge_group
+}  // namespace esphome
@@ -0,0 +1,59 @@
+#include "alloc_tracker.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+esphome::arc_bridge::testing::AllocationStats g_stats;
+
+void *counted_allocate(std::size_t size) {
+  g_stats.allocations++;
+  g_stats.bytes += size;
+  if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void counted_free(void *ptr) {
+  if (ptr != nullptr) {
+    g_stats.deallocations++;
+  }
+  std::free(ptr);
+}
+
+}  // namespace
+
+namespace esphome {
+namespace arc_bridge {
+namespace testing {
+
+AllocationStats allocation_stats() { return g_stats; }
+
+AllocationStats AllocationScope::delta() const {
+  const AllocationStats now = allocation_stats();
+  return {now.allocations - this->start_.allocations,
+          now.deallocations - this->start_.deallocations, now.bytes - this->start_.bytes};
+}
+
+}  // namespace testing
+}  // namespace arc_bridge
+}  // namespace esphome
+
+// Keep the replacements out of line so the compiler does not pair an inlined
+// malloc/free against operator new/delete and warn about a mismatch.
+__attribute__((noinline)) void *operator new(std::size_t size) { return counted_allocate(size); }
+
+__attribute__((noinline)) void *operator new[](std::size_t size) { return counted_allocate(size); }
+
+__attribute__((noinline)) void operator delete(void *ptr) noexcept { counted_free(ptr); }
+
+__attribute__((noinline)) void operator delete[](void *ptr) noexcept { counted_free(ptr); }
+
+__attribute__((noinline)) void operator delete(void *ptr, std::size_t) noexcept { counted_free(ptr); }
+
+__attribute__((noinline)) void operator delete[](void *ptr, std::size_t) noexcept {
+  counted_free(ptr);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+// Test-only heap accounting. alloc_tracker.cpp replaces the global operator
+// new/delete for every host test binary it is linked into, so any test can
+// assert how many allocations a region of code performs.
+
+namespace esphome {
+namespace arc_bridge {
+namespace testing {
+
+struct AllocationStats {
+  uint64_t allocations{0};
+  uint64_t deallocations{0};
+  uint64_t bytes{0};
+};
+
+// Totals since the process started.
+AllocationStats allocation_stats();
+
+// Captures the totals on construction and reports the heap activity since.
+class AllocationScope {
+ public:
+  AllocationScope() : start_(allocation_stats()) {}
+
+  AllocationStats delta() const;
+  uint64_t allocations() const { return this->delta().allocations; }
+  uint64_t deallocations() const { return this->delta().deallocations; }
+  uint64_t bytes() const { return this->delta().bytes; }
+
+ private:
+  AllocationStats start_;
+};
+
+}  // namespace testing
+}  // namespace arc_bridge
+}  // namespace esphome
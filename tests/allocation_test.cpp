@@ -0,0 +1,168 @@
+#include "alloc_tracker.h"
+#include "delivery.h"
+#include "frame_extractor.h"
+#include "protocol.h"
+#include "tx_queue.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+using esphome::arc_bridge::BlindId;
+using esphome::arc_bridge::DeliveryExpectation;
+using esphome::arc_bridge::FrameExtractor;
+using esphome::arc_bridge::ParsedFrame;
+using esphome::arc_bridge::TxPacingClass;
+using esphome::arc_bridge::TxPriorityClass;
+using esphome::arc_bridge::TxPushResult;
+using esphome::arc_bridge::TxQueueItem;
+using esphome::arc_bridge::TxScheduler;
+using esphome::arc_bridge::build_command_frame;
+using esphome::arc_bridge::build_raw_frame;
+using esphome::arc_bridge::frame_confirms_delivery;
+using esphome::arc_bridge::parse_arc_frame;
+using esphome::arc_bridge::testing::AllocationScope;
+
+namespace {
+
+constexpr BlindId QJ0 = BlindId::from_text("QJ0");
+
+// Enough passes that a per-frame allocation cannot hide behind warm-up.
+constexpr int ROUNDS = 200;
+
+// Messages stay as C strings so building one never shows up in a measured scope.
+void require(bool condition, const char *message) {
+  if (!condition) {
+    std::cerr << "FAIL: " << message << std::endl;
+    std::exit(1);
+  }
+}
+
+void require_no_allocations(const AllocationScope &scope, const char *region) {
+  if (scope.allocations() != 0) {
+    std::cerr << "FAIL: " << region << " allocated " << scope.allocations() << " times ("
+              << scope.bytes() << " bytes)" << std::endl;
+    std::exit(1);
+  }
+}
+
+// Mirrors ARCBridgeComponent::send_move() up to the point the item is queued.
+bool queue_move(TxScheduler &scheduler, BlindId id, unsigned percent, uint32_t tracking_id,
+                uint32_t now) {
+  char move_token[5];
+  snprintf(move_token, sizeof(move_token), "m%03u", percent);
+  const std::string_view token(move_token);
+  TxQueueItem item{{}, TxPacingClass::MOTION, false, id, DeliveryExpectation::BLIND_REPLY,
+                   true, tracking_id, token, "m"};
+  if (!build_command_frame(item.frame, id, 'm', token.substr(1))) {
+    return false;
+  }
+  return scheduler.push(item, TxPriorityClass::MOTION, now) == TxPushResult::QUEUED;
+}
+
+void test_tracker_counts_exact_allocations() {
+  AllocationScope scope;
+  {
+    std::string heap_text(64, 'x');
+    require(heap_text.size() == 64, "heap-backed string should be constructed");
+  }
+  require(scope.allocations() == 1, "one heap-backed string should count one allocation");
+  require(scope.deallocations() == 1, "destroying the string should count one deallocation");
+  require(scope.bytes() >= 64, "allocated bytes should cover the requested size");
+
+  AllocationScope empty;
+  require(empty.allocations() == 0 && empty.bytes() == 0,
+          "a fresh scope should start with no allocations");
+}
+
+void test_rx_round_trip_does_not_allocate() {
+  static const char STREAM[] =
+      "\r\n!QJ0m050,R9C;!QJ0<09b00;!QJ0<55b00,R60;!QJ0r050b000,R5F;"
+      "!USZpVc1180,RA6;!USZvA21;!USZpP03;!USZEnl;noise!KHNA;";
+  const TxQueueItem pending{"!QJ0m050;", TxPacingClass::MOTION, false, QJ0,
+                            DeliveryExpectation::BLIND_REPLY, true, 1, "m050", "m"};
+  FrameExtractor extractor;
+  char frame[FrameExtractor::CAPACITY];
+  size_t frames = 0;
+  size_t acknowledged = 0;
+
+  AllocationScope scope;
+  for (int round = 0; round < ROUNDS; round++) {
+    for (size_t i = 0; i + 1 < sizeof(STREAM); i++) {
+      extractor.push(STREAM[i]);
+      const size_t length = extractor.next_frame(frame, sizeof(frame));
+      if (length == 0) {
+        continue;
+      }
+      const ParsedFrame parsed = parse_arc_frame(std::string_view(frame, length));
+      frames += parsed.valid;
+      acknowledged += frame_confirms_delivery(
+          parsed, pending.blind_id, pending.delivery_expectation,
+          pending.expected_ack_token.view(), pending.expected_ack_prefix.view());
+    }
+  }
+  require_no_allocations(scope, "RX -> extract -> parse -> delivery acknowledgement");
+
+  require(frames == ROUNDS * 9u, "every frame in the stream should be parsed");
+  // The move echo and the three position replies from QJ0 all qualify.
+  require(acknowledged == ROUNDS * 4u, "replies from the moving blind should acknowledge delivery");
+}
+
+void test_send_move_queue_dequeue_does_not_allocate() {
+  TxScheduler scheduler;
+  uint32_t now = 0;
+  size_t sent = 0;
+  size_t confirmed = 0;
+
+  AllocationScope scope;
+  for (int round = 0; round < ROUNDS; round++) {
+    // Background polls are queued, then dropped when motion arrives.
+    TxQueueItem poll{{}, TxPacingClass::STANDARD, true, QJ0, DeliveryExpectation::NONE,
+                     false, 0, "", ""};
+    build_command_frame(poll.frame, QJ0, 'p', "Vc?");
+    scheduler.push(poll, TxPriorityClass::BACKGROUND_POLL, now);
+    scheduler.drop_polls();
+
+    require(queue_move(scheduler, QJ0, static_cast<unsigned>(round % 101),
+                       static_cast<uint32_t>(round + 1), now),
+            "move command should be queued");
+    TxQueueItem raw;
+    build_raw_frame(raw.frame, "QJ0r?");
+    scheduler.push(raw, TxPriorityClass::MOTION, now);
+
+    while (!scheduler.empty()) {
+      now += 200;
+      const size_t index = scheduler.select(now);
+      const TxQueueItem &item = scheduler.queue()[index];
+      sent += item.frame.size() > 0;
+      if (item.delivery_expectation != DeliveryExpectation::NONE) {
+        // The blind echoes the command body back with its address.
+        char echo[FrameExtractor::CAPACITY];
+        const int length = snprintf(echo, sizeof(echo), "%.*s,R9C;",
+                                    static_cast<int>(item.frame.size() - 1), item.frame.c_str());
+        const ParsedFrame parsed = parse_arc_frame(std::string_view(echo, length));
+        confirmed += frame_confirms_delivery(parsed, item.blind_id,
+                                             item.delivery_expectation,
+                                             item.expected_ack_token.view(),
+                                             item.expected_ack_prefix.view());
+      }
+      scheduler.complete(index, now);
+    }
+  }
+  require_no_allocations(scope, "send_move -> queue -> dequeue");
+
+  require(sent == ROUNDS * 2u, "move and raw frames should both be dequeued");
+  require(confirmed == ROUNDS * 1u, "every move echo should confirm its delivery");
+}
+
+}  // namespace
+
+int main() {
+  test_tracker_counts_exact_allocations();
+  test_rx_round_trip_does_not_allocate();
+  test_send_move_queue_dequeue_does_not_allocate();
+  std::cout << "allocation tests passed" << std::endl;
+  return 0;
+}
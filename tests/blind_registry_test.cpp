@@ -0,0 +1,119 @@
+#include "alloc_tracker.h"
+#include "blind_id.h"
+#include "blind_registry.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using esphome::arc_bridge::BlindId;
+using esphome::arc_bridge::BlindRegistry;
+using esphome::arc_bridge::testing::AllocationScope;
+
+namespace {
+
+void require(bool condition, const std::string &message) {
+  if (!condition) {
+    std::cerr << "FAIL: " << message << std::endl;
+    std::exit(1);
+  }
+}
+
+static_assert(BlindId::from_text("USZ").packed() == ('U' | 'S' << 8 | 'Z' << 16),
+              "blind ids pack little-endian");
+static_assert(!BlindId::from_text("US").valid() && !BlindId::from_text("USZA").valid(),
+              "only three character ids are valid");
+
+void test_blind_id_round_trip() {
+  const BlindId id = BlindId::from_text("QJ0");
+  require(id.valid(), "a three character id should be valid");
+  require(std::string(id.text().c_str()) == "QJ0", "text() should spell the id");
+  require(id.str() == "QJ0", "str() should spell the id");
+  require(id == BlindId::from_text("QJ0") && id != BlindId::from_text("QJ1"),
+          "ids should compare by value");
+  require(!BlindId::from_text("").valid() && BlindId().str().empty(),
+          "the default id should be invalid and empty");
+  require(!BlindId::from_text(std::string("Q\0J", 3)).valid(), "ids cannot contain NUL");
+}
+
+void test_registry_assigns_dense_indices() {
+  BlindRegistry registry;
+  require(registry.find(BlindId::from_text("USZ")) == BlindRegistry::NOT_FOUND,
+          "an empty registry should find nothing");
+
+  const size_t usz = registry.add(BlindId::from_text("USZ"));
+  const size_t khn = registry.add(BlindId::from_text("KHN"));
+  const size_t nom = registry.add(BlindId::from_text("NOM"));
+  require(usz == 0 && khn == 1 && nom == 2, "indices should follow registration order");
+  require(registry.add(BlindId::from_text("KHN")) == khn,
+          "adding a known id should return its existing index");
+  require(registry.add(BlindId()) == BlindRegistry::NOT_FOUND,
+          "invalid ids should not be registered");
+  require(registry.size() == 3, "duplicates and invalid ids should not grow the registry");
+
+  require(registry.find(BlindId::from_text("USZ")) == usz &&
+              registry.find(BlindId::from_text("KHN")) == khn &&
+              registry.find(BlindId::from_text("NOM")) == nom,
+          "every registered id should be found at its index");
+  require(registry.find(BlindId::from_text("ZZZ")) == BlindRegistry::NOT_FOUND,
+          "unregistered ids should not be found");
+  require(registry.id_at(khn) == BlindId::from_text("KHN"), "id_at should invert find");
+}
+
+void test_generated_hash_needs_no_runtime_search() {
+  // Parameters cover.py emits for this set of blinds.
+  static const char *const IDS[] = {"USZ", "WRK", "ZXE", "NOM", "OVJ", "TXY", "MLT", "KHN", "QJ0"};
+  BlindRegistry registry;
+  registry.set_hash(0x988B5A61, 5);
+  for (const char *id : IDS) {
+    registry.add(BlindId::from_text(id));
+  }
+  require(registry.multiplier() == 0x988B5A61 && registry.bits() == 5,
+          "the codegen hash should place every configured blind without a rebuild");
+  for (size_t i = 0; i < sizeof(IDS) / sizeof(IDS[0]); i++) {
+    require(registry.find(BlindId::from_text(IDS[i])) == i, std::string("lookup ") + IDS[i]);
+  }
+}
+
+void test_unplanned_ids_rebuild_the_table() {
+  BlindRegistry registry;
+  registry.set_hash(0x988B5A61, 5);
+  std::vector<BlindId> ids;
+  for (int i = 0; i < 48; i++) {
+    char text[4];
+    snprintf(text, sizeof(text), "B%02d", i);
+    ids.push_back(BlindId::from_text(text));
+    require(registry.add(ids.back()) == static_cast<size_t>(i),
+            "ids outside the generated set should still be registered");
+  }
+  require((static_cast<size_t>(1) << registry.bits()) >= ids.size() * 2,
+          "the table should grow to keep the load factor at one half");
+  for (size_t i = 0; i < ids.size(); i++) {
+    require(registry.find(ids[i]) == i, "indices should survive a rebuild");
+  }
+
+  AllocationScope scope;
+  size_t misses = 0;
+  for (char a = 'A'; a <= 'Z'; a++) {
+    for (char b = '0'; b <= '9'; b++) {
+      const char text[] = {'C', a, b, '\0'};
+      misses += registry.find(BlindId::from_text(text)) == BlindRegistry::NOT_FOUND;
+    }
+  }
+  const uint64_t allocations = scope.allocations();
+  require(allocations == 0, "lookups should not allocate");
+  require(misses == 26 * 10, "unregistered ids should never alias a registered blind");
+}
+
+}  // namespace
+
+int main() {
+  test_blind_id_round_trip();
+  test_registry_assigns_dense_indices();
+  test_generated_hash_needs_no_runtime_search();
+  test_unplanned_ids_rebuild_the_table();
+  std::cout << "blind registry tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,407 @@
+#include "bridge_engine.h"
+#include "virtual_hub.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using esphome::arc_bridge::BlindId;
+using esphome::arc_bridge::BlindSnapshot;
+using esphome::arc_bridge::BridgeClock;
+using esphome::arc_bridge::BridgeEngine;
+using esphome::arc_bridge::BridgeEventSink;
+using esphome::arc_bridge::BridgeStorage;
+using esphome::arc_bridge::BridgeTransport;
+using esphome::arc_bridge::CommandLatency;
+using esphome::arc_bridge::MotionBatchStatus;
+using esphome::arc_bridge::MotionBatchTarget;
+using esphome::arc_bridge::SensorKind;
+using esphome::arc_bridge::TravelModel;
+using esphome::arc_bridge::TxPacingClass;
+using esphome::arc_bridge::testing::VirtualBlindConfig;
+using esphome::arc_bridge::testing::VirtualHub;
+
+namespace {
+
+void require(bool condition, const std::string &message) {
+  if (!condition) {
+    std::cerr << "FAIL: " << message << std::endl;
+    std::exit(1);
+  }
+}
+
+// The engine wired to a virtual hub on a virtual clock, recording every event
+// the ESPHome adapter would turn into an entity update.
+class HostBridge : public BridgeClock,
+                   public BridgeTransport,
+                   public BridgeEventSink,
+                   public BridgeStorage {
+ public:
+  struct CoverState {
+    int position{-1};
+    bool in_motion{false};
+    bool available{true};
+    int motion_target{-1};
+    uint32_t motion_timeout_ms{0};
+    uint32_t motions{0};
+    uint32_t stops{0};
+  };
+
+  explicit HostBridge(VirtualHub &hub) : hub(hub) {
+    this->engine.set_clock(this);
+    this->engine.set_transport(this);
+    this->engine.set_event_sink(this);
+    this->engine.set_storage(this);
+  }
+
+  void run_until(uint32_t until_ms) {
+    while (this->now < until_ms) {
+      this->now += 1;
+      this->hub.advance_to(this->now);
+      this->engine.run();
+    }
+  }
+  void run_for(uint32_t delta_ms) { this->run_until(this->now + delta_ms); }
+
+  CoverState &cover(const char *id) { return this->covers[this->index_of(id)]; }
+  size_t index_of(const char *id) const {
+    const BlindId blind_id = BlindId::from_text(id);
+    for (size_t i = 0; i < this->engine.blind_count(); i++) {
+      if (this->engine.blind_id_at(i) == blind_id) {
+        return i;
+      }
+    }
+    return SIZE_MAX;
+  }
+
+  uint32_t now_ms() const override { return this->now; }
+
+  size_t receive(char *buffer, size_t size) override {
+    this->rx += this->hub.read();
+    const size_t count = std::min(size, this->rx.size());
+    this->rx.copy(buffer, count);
+    this->rx.erase(0, count);
+    return count;
+  }
+  void transmit(std::string_view bytes) override {
+    this->hub.write(bytes);
+    this->frames_sent++;
+  }
+
+  void on_sensor(size_t blind, SensorKind kind, float value) override {
+    this->sensors[{blind, kind}] = value;
+  }
+  void on_text_sensor(size_t blind, SensorKind kind, std::string_view value) override {
+    this->text_sensors[{blind, kind}] = std::string(value);
+  }
+  void on_cover_position(size_t blind, int position, bool in_motion) override {
+    this->covers[blind].position = position;
+    this->covers[blind].in_motion = in_motion;
+  }
+  void on_cover_available(size_t blind, bool available) override {
+    this->covers[blind].available = available;
+  }
+  void on_cover_motion(size_t blind, int target, uint32_t /*full_travel_ms*/,
+                       uint32_t motion_timeout_ms) override {
+    this->covers[blind].motion_target = target;
+    this->covers[blind].motion_timeout_ms = motion_timeout_ms;
+    this->covers[blind].motions++;
+  }
+  void on_cover_stop(size_t blind) override { this->covers[blind].stops++; }
+  void on_motion_batch(const MotionBatchStatus &status) override {
+    this->batches.push_back(status);
+  }
+
+  bool load_travel_model(size_t blind, BlindId /*id*/, TravelModel &model) override {
+    auto it = this->travel.find(blind);
+    if (it == this->travel.end()) {
+      return false;
+    }
+    model = it->second;
+    return true;
+  }
+  void save_travel_model(size_t blind, const TravelModel &model) override {
+    this->travel[blind] = model;
+  }
+  bool load_snapshot(size_t blind, BlindId /*id*/, BlindSnapshot &snapshot) override {
+    auto it = this->snapshots.find(blind);
+    if (it == this->snapshots.end()) {
+      return false;
+    }
+    snapshot = it->second;
+    return true;
+  }
+  void save_snapshot(size_t blind, const BlindSnapshot &snapshot) override {
+    this->snapshots[blind] = snapshot;
+  }
+
+  VirtualHub &hub;
+  BridgeEngine engine;
+  uint32_t now{0};
+  std::string rx;
+  uint32_t frames_sent{0};
+  std::map<size_t, CoverState> covers;
+  std::map<std::pair<size_t, SensorKind>, float> sensors;
+  std::map<std::pair<size_t, SensorKind>, std::string> text_sensors;
+  std::vector<MotionBatchStatus> batches;
+  std::map<size_t, TravelModel> travel;
+  std::map<size_t, BlindSnapshot> snapshots;
+};
+
+void test_startup_fills_every_cover() {
+  VirtualHub hub;
+  const char *ids[] = {"AAA", "BBB", "CCC"};
+  for (size_t i = 0; i < 3; i++) {
+    VirtualBlindConfig config;
+    config.position = static_cast<uint8_t>(20 * (i + 1));
+    hub.add_blind(ids[i], config);
+  }
+  HostBridge bridge(hub);
+  for (const char *id : ids) {
+    require(bridge.engine.add_cover(id) != SIZE_MAX, "valid ids should register");
+    bridge.engine.map_sensor(id, SensorKind::LINK_QUALITY);
+    bridge.engine.map_sensor(id, SensorKind::STATUS);
+  }
+  require(bridge.engine.add_cover("bad id") == SIZE_MAX, "invalid ids should be rejected");
+
+  bridge.engine.start();
+  bridge.run_for(400);
+  require(!bridge.engine.is_startup_guard_cleared(), "the guard should hold while settling");
+  bridge.run_for(1000);
+  require(bridge.engine.is_startup_guard_cleared() && bridge.engine.get_startup_guard_ms() < 1000,
+          "the probe answer should clear the guard well before its maximum");
+
+  bridge.run_for(5000);
+  for (size_t i = 0; i < 3; i++) {
+    require(bridge.cover(ids[i]).position == static_cast<int>(20 * (i + 1)),
+            "the startup sweep should publish every cover's position");
+    const size_t index = bridge.index_of(ids[i]);
+    require(bridge.text_sensors[{index, SensorKind::STATUS}] == "Online",
+            "mapped status sensors should report Online");
+    require(bridge.sensors.count({index, SensorKind::LINK_QUALITY}) == 1,
+            "mapped link quality sensors should publish the RSSI");
+    require(bridge.sensors.count({index, SensorKind::VOLTAGE}) == 0,
+            "unmapped sensor kinds should never be published");
+  }
+  require(bridge.engine.get_time_to_full_state_ms() > 0, "full state should be reached");
+}
+
+void test_moves_are_acknowledged_and_tracked() {
+  VirtualHub hub;
+  VirtualBlindConfig config;
+  config.travel_ms = 4000;
+  hub.add_blind("QJ0", config);
+  HostBridge bridge(hub);
+  bridge.engine.add_cover("QJ0");
+  bridge.engine.set_motion_timeout(30000);
+  bridge.engine.start();
+  bridge.run_for(3000);
+
+  bridge.engine.send_move(BlindId::from_text("QJ0"), 50);
+  bridge.run_for(500);
+  HostBridge::CoverState &cover = bridge.cover("QJ0");
+  require(cover.motions == 1 && cover.motion_target == 50,
+          "the echoed move should reach the cover");
+  require(cover.motion_timeout_ms == 30000,
+          "the cover should get the configured motion timeout while travel is unlearned");
+  require(bridge.engine.is_blind_moving(BlindId::from_text("QJ0")), "the blind should be moving");
+
+  bridge.run_for(6000);
+  require(cover.position == 50 && !cover.in_motion && hub.position("QJ0") == 50,
+          "the cover should end on the position the blind arrived at");
+  require(!bridge.engine.is_blind_moving(BlindId::from_text("QJ0")),
+          "motion tracking should end on arrival");
+
+  bridge.engine.send_close(BlindId::from_text("QJ0"));
+  bridge.run_for(1000);
+  require(cover.motions == 2 && cover.motion_timeout_ms < 30000,
+          "a learned travel time should shorten the cover's motion timeout");
+  bridge.engine.send_stop(BlindId::from_text("QJ0"));
+  bridge.run_for(1000);
+  require(cover.stops == 1 && !hub.moving("QJ0"), "a stop should be acknowledged");
+}
+
+void test_lost_commands_are_retried() {
+  VirtualHub hub;
+  VirtualBlindConfig config;
+  config.travel_ms = 2000;
+  hub.add_blind("USZ", config);
+  HostBridge bridge(hub);
+  bridge.engine.add_cover("USZ");
+  bridge.engine.set_command_retry_count(3);
+  bridge.engine.start();
+  bridge.run_for(3000);
+
+  hub.blind_config("USZ")->rf_loss_rate = 1.0f;
+  bridge.engine.send_close(BlindId::from_text("USZ"));
+  bridge.run_for(1000);
+  require(hub.stats().rf_lost == 1 && bridge.cover("USZ").motions == 0,
+          "the first attempt should be lost");
+  hub.blind_config("USZ")->rf_loss_rate = 0.0f;
+  bridge.run_for(8000);
+  require(bridge.cover("USZ").motions == 1 && hub.position("USZ") == 100,
+          "a retry should deliver the close");
+}
+
+void test_command_latency_is_recorded() {
+  VirtualHub hub;
+  VirtualBlindConfig config;
+  config.travel_ms = 2000;
+  hub.add_blind("USZ", config);
+  hub.add_blind("QJ0", config);
+  HostBridge bridge(hub);
+  bridge.engine.add_cover("USZ");
+  bridge.engine.add_cover("QJ0");
+  bridge.engine.set_command_retry_count(1);
+  bridge.engine.set_blind_latency_enabled(true);
+  bridge.engine.start();
+  bridge.run_for(3000);
+
+  bridge.engine.send_close(BlindId::from_text("USZ"));
+  bridge.run_for(3000);
+  const CommandLatency &motion = bridge.engine.get_command_latency(TxPacingClass::MOTION);
+  require(motion.acknowledged == 1 && motion.queue_wait.count() == 1 &&
+              motion.ack_rtt.count() == 1 && motion.total.count() == 1,
+          "an acknowledged move should record every stage");
+  require(motion.total.max_ms() >= motion.ack_rtt.max_ms() && motion.ack_rtt.max_ms() > 0,
+          "the total should include the round trip");
+
+  hub.blind_config("QJ0")->rf_loss_rate = 1.0f;
+  bridge.engine.send_close(BlindId::from_text("QJ0"));
+  bridge.run_for(10000);
+  require(motion.retries == 1 && motion.given_up == 1 && motion.acknowledged == 1,
+          "a lost move should count its retry and the give up");
+  require(motion.queue_wait.count() == 3, "every attempt should record its queue wait");
+
+  const CommandLatency *usz = bridge.engine.get_blind_command_latency("USZ");
+  const CommandLatency *qj0 = bridge.engine.get_blind_command_latency("QJ0");
+  require(usz != nullptr && usz->acknowledged == 1 && usz->given_up == 0,
+          "per-blind stats should only see the blind's own commands");
+  require(qj0 != nullptr && qj0->given_up == 1 && qj0->total.count() == 0,
+          "a give up should not record a total");
+  require(bridge.engine.get_blind_command_latency("ZZZ") == nullptr,
+          "unknown blinds should have no stats");
+
+  bridge.engine.reset_command_latency();
+  require(motion.queue_wait.count() == 0 && usz->acknowledged == 0, "reset should clear all");
+}
+
+void test_batches_and_link_errors_reach_the_sink() {
+  VirtualHub hub;
+  VirtualBlindConfig offline;
+  offline.lost_link_rate = 1.0f;
+  hub.add_blind("AAA");
+  hub.add_blind("BBB");
+  hub.add_blind("CCC", offline);
+  HostBridge bridge(hub);
+  bridge.engine.add_cover("AAA");
+  bridge.engine.add_cover("BBB");
+  bridge.engine.add_cover("CCC");
+  bridge.engine.map_sensor("CCC", SensorKind::LINK_QUALITY);
+  bridge.engine.start();
+  bridge.run_for(5000);
+  require(!bridge.cover("CCC").available, "Enl should mark the cover unavailable");
+  require(std::isnan(bridge.sensors[{bridge.index_of("CCC"), SensorKind::LINK_QUALITY}]),
+          "Enl should clear the link quality");
+
+  const uint32_t batch = bridge.engine.send_move_batch(
+      {{BlindId::from_text("AAA"), 30}, {BlindId::from_text("BBB"), 60}});
+  bridge.run_for(3000);
+  require(!bridge.engine.is_motion_batch_pending(batch) && !bridge.batches.empty() &&
+              bridge.batches.back().id == batch && bridge.batches.back().acknowledged == 2,
+          "the batch should be reported once both moves were echoed");
+}
+
+void test_watchdog_clear_finishes_queued_batches() {
+  VirtualHub hub;
+  hub.add_blind("AAA");
+  hub.add_blind("BBB");
+  hub.add_blind("CCC");
+  HostBridge bridge(hub);
+  bridge.engine.add_cover("AAA");
+  bridge.engine.add_cover("BBB");
+  bridge.engine.add_cover("CCC");
+  // One delivery at a time holds the rest of the batch in the queue, and
+  // nothing else transmits while the hub is silent.
+  bridge.engine.set_delivery_window(1);
+  bridge.engine.set_command_retry_count(0);
+  bridge.engine.set_command_retry_timeout(20000);
+  bridge.engine.set_motion_poll_interval(0);
+  bridge.engine.set_auto_poll_enabled(false);
+  bridge.engine.start();
+  bridge.run_for(5000);
+
+  for (const char *id : {"AAA", "BBB", "CCC"}) {
+    hub.blind_config(id)->rf_loss_rate = 1.0f;
+  }
+  const uint32_t batch = bridge.engine.send_move_batch({{BlindId::from_text("AAA"), 30},
+                                                        {BlindId::from_text("BBB"), 60},
+                                                        {BlindId::from_text("CCC"), 90}});
+  bridge.run_for(8000);
+  require(bridge.frames_sent > 0 && bridge.batches.empty(),
+          "the watchdog should have cleared the queue while the first move is in flight");
+  // The move in flight is verified and given up after two retry timeouts.
+  bridge.run_for(40000);
+  require(!bridge.engine.is_motion_batch_pending(batch) && bridge.batches.size() == 1 &&
+              bridge.batches.back().failed == 3,
+          "members dropped by the watchdog should fail so the batch is reported");
+}
+
+void test_state_survives_a_restart() {
+  VirtualHub hub;
+  VirtualBlindConfig config;
+  config.position = 70;
+  hub.add_blind("USZ", config);
+  HostBridge bridge(hub);
+  bridge.engine.add_cover("USZ");
+  bridge.engine.start();
+  bridge.run_for(5000);
+  bridge.engine.save_pending_state();
+  require(!bridge.snapshots.empty(), "the snapshot should be saved through the storage");
+
+  VirtualHub silent_hub;
+  HostBridge restarted(silent_hub);
+  restarted.snapshots = bridge.snapshots;
+  restarted.engine.add_cover("USZ");
+  restarted.engine.start();
+  require(restarted.cover("USZ").position == 70, "the restored position should be published");
+  require(!restarted.engine.is_blind_state_verified("USZ"),
+          "restored state should stay unverified until the blind answers");
+}
+
+void test_tx_queue_fits_a_query_pass() {
+  VirtualHub hub;
+  HostBridge bridge(hub);
+  for (int i = 0; i < 50; i++) {
+    const std::string id = {static_cast<char>('A' + i / 10), 'Q', static_cast<char>('0' + i % 10)};
+    hub.add_blind(id.c_str());
+    bridge.engine.add_cover(id);
+  }
+  bridge.engine.start();
+  require(bridge.engine.tx_queue_capacity() == 250,
+          "the default queue should hold a query pass over every blind");
+
+  HostBridge configured(hub);
+  configured.engine.add_cover("AQ0");
+  configured.engine.set_tx_queue_capacity(16);
+  configured.engine.start();
+  require(configured.engine.tx_queue_capacity() == 16, "a configured capacity should be kept");
+}
+
+}  // namespace
+
+int main() {
+  test_startup_fills_every_cover();
+  test_moves_are_acknowledged_and_tracked();
+  test_lost_commands_are_retried();
+  test_command_latency_is_recorded();
+  test_batches_and_link_errors_reach_the_sink();
+  test_watchdog_clear_finishes_queued_batches();
+  test_state_survives_a_restart();
+  test_tx_queue_fits_a_query_pass();
+  std::cout << "bridge engine tests passed" << std::endl;
+  return 0;
+}
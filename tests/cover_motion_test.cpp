@@ -0,0 +1,103 @@
+#include "cover_motion.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using esphome::arc_bridge::PositionInterpolator;
+using esphome::arc_bridge::TravelDirection;
+using esphome::arc_bridge::motion_target_for_token;
+
+namespace {
+
+void require(bool condition, const std::string &message) {
+  if (!condition) {
+    std::cerr << "FAIL: " << message << std::endl;
+    std::exit(1);
+  }
+}
+
+bool near(float actual, float expected) { return std::fabs(actual - expected) < 0.01f; }
+
+void test_direction_comes_from_the_target() {
+  PositionInterpolator motion;
+  motion.start(20.0f, 100.0f, 0);
+  require(motion.active() && motion.direction() == TravelDirection::CLOSING,
+          "a larger ARC target should be closing");
+  motion.start(80.0f, 0.0f, 0);
+  require(motion.direction() == TravelDirection::OPENING, "a smaller ARC target should be opening");
+  motion.start(40.0f, 40.0f, 0);
+  require(!motion.active(), "a move to the current position should not start tracking");
+
+  motion.start(-1.0f, 100.0f, 0);
+  require(motion.active() && motion.direction() == TravelDirection::CLOSING,
+          "an unknown start should still take its direction from the target");
+  require(motion.estimate(500) < 0.0f, "an unknown start should have no estimate yet");
+}
+
+void test_estimate_follows_the_measured_rate() {
+  PositionInterpolator motion;
+  motion.start(0.0f, 60.0f, 0);
+  require(near(motion.estimate(1000), 0.0f), "nothing should move before a rate is measured");
+
+  motion.report(10.0f, 1000);
+  require(near(motion.estimate(2000), 10.0f), "one report gives a position but no rate");
+  motion.report(20.0f, 3000);
+  require(near(motion.estimate(4000), 25.0f), "the estimate should advance at 5 % per second");
+  require(near(motion.estimate(60000), 60.0f), "the estimate should never pass the target");
+
+  motion.report(18.0f, 4000);
+  require(near(motion.estimate(9000), 18.0f),
+          "a report against the direction of travel should hold the estimate");
+
+  motion.arrive(60.0f, 9000);
+  require(!motion.active() && near(motion.estimate(10000), 60.0f),
+          "a final report should snap and end the motion");
+}
+
+void test_learned_travel_time_moves_from_the_start() {
+  PositionInterpolator motion;
+  motion.start(100.0f, 0.0f, 0, 20000);
+  require(near(motion.estimate(5000), 75.0f),
+          "a learned 20 s travel should open a quarter of the way in 5 s");
+  require(near(motion.estimate(30000), 0.0f), "the estimate should stop at the target");
+  motion.report(70.0f, 6000);
+  require(near(motion.estimate(8000), 60.0f),
+          "the learned rate should carry on from the first report");
+
+  motion.start(-1.0f, 0.0f, 0, 20000);
+  require(motion.estimate(5000) < 0.0f, "an unknown start should still have no estimate");
+}
+
+void test_remote_moves_are_picked_up_from_reports() {
+  PositionInterpolator motion;
+  motion.arrive(70.0f, 0);
+  motion.report(65.0f, 1000);
+  require(motion.active() && motion.direction() == TravelDirection::OPENING,
+          "an in-motion report away from the last position should start opening");
+  require(near(motion.target(), 0.0f), "remote moves should run towards the end stop");
+  motion.report(55.0f, 3000);
+  require(near(motion.estimate(4000), 50.0f), "remote moves should be interpolated too");
+}
+
+void test_ack_tokens_name_targets() {
+  require(motion_target_for_token("o") == 0, "open targets 0");
+  require(motion_target_for_token("c") == 100, "close targets 100");
+  require(motion_target_for_token("m045") == 45, "moves target their percentage");
+  require(motion_target_for_token("s") < 0 && motion_target_for_token("oA") < 0 &&
+              motion_target_for_token("m4x5") < 0 && motion_target_for_token("m150") < 0,
+          "other tokens should have no target");
+}
+
+}  // namespace
+
+int main() {
+  test_direction_comes_from_the_target();
+  test_estimate_follows_the_measured_rate();
+  test_learned_travel_time_moves_from_the_start();
+  test_remote_moves_are_picked_up_from_reports();
+  test_ack_tokens_name_targets();
+  std::cout << "cover motion tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,126 @@
+#include "frame_extractor.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using esphome::arc_bridge::FrameExtractor;
+
+namespace {
+
+void require(bool condition, const std::string &message) {
+  if (!condition) {
+    std::cerr << "FAIL: " << message << std::endl;
+    std::exit(1);
+  }
+}
+
+std::vector<std::string> feed(FrameExtractor &extractor, const std::string &bytes) {
+  std::vector<std::string> frames;
+  char frame[FrameExtractor::CAPACITY];
+  for (const char c : bytes) {
+    extractor.push(c);
+    const size_t length = extractor.next_frame(frame, sizeof(frame));
+    if (length > 0) {
+      frames.emplace_back(frame, length);
+    }
+  }
+  return frames;
+}
+
+void test_extracts_back_to_back_frames() {
+  FrameExtractor extractor;
+  const auto frames = feed(extractor, "!USZr100b180,RA6;!QJ0<09b00;");
+  require(frames.size() == 2, "two complete frames should be extracted");
+  require(frames[0] == "!USZr100b180,RA6;", "first frame should be extracted intact");
+  require(frames[1] == "!QJ0<09b00;", "second frame should be extracted intact");
+  require(extractor.size() == 0, "extracted frames should leave the buffer empty");
+}
+
+void test_skips_noise_between_frames() {
+  FrameExtractor extractor;
+  const auto frames = feed(extractor, "\r\n;junk!USZA;\n");
+  require(frames.size() == 1 && frames[0] == "!USZA;",
+          "noise and stray terminators outside a frame should be ignored");
+  require(extractor.resync_count() == 0, "noise outside a frame is not a resync");
+}
+
+void test_split_frame_across_reads() {
+  FrameExtractor extractor;
+  require(feed(extractor, "!USZr0").empty(), "a partial frame should not be extracted");
+  const auto frames = feed(extractor, "50;");
+  require(frames.size() == 1 && frames[0] == "!USZr050;",
+          "a frame split across reads should be reassembled");
+}
+
+void test_resyncs_at_next_start() {
+  FrameExtractor extractor;
+  const auto frames = feed(extractor, "!USZr1!QJ0r050;");
+  require(frames.size() == 1 && frames[0] == "!QJ0r050;",
+          "an interrupted frame should be dropped in favor of the next frame start");
+  require(extractor.resync_count() == 1, "the interrupted frame should count as a resync");
+}
+
+void test_overflow_keeps_following_frames() {
+  FrameExtractor extractor;
+  std::string runaway = "!USZ";
+  runaway.append(FrameExtractor::CAPACITY + 10, 'x');
+
+  auto frames = feed(extractor, runaway);
+  require(frames.empty(), "a runaway frame should never be extracted");
+  require(extractor.overflow_count() > 0, "a runaway frame should count as an overflow");
+
+  frames = feed(extractor, "tail;!QJ0r050;");
+  require(frames.size() == 1 && frames[0] == "!QJ0r050;",
+          "extraction should resume at the next frame start after an overflow");
+}
+
+void test_batched_overflow_drops_only_oldest_partial() {
+  FrameExtractor extractor;
+  std::string partial = "!USZ";
+  partial.append(FrameExtractor::CAPACITY - 20, 'x');
+  for (const char c : partial) {
+    extractor.push(c);
+  }
+  for (const char c : std::string("!QJ0r050;!KHNr100;")) {
+    extractor.push(c);
+  }
+
+  std::vector<std::string> frames;
+  char frame[FrameExtractor::CAPACITY];
+  size_t length = 0;
+  while ((length = extractor.next_frame(frame, sizeof(frame))) > 0) {
+    frames.emplace_back(frame, length);
+  }
+
+  require(extractor.overflow_count() == 1, "filling the ring should count one overflow");
+  require(frames.size() == 2 && frames[0] == "!QJ0r050;" && frames[1] == "!KHNr100;",
+          "buffered frames after the discarded partial should survive an overflow");
+}
+
+void test_frame_larger_than_output_is_dropped() {
+  FrameExtractor extractor;
+  char small[8];
+  for (const char c : std::string("!USZr100b180;!QJ0A;")) {
+    extractor.push(c);
+  }
+  const size_t length = extractor.next_frame(small, sizeof(small));
+  require(length == 6 && std::string(small, length) == "!QJ0A;",
+          "frames that do not fit the output buffer should be skipped");
+  require(extractor.overflow_count() == 1, "a skipped oversized frame should count as an overflow");
+}
+
+}  // namespace
+
+int main() {
+  test_extracts_back_to_back_frames();
+  test_skips_noise_between_frames();
+  test_split_frame_across_reads();
+  test_resyncs_at_next_start();
+  test_overflow_keeps_following_frames();
+  test_batched_overflow_drops_only_oldest_partial();
+  test_frame_larger_than_output_is_dropped();
+  std::cout << "frame extractor tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,96 @@
+#include "group_aggregate.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using esphome::arc_bridge_group::GroupAggregate;
+using esphome::arc_bridge_group::GroupOperation;
+using esphome::arc_bridge_group::MemberSnapshot;
+
+namespace {
+
+void require(bool condition, const std::string &message) {
+  if (!condition) {
+    std::cerr << "FAIL: " << message << std::endl;
+    std::exit(1);
+  }
+}
+
+MemberSnapshot at(float position, GroupOperation operation = GroupOperation::IDLE) {
+  MemberSnapshot snapshot;
+  snapshot.positioned = true;
+  snapshot.position = position;
+  snapshot.operation = operation;
+  return snapshot;
+}
+
+void test_aggregate_tracks_mean_and_operation() {
+  GroupAggregate aggregate;
+  aggregate.reset(3);
+  require(aggregate.positioned() == 0 && aggregate.operation() == GroupOperation::IDLE,
+          "a fresh group should have no position and be idle");
+
+  require(aggregate.update(0, at(0.2f)), "a first report should change the group");
+  require(aggregate.update(1, at(0.6f)), "a second report should change the group");
+  require(aggregate.positioned() == 2 && std::fabs(aggregate.position() - 0.4f) < 1e-6f,
+          "the position should average the positioned members only");
+
+  require(!aggregate.update(1, at(0.6f)), "an unchanged report should not change the group");
+  require(!aggregate.update(7, at(0.6f)), "unknown members should be ignored");
+
+  aggregate.update(0, at(0.3f, GroupOperation::OPENING));
+  require(aggregate.operation() == GroupOperation::OPENING, "one opening member opens the group");
+  aggregate.update(2, at(0.9f, GroupOperation::CLOSING));
+  require(aggregate.operation() == GroupOperation::IDLE,
+          "members moving both ways should leave the group idle");
+  aggregate.update(0, at(0.3f));
+  require(aggregate.operation() == GroupOperation::CLOSING,
+          "the group should follow the remaining closing member");
+
+  aggregate.update(0, MemberSnapshot{});
+  aggregate.update(1, MemberSnapshot{});
+  aggregate.update(2, MemberSnapshot{});
+  require(aggregate.positioned() == 0 && aggregate.operation() == GroupOperation::IDLE,
+          "unavailable members should leave the group without a position");
+}
+
+void test_aggregate_matches_a_full_walk_after_many_updates() {
+  constexpr size_t MEMBERS = 64;
+  GroupAggregate aggregate;
+  aggregate.reset(MEMBERS);
+  MemberSnapshot members[MEMBERS];
+  uint32_t seed = 12345;
+  for (int step = 0; step < 200000; step++) {
+    seed = seed * 1103515245u + 12345u;
+    const size_t index = (seed >> 8) % MEMBERS;
+    MemberSnapshot snapshot;
+    snapshot.positioned = ((seed >> 4) & 7) != 0;
+    snapshot.position = static_cast<float>((seed >> 16) % 101) / 100.0f;
+    snapshot.operation = static_cast<GroupOperation>((seed >> 12) % 3);
+    members[index] = snapshot;
+    aggregate.update(index, snapshot);
+  }
+
+  double total = 0.0;
+  size_t positioned = 0;
+  for (const MemberSnapshot &member : members) {
+    if (member.positioned) {
+      total += member.position;
+      positioned++;
+    }
+  }
+  require(aggregate.positioned() == positioned, "the running count should match a full walk");
+  require(std::fabs(aggregate.position() - static_cast<float>(total / positioned)) < 1e-5f,
+          "the running mean should not drift from a full walk");
+}
+
+}  // namespace
+
+int main() {
+  test_aggregate_tracks_mean_and_operation();
+  test_aggregate_matches_a_full_walk_after_many_updates();
+  std::cout << "group aggregate tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,415 @@
+#include "alloc_tracker.h"
+#include "battery.h"
+#include "blind_registry.h"
+#include "bridge_engine.h"
+#include "delivery.h"
+#include "group_aggregate.h"
+#include "legacy_protocol_parser.h"
+#include "protocol.h"
+#include "tx_queue.h"
+#include "virtual_hub.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using esphome::arc_bridge::BlindId;
+using esphome::arc_bridge::BlindRegistry;
+using esphome::arc_bridge::BridgeClock;
+using esphome::arc_bridge::BridgeEngine;
+using esphome::arc_bridge::BridgeTransport;
+using esphome::arc_bridge::DEFAULT_TX_QUEUE_CAPACITY;
+using esphome::arc_bridge::DeliveryExpectation;
+using esphome::arc_bridge::ParsedFrame;
+using esphome::arc_bridge::TxPacingClass;
+using esphome::arc_bridge::TxPriorityClass;
+using esphome::arc_bridge::TxQueueItem;
+using esphome::arc_bridge::TxScheduler;
+using esphome::arc_bridge::battery_percent_from_3s_li_ion;
+using esphome::arc_bridge::build_command_frame;
+using esphome::arc_bridge::frame_confirms_delivery;
+using esphome::arc_bridge::parse_arc_frame;
+using esphome::arc_bridge::testing::AllocationScope;
+using esphome::arc_bridge::testing::VirtualBlindConfig;
+using esphome::arc_bridge::testing::VirtualHub;
+using esphome::arc_bridge::tx_item_fits_delivery_window;
+using esphome::arc_bridge_group::GroupAggregate;
+using esphome::arc_bridge_group::GroupOperation;
+using esphome::arc_bridge_group::MemberSnapshot;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Keeps benchmark results observable so the optimizer cannot drop the work.
+volatile uint64_t g_sink = 0;
+
+double g_min_seconds = 0.25;
+
+struct Result {
+  std::string name;
+  uint64_t iterations;
+  double ns_per_op;
+  double allocs_per_op;
+  double bytes_per_op;
+};
+
+std::vector<Result> g_results;
+
+// Runs `body(i)` in growing batches until the minimum run time is reached.
+// `setup(batch)` runs untimed before each batch.
+template<typename Setup, typename Body>
+void run_benchmark(const std::string &name, Setup setup, Body body,
+                   uint64_t max_batch = 1u << 20) {
+  uint64_t batch = 64;
+  uint64_t iterations = 0;
+  uint64_t allocations = 0;
+  uint64_t bytes = 0;
+  Clock::duration elapsed{};
+
+  // Warm caches and any lazily initialised state before measuring.
+  setup(batch);
+  for (uint64_t i = 0; i < batch; i++) {
+    body(i);
+  }
+
+  while (std::chrono::duration<double>(elapsed).count() < g_min_seconds) {
+    setup(batch);
+    const AllocationScope scope;
+    const auto start = Clock::now();
+    for (uint64_t i = 0; i < batch; i++) {
+      body(i);
+    }
+    elapsed += Clock::now() - start;
+    allocations += scope.allocations();
+    bytes += scope.bytes();
+    iterations += batch;
+    if (batch < max_batch) {
+      batch *= 2;
+    }
+  }
+
+  const double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+  g_results.push_back({name, iterations, ns / static_cast<double>(iterations),
+                       static_cast<double>(allocations) / static_cast<double>(iterations),
+                       static_cast<double>(bytes) / static_cast<double>(iterations)});
+}
+
+template<typename Body>
+void run_benchmark(const std::string &name, Body body) {
+  run_benchmark(name, [](uint64_t) {}, body);
+}
+
+struct Corpus {
+  const char *name;
+  std::vector<std::string> frames;
+};
+
+// Reply mixes seen on real installs, grouped by the kind of traffic.
+const std::vector<Corpus> &corpora() {
+  static const std::vector<Corpus> CORPORA = {
+      {"final_position",
+       {"!USZr100b180,RA6;", "!QJ0r050b000,R5F;", "!KHNr000b180,RB2;", "!NOMr075b090,R98;"}},
+      {"in_motion", {"!USZ<09b00;", "!USZ<55b00,R60;", "!QJ0<87b00,R9C;", "!KHN<12b00;"}},
+      {"telemetry",
+       {"!USZpVc1180,RA6;", "!USZpSc028;", "!USZpP03;", "!USZvA21;", "!NOMvD22,R9C;",
+        "!QJ0pVc000;"}},
+      {"echo", {"!QJ0o,R98;", "!QJ0s,R9D;", "!QJ0oA,R9C;", "!QJ0m050,R9C;", "!QJ0c,R98;"}},
+      {"errors", {"!USZEnl;", "!USZEnp;", "!USZEdf;", "!QJ0Ebz;", "!USZU;", "!QJ0A;"}},
+  };
+  return CORPORA;
+}
+
+std::vector<std::string> mixed_corpus() {
+  std::vector<std::string> frames;
+  for (const auto &corpus : corpora()) {
+    frames.insert(frames.end(), corpus.frames.begin(), corpus.frames.end());
+  }
+  return frames;
+}
+
+void bench_parse_arc_frame() {
+  for (const auto &corpus : corpora()) {
+    const auto &frames = corpus.frames;
+    run_benchmark(std::string("parse_arc_frame/") + corpus.name, [&frames](uint64_t i) {
+      const ParsedFrame parsed = parse_arc_frame(frames[i % frames.size()]);
+      g_sink = g_sink + parsed.present;
+    });
+  }
+
+  const std::vector<std::string> mixed = mixed_corpus();
+  run_benchmark("parse_arc_frame/mixed", [&mixed](uint64_t i) {
+    const ParsedFrame parsed = parse_arc_frame(mixed[i % mixed.size()]);
+    g_sink = g_sink + parsed.present;
+  });
+  run_benchmark("legacy_parse_arc_frame/mixed", [&mixed](uint64_t i) {
+    const auto parsed = esphome::arc_bridge::legacy::parse_arc_frame(mixed[i % mixed.size()]);
+    g_sink = g_sink + parsed.valid;
+  });
+}
+
+void bench_frame_confirms_delivery() {
+  std::vector<ParsedFrame> replies;
+  for (const auto &frame : mixed_corpus()) {
+    replies.push_back(parse_arc_frame(frame));
+  }
+  const BlindId blind_id = BlindId::from_text("QJ0");
+  const std::string token = "m050";
+  const std::string prefix = "m";
+
+  run_benchmark("frame_confirms_delivery/mixed", [&](uint64_t i) {
+    const bool confirmed = frame_confirms_delivery(replies[i % replies.size()], blind_id,
+                                                   DeliveryExpectation::BLIND_REPLY, token, prefix);
+    g_sink = g_sink + confirmed;
+  });
+}
+
+// A send_query_all() pass on a 30 blind install, queued as background polls.
+TxScheduler query_all_scheduler(size_t capacity) {
+  static const char *const QUERIES[] = {"r?", "pVc?", "pSc?", "v?", "pP?"};
+  TxScheduler scheduler(capacity);
+  for (int blind = 0; blind < 30; blind++) {
+    char text[4];
+    snprintf(text, sizeof(text), "B%02d", blind);
+    const BlindId id = BlindId::from_text(text);
+    for (const char *query : QUERIES) {
+      TxQueueItem item{{}, TxPacingClass::STANDARD, true, id, DeliveryExpectation::NONE, false, 0,
+                       "", ""};
+      build_command_frame(item.frame, id, query[0], query + 1);
+      scheduler.push(item, TxPriorityClass::BACKGROUND_POLL, 0);
+    }
+  }
+  return scheduler;
+}
+
+const TxQueueItem MOTION_ITEM{"!B07m050;", TxPacingClass::MOTION, false,
+                              BlindId::from_text("B07"), DeliveryExpectation::BLIND_REPLY,
+                              true, 1, "m050", "m"};
+
+// Dropping the query-all backlog when a motion command arrives behind it.
+void bench_tx_scheduler_drop_polls() {
+  TxScheduler source = query_all_scheduler(DEFAULT_TX_QUEUE_CAPACITY);
+  source.push(MOTION_ITEM, TxPriorityClass::MOTION, 1000);
+  std::vector<TxScheduler> schedulers;
+
+  run_benchmark(
+      "tx_scheduler_drop_polls/query_all_30",
+      [&](uint64_t batch) { schedulers.assign(batch, source); },
+      [&](uint64_t i) {
+        schedulers[i].drop_polls();
+        g_sink = g_sink + schedulers[i].size();
+      },
+      256);
+}
+
+// A motion command pushed into a queue the query-all backlog has filled,
+// which displaces the newest poll.
+void bench_tx_scheduler_push_full() {
+  const TxScheduler source = query_all_scheduler(150);
+  std::vector<TxScheduler> schedulers;
+
+  run_benchmark(
+      "tx_scheduler_push_full/query_all_30",
+      [&](uint64_t batch) { schedulers.assign(batch, source); },
+      [&](uint64_t i) {
+        schedulers[i].push(MOTION_ITEM, TxPriorityClass::MOTION, 1000);
+        g_sink = g_sink + schedulers[i].size();
+      },
+      256);
+}
+
+// Picking the next frame from a query-all backlog with the motion command
+// queued last, as the scheduler does before every send.
+void bench_tx_scheduler_select() {
+  TxScheduler scheduler = query_all_scheduler(DEFAULT_TX_QUEUE_CAPACITY);
+  scheduler.push(MOTION_ITEM, TxPriorityClass::MOTION, 1000);
+
+  run_benchmark("tx_scheduler_select/query_all_30", [&](uint64_t i) {
+    g_sink = g_sink + scheduler.select(2000 + static_cast<uint32_t>(i & 0xFF));
+  });
+}
+
+void bench_tx_item_fits_delivery_window() {
+  const std::vector<TxQueueItem> items = {
+      {"!USZo;", TxPacingClass::MOTION, false, BlindId::from_text("USZ"),
+       DeliveryExpectation::BLIND_REPLY, true, 2, "o", ""},
+      {"!QJ0o;", TxPacingClass::MOTION, false, BlindId::from_text("QJ0"),
+       DeliveryExpectation::BLIND_REPLY, true, 1, "o", ""},
+      {"!QJ0r?;", TxPacingClass::STANDARD, false, {}, DeliveryExpectation::NONE, false, 0, "", ""},
+  };
+  // QJ0 has delivery 1 in flight, out of a window of four.
+  const uint32_t pending_tracking[] = {0, 1, 0};
+
+  run_benchmark("tx_item_fits_delivery_window/mixed", [&](uint64_t i) {
+    const size_t item = i % items.size();
+    const bool allowed =
+        tx_item_fits_delivery_window(items[item], pending_tracking[item], 1, 4);
+    g_sink = g_sink + allowed;
+  });
+}
+
+// Per-frame blind lookup on a 40 blind install, against the string-keyed map
+// the bridge used before.
+void bench_blind_lookup() {
+  std::vector<ParsedFrame> replies;
+  BlindRegistry registry;
+  std::unordered_map<std::string, size_t> legacy_map;
+  for (int blind = 0; blind < 40; blind++) {
+    char text[4];
+    snprintf(text, sizeof(text), "B%02d", blind);
+    registry.add(BlindId::from_text(text));
+    legacy_map[text] = static_cast<size_t>(blind);
+    replies.push_back(parse_arc_frame(std::string("!") + text + "r050b180,RA6;"));
+  }
+
+  run_benchmark("blind_registry_find/40", [&](uint64_t i) {
+    g_sink = g_sink + registry.find(replies[i % replies.size()].blind_id);
+  });
+  run_benchmark("legacy_unordered_map_find/40", [&](uint64_t i) {
+    const auto it = legacy_map.find(std::string(replies[i % replies.size()].id_view()));
+    g_sink = g_sink + (it != legacy_map.end() ? it->second : 0);
+  });
+}
+
+// One member report in a whole-house group: the running aggregate against the
+// walk over every member the group cover did on each report before.
+void bench_group_aggregate(size_t members) {
+  std::vector<MemberSnapshot> snapshots(members);
+  GroupAggregate aggregate;
+  aggregate.reset(members);
+  const std::string suffix = "/" + std::to_string(members);
+
+  run_benchmark("group_aggregate_update" + suffix, [&](uint64_t i) {
+    MemberSnapshot snapshot;
+    snapshot.positioned = true;
+    snapshot.position = static_cast<float>(i % 101) / 100.0f;
+    snapshot.operation = GroupOperation::CLOSING;
+    aggregate.update(i % members, snapshot);
+    g_sink = g_sink + static_cast<uint64_t>(aggregate.position() * 100.0f);
+  });
+  run_benchmark("legacy_group_full_walk" + suffix, [&](uint64_t i) {
+    MemberSnapshot &snapshot = snapshots[i % members];
+    snapshot.positioned = true;
+    snapshot.position = static_cast<float>(i % 101) / 100.0f;
+    snapshot.operation = GroupOperation::CLOSING;
+    float total = 0.0f;
+    size_t positioned = 0;
+    bool opening = false;
+    bool closing = false;
+    for (const MemberSnapshot &member : snapshots) {
+      opening = opening || member.operation == GroupOperation::OPENING;
+      closing = closing || member.operation == GroupOperation::CLOSING;
+      if (member.positioned) {
+        total += member.position;
+        positioned++;
+      }
+    }
+    g_sink = g_sink + static_cast<uint64_t>(total / positioned * 100.0f) + opening + closing;
+  });
+}
+
+void bench_battery_percent() {
+  run_benchmark("battery_percent_from_3s_li_ion/sweep", [](uint64_t i) {
+    const float volts = 8.5f + static_cast<float>(i % 450) * 0.01f;
+    const float percent = battery_percent_from_3s_li_ion(volts);
+    g_sink = g_sink + static_cast<uint64_t>(percent);
+  });
+}
+
+// One engine loop pass on a 40 blind install with auto-poll running against
+// the virtual hub: RX, parse, dispatch, scheduling and TX, one virtual
+// millisecond per pass.
+class EngineLoopFixture : public BridgeClock, public BridgeTransport {
+ public:
+  EngineLoopFixture() {
+    this->hub.set_transcript_enabled(false);
+    this->engine.set_clock(this);
+    this->engine.set_transport(this);
+    for (int blind = 0; blind < 40; blind++) {
+      char text[4];
+      snprintf(text, sizeof(text), "B%02d", blind);
+      VirtualBlindConfig config;
+      config.position = static_cast<uint8_t>(blind * 2);
+      this->hub.add_blind(text, config);
+      this->engine.add_cover(text);
+    }
+    this->engine.set_auto_poll_interval(1000);
+    this->engine.start();
+  }
+
+  void step() {
+    this->now++;
+    this->hub.advance_to(this->now);
+    this->engine.run();
+  }
+
+  uint32_t now_ms() const override { return this->now; }
+  size_t receive(char *buffer, size_t size) override {
+    if (this->rx.empty() && this->hub.available()) {
+      this->rx = this->hub.read();
+    }
+    const size_t count = this->rx.size() < size ? this->rx.size() : size;
+    this->rx.copy(buffer, count);
+    this->rx.erase(0, count);
+    return count;
+  }
+  void transmit(std::string_view bytes) override { this->hub.write(bytes); }
+
+  VirtualHub hub;
+  BridgeEngine engine;
+  uint32_t now{0};
+  std::string rx;
+};
+
+void bench_engine_loop() {
+  EngineLoopFixture fixture;
+  // Past the startup guard and sweep, into steady auto-poll.
+  for (int i = 0; i < 20000; i++) {
+    fixture.step();
+  }
+  run_benchmark("bridge_engine_loop/40", [&](uint64_t) {
+    fixture.step();
+    g_sink = g_sink + fixture.now;
+  });
+}
+
+void print_json() {
+  std::printf("{\n  \"schema\": 1,\n  \"benchmarks\": [\n");
+  for (size_t i = 0; i < g_results.size(); i++) {
+    const Result &result = g_results[i];
+    std::printf("    {\"name\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.3f, "
+                "\"allocs_per_op\": %.3f, \"bytes_per_op\": %.3f}%s\n",
+                result.name.c_str(), static_cast<unsigned long long>(result.iterations),
+                result.ns_per_op, result.allocs_per_op, result.bytes_per_op,
+                i + 1 < g_results.size() ? "," : "");
+  }
+  std::printf("  ]\n}\n");
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--quick") == 0) {
+      g_min_seconds = 0.02;
+    }
+  }
+
+  bench_parse_arc_frame();
+  bench_frame_confirms_delivery();
+  bench_tx_scheduler_drop_polls();
+  bench_tx_scheduler_push_full();
+  bench_tx_scheduler_select();
+  bench_tx_item_fits_delivery_window();
+  bench_blind_lookup();
+  bench_group_aggregate(64);
+  bench_group_aggregate(256);
+  bench_battery_percent();
+  bench_engine_loop();
+  print_json();
+  return 0;
+}
@@ -0,0 +1,92 @@
+#include "latency_histogram.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using esphome::arc_bridge::CommandLatency;
+using esphome::arc_bridge::LATENCY_BUCKET_COUNT;
+using esphome::arc_bridge::LatencyHistogram;
+using esphome::arc_bridge::LatencyStage;
+using esphome::arc_bridge::latency_stage;
+
+namespace {
+
+void require(bool condition, const std::string &message) {
+  if (!condition) {
+    std::cerr << "FAIL: " << message << std::endl;
+    std::exit(1);
+  }
+}
+
+void test_empty_histogram_reports_zero() {
+  LatencyHistogram histogram;
+  require(histogram.count() == 0 && histogram.max_ms() == 0 && histogram.mean_ms() == 0,
+          "an empty histogram should report nothing");
+  require(histogram.percentile_ms(50) == 0 && histogram.percentile_ms(100) == 0,
+          "percentiles of an empty histogram should be 0");
+}
+
+void test_samples_land_in_their_buckets() {
+  LatencyHistogram histogram;
+  histogram.record(0);
+  histogram.record(10);
+  histogram.record(11);
+  histogram.record(200);
+  histogram.record(201);
+  histogram.record(60000);
+  require(histogram.bucket(0) == 2, "bounds should be inclusive");
+  require(histogram.bucket(1) == 1, "just over a bound should move up a bucket");
+  require(histogram.bucket(5) == 1 && histogram.bucket(6) == 1,
+          "samples either side of the motion gap should be split");
+  require(histogram.bucket(LATENCY_BUCKET_COUNT - 1) == 1,
+          "long samples should land in the open-ended bucket");
+  require(histogram.count() == 6 && histogram.max_ms() == 60000 &&
+              histogram.mean_ms() == (0 + 10 + 11 + 200 + 201 + 60000) / 6,
+          "count, max and mean should be exact");
+}
+
+void test_percentiles_resolve_to_bucket_bounds() {
+  LatencyHistogram histogram;
+  for (int i = 0; i < 90; i++) {
+    histogram.record(120);
+  }
+  for (int i = 0; i < 9; i++) {
+    histogram.record(1200);
+  }
+  histogram.record(4000);
+  require(histogram.percentile_ms(50) == 150, "p50 should be the bucket bound over 120 ms");
+  require(histogram.percentile_ms(90) == 150, "p90 should still fall in the first bucket");
+  require(histogram.percentile_ms(95) == 1500, "p95 should fall in the retry bucket");
+  require(histogram.percentile_ms(100) == 4000, "p100 should be capped at the max");
+
+  LatencyHistogram single;
+  single.record(7);
+  require(single.percentile_ms(50) == 7 && single.percentile_ms(95) == 7,
+          "percentiles should never exceed the largest sample");
+}
+
+void test_command_latency_stages() {
+  CommandLatency latency;
+  latency.queue_wait.record(5);
+  latency.ack_rtt.record(80);
+  latency.total.record(85);
+  latency.retries = 2;
+  require(latency_stage(latency, LatencyStage::QUEUE_WAIT).max_ms() == 5 &&
+              latency_stage(latency, LatencyStage::ACK_RTT).max_ms() == 80 &&
+              latency_stage(latency, LatencyStage::TOTAL).max_ms() == 85,
+          "each stage should select its histogram");
+  latency.clear();
+  require(latency.total.count() == 0 && latency.retries == 0, "clear should reset everything");
+}
+
+}  // namespace
+
+int main() {
+  test_empty_histogram_reports_zero();
+  test_samples_land_in_their_buckets();
+  test_percentiles_resolve_to_bucket_bounds();
+  test_command_latency_stages();
+  std::cout << "latency histogram tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,150 @@
+#include "bridge_engine.h"
+#include "loop_profiler.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using esphome::arc_bridge::BlindId;
+using esphome::arc_bridge::BridgeClock;
+using esphome::arc_bridge::BridgeEngine;
+using esphome::arc_bridge::BridgeTransport;
+using esphome::arc_bridge::LoopProfiler;
+using esphome::arc_bridge::LoopSection;
+using esphome::arc_bridge::LoopSectionScope;
+
+namespace {
+
+void require(bool condition, const std::string &message) {
+  if (!condition) {
+    std::cerr << "FAIL: " << message << std::endl;
+    std::exit(1);
+  }
+}
+
+// Cycles only move when the test says so: every read costs one cycle and a
+// transmit costs `transmit_cycles`.
+class SteppedClock : public BridgeClock, public BridgeTransport {
+ public:
+  uint32_t now_ms() const override { return this->now; }
+  uint32_t cycle_count() const override { return this->cycles++; }
+  uint32_t cycles_per_us() const override { return 10; }
+
+  size_t receive(char *buffer, size_t size) override {
+    const size_t count = std::min(size, this->rx.size());
+    this->rx.copy(buffer, count);
+    this->rx.erase(0, count);
+    return count;
+  }
+  void transmit(std::string_view bytes) override {
+    this->tx += std::string(bytes);
+    this->cycles += this->transmit_cycles;
+  }
+
+  uint32_t now{0};
+  mutable uint32_t cycles{0};
+  uint32_t transmit_cycles{0};
+  std::string rx;
+  std::string tx;
+};
+
+void test_sections_are_summed_per_pass() {
+  LoopProfiler profiler;
+  profiler.set_cycles_per_us(10);
+  profiler.begin_pass(1000);
+  profiler.add(LoopSection::DISPATCH, 200);
+  profiler.add(LoopSection::DISPATCH, 300);
+  profiler.add(LoopSection::TX, 100);
+  require(!profiler.end_pass(2000), "a 100 us pass should not count as a stall");
+
+  profiler.begin_pass(5000);
+  profiler.add(LoopSection::DISPATCH, 100);
+  profiler.end_pass(5400);
+
+  const auto &dispatch = profiler.stats(LoopSection::DISPATCH);
+  require(dispatch.runs == 2 && dispatch.max_cycles == 500 && dispatch.mean_cycles() == 300,
+          "repeated runs in one pass should add up before the max and mean");
+  require(profiler.stats(LoopSection::TX).runs == 1,
+          "sections should only count the passes they ran in");
+  require(profiler.last_pass_cycles(LoopSection::TX) == 0 &&
+              profiler.last_pass_cycles(LoopSection::DISPATCH) == 100,
+          "the last pass should only show what ran in it");
+  require(profiler.stats(LoopSection::LOOP).max_cycles == 1000 &&
+              profiler.to_us(profiler.stats(LoopSection::LOOP).max_cycles) == 100,
+          "the whole pass should be timed and convert to microseconds");
+
+  profiler.reset();
+  require(profiler.stats(LoopSection::LOOP).runs == 0, "reset should clear every section");
+}
+
+void test_stalls_are_counted() {
+  LoopProfiler profiler;
+  profiler.set_cycles_per_us(10);
+  profiler.set_stall_threshold_us(30000);
+  profiler.begin_pass(0);
+  require(profiler.end_pass(400000) && profiler.stalls() == 1, "a 40 ms pass should stall");
+  profiler.set_stall_threshold_us(0);
+  profiler.begin_pass(0);
+  require(!profiler.end_pass(400000), "a zero threshold should disable stall detection");
+}
+
+void test_scope_wraps_counter() {
+  SteppedClock clock;
+  clock.cycles = UINT32_MAX - 2;
+  LoopProfiler profiler;
+  profiler.begin_pass(0);
+  {
+    LoopSectionScope<SteppedClock> scope(profiler, clock, LoopSection::RX);
+    clock.cycles += 10;
+  }
+  profiler.end_pass(0);
+  require(profiler.stats(LoopSection::RX).max_cycles == 11,
+          "a scope should time across a counter wrap");
+}
+
+void test_engine_reports_each_section() {
+  SteppedClock clock;
+  BridgeEngine engine;
+  engine.set_clock(&clock);
+  engine.set_transport(&clock);
+  engine.add_cover("USZ");
+  engine.set_startup_settle(0);
+  engine.start();
+
+  clock.rx = "!USZr050b180;";
+  for (int i = 0; i < 3000; i++) {
+    clock.now++;
+    engine.run();
+  }
+  const LoopProfiler &profiler = engine.get_loop_profiler();
+  require(profiler.stats(LoopSection::LOOP).runs == 3000, "every pass should be timed");
+  for (LoopSection section : {LoopSection::RX, LoopSection::FRAMING, LoopSection::DISPATCH,
+                              LoopSection::MOTION, LoopSection::POLL, LoopSection::TX,
+                              LoopSection::DELIVERY}) {
+    require(profiler.stats(section).runs > 0, "every loop section should have run");
+  }
+  require(profiler.stats(LoopSection::QUERY_ALL).runs == 0,
+          "query_all should only run when requested");
+
+  clock.transmit_cycles = 400000;
+  engine.send_query_all();
+  for (int i = 0; i < 1000; i++) {
+    clock.now++;
+    engine.run();
+  }
+  require(profiler.stats(LoopSection::QUERY_ALL).runs == 1, "send_query_all should be timed");
+  require(profiler.stalls() > 0 && profiler.to_us(profiler.stats(LoopSection::TX).max_cycles) >=
+                                       40000,
+          "a slow transmit should show up as a TX stall");
+}
+
+}  // namespace
+
+int main() {
+  test_sections_are_summed_per_pass();
+  test_stalls_are_counted();
+  test_scope_wraps_counter();
+  test_engine_reports_each_section();
+  std::cout << "loop profiler tests passed" << std::endl;
+  return 0;
+}
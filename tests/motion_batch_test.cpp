@@ -0,0 +1,127 @@
+#include "motion_batch.h"
+#include "tx_queue.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using esphome::arc_bridge::BlindId;
+using esphome::arc_bridge::DeliveryExpectation;
+using esphome::arc_bridge::MotionBatchOutcome;
+using esphome::arc_bridge::MotionBatchStatus;
+using esphome::arc_bridge::MotionBatchTracker;
+using esphome::arc_bridge::TxPacingClass;
+using esphome::arc_bridge::TxPriorityClass;
+using esphome::arc_bridge::TxQueueItem;
+using esphome::arc_bridge::TxScheduler;
+using esphome::arc_bridge::build_command_frame;
+
+namespace {
+
+void require(bool condition, const std::string &message) {
+  if (!condition) {
+    std::cerr << "FAIL: " << message << std::endl;
+    std::exit(1);
+  }
+}
+
+void test_batch_reports_once_every_member_finished() {
+  MotionBatchTracker tracker;
+  MotionBatchStatus finished;
+  const uint32_t batch = tracker.begin();
+  tracker.add(batch, 11);
+  tracker.add(batch, 12);
+  tracker.add(batch, 13);
+  require(!tracker.seal(batch, finished), "a batch with queued members should stay open");
+  require(tracker.contains(batch) && tracker.active() == 1, "the batch should be tracked");
+
+  require(!tracker.resolve(12, true, finished), "the batch should wait for every member");
+  require(!tracker.resolve(99, true, finished), "deliveries outside a batch should be ignored");
+  require(!tracker.resolve(12, true, finished), "a member should only be counted once");
+  require(!tracker.resolve(11, true, finished), "the batch should wait for the last member");
+  require(tracker.resolve(13, true, finished), "the last member should finish the batch");
+  require(finished.id == batch && finished.total == 3 && finished.acknowledged == 3,
+          "the report should count every member");
+  require(finished.outcome() == MotionBatchOutcome::ALL_ACKNOWLEDGED, "all members replied");
+  require(!tracker.contains(batch) && tracker.active() == 0, "reported batches are forgotten");
+}
+
+void test_batch_outcomes() {
+  MotionBatchTracker tracker;
+  MotionBatchStatus finished;
+
+  const uint32_t partial = tracker.begin();
+  tracker.add(partial, 1);
+  tracker.add(partial, 0);
+  require(!tracker.seal(partial, finished), "a queued member should keep the batch open");
+  require(tracker.resolve(1, true, finished), "the queued member should finish the batch");
+  require(finished.outcome() == MotionBatchOutcome::PARTIAL && finished.failed == 1,
+          "a member that could not be queued should count as failed");
+
+  const uint32_t failed = tracker.begin();
+  tracker.add(failed, 2);
+  tracker.add(failed, 3);
+  tracker.seal(failed, finished);
+  require(!tracker.resolve(2, false, finished), "one given-up member should not end the batch");
+  require(tracker.resolve(3, false, finished), "the last given-up member should end the batch");
+  require(finished.outcome() == MotionBatchOutcome::FAILED, "no member replied");
+
+  const uint32_t unqueued = tracker.begin();
+  tracker.add(unqueued, 0);
+  require(tracker.seal(unqueued, finished) && finished.id == unqueued,
+          "a batch with nothing queued should be reported when sealed");
+  require(finished.outcome() == MotionBatchOutcome::FAILED, "nothing was queued");
+
+  const uint32_t first = tracker.begin();
+  const uint32_t second = tracker.begin();
+  tracker.add(first, 4);
+  tracker.add(second, 5);
+  require(tracker.resolve(5, true, finished) && finished.id == second,
+          "interleaved batches should finish independently");
+  require(tracker.contains(first), "the other batch should stay open");
+}
+
+void test_batch_members_go_out_back_to_back_in_order() {
+  TxScheduler scheduler;
+  // Background polls queued before the group move.
+  for (int i = 0; i < 4; i++) {
+    TxQueueItem poll;
+    poll.is_poll = true;
+    require(build_command_frame(poll.frame, BlindId::from_text("P0" + std::to_string(i)), 'r',
+                                "?"),
+            "poll frame");
+    scheduler.push(poll, TxPriorityClass::BACKGROUND_POLL, 0);
+  }
+
+  // One batch queues every member with the same timestamp.
+  std::vector<BlindId> members;
+  for (int i = 0; i < 8; i++) {
+    members.push_back(BlindId::from_text("LR" + std::to_string(i)));
+    TxQueueItem item;
+    item.pacing_class = TxPacingClass::MOTION;
+    item.blind_id = members.back();
+    item.delivery_expectation = DeliveryExpectation::BLIND_REPLY;
+    item.tracking_id = static_cast<uint32_t>(i + 1);
+    require(build_command_frame(item.frame, item.blind_id, 'm', "050"), "move frame");
+    scheduler.push(item, TxPriorityClass::MOTION, 1000);
+  }
+
+  for (size_t i = 0; i < members.size(); i++) {
+    const uint32_t now = 1000 + static_cast<uint32_t>(i) * 200;
+    const size_t index = scheduler.select(now);
+    require(index != TxScheduler::NONE && scheduler.queue()[index].blind_id == members[i],
+            "batch members should be sent in the order given, before older polls");
+    scheduler.complete(index, now);
+  }
+}
+
+}  // namespace
+
+int main() {
+  test_batch_reports_once_every_member_finished();
+  test_batch_outcomes();
+  test_batch_members_go_out_back_to_back_in_order();
+  std::cout << "motion batch tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,111 @@
+#include "motion_tracker.h"
+#include "protocol.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using esphome::arc_bridge::MotionState;
+using esphome::arc_bridge::ParsedFrame;
+using esphome::arc_bridge::parse_arc_frame;
+
+namespace {
+
+constexpr uint32_t INTERVAL_MS = 2000;
+constexpr uint32_t TIMEOUT_MS = 90000;
+
+void require(bool condition, const std::string &message) {
+  if (!condition) {
+    std::cerr << "FAIL: " << message << std::endl;
+    std::exit(1);
+  }
+}
+
+// Feeds a raw reply through the parser the way the bridge does.
+bool feed(MotionState &state, const char *frame, uint32_t now) {
+  const ParsedFrame parsed = parse_arc_frame(frame);
+  require(parsed.valid && parsed.has(ParsedFrame::POSITION), std::string("parse ") + frame);
+  return state.report(parsed.position_in_motion, now);
+}
+
+void test_motion_polls_until_arrival() {
+  MotionState state;
+  require(!state.poll_due(5000, INTERVAL_MS), "an idle blind should not be tracked");
+
+  state.start(1000);
+  require(!state.poll_due(2000, INTERVAL_MS), "polls should wait for the tracking interval");
+  require(state.poll_due(3000, INTERVAL_MS), "a moving blind should be polled at the interval");
+  state.mark_polled(3000);
+  require(!state.poll_due(4000, INTERVAL_MS), "polling should restart the interval");
+
+  require(!feed(state, "!USZ<40b180,RA6;", 3400) && state.moving,
+          "an in-motion reply should keep the blind moving");
+  require(feed(state, "!USZr060b180,RA6;", 7000) && !state.moving,
+          "a final position should end the motion straight away");
+  require(!state.poll_due(9000, INTERVAL_MS), "an arrived blind should not be polled again");
+  require(!feed(state, "!USZr060b180,RA6;", 9500), "repeat final positions are not arrivals");
+}
+
+void test_unprompted_motion_is_tracked() {
+  MotionState state;
+  require(!feed(state, "!USZ<25b180,RA6;", 1000) && state.moving,
+          "motion reported without a command from us should still be tracked");
+  require(state.poll_due(3000, INTERVAL_MS), "the blind should be polled until it arrives");
+}
+
+void test_motion_times_out_without_arrival() {
+  MotionState state;
+  state.start(0);
+  require(!state.expire(TIMEOUT_MS - 1, TIMEOUT_MS), "motion should last up to the timeout");
+  feed(state, "!USZ<40b180,RA6;", 60000);
+  require(!state.expire(TIMEOUT_MS + 1000, TIMEOUT_MS),
+          "in-motion reports should extend the timeout");
+  require(state.expire(60000 + TIMEOUT_MS, TIMEOUT_MS) && !state.moving,
+          "a blind silent for the timeout should leave motion state");
+  require(!state.expire(60000 + TIMEOUT_MS + 1, TIMEOUT_MS), "expiry should only fire once");
+}
+
+void test_learned_arrival_spaces_polls() {
+  MotionState state;
+  state.start(0);
+  state.expect_arrival(0, 60000);
+  require(!state.poll_due(19900, INTERVAL_MS) && state.poll_due(20000, INTERVAL_MS),
+          "the first poll should wait until half the remaining travel passed");
+  uint32_t polls = 0;
+  uint32_t last_poll = 0;
+  for (uint32_t now = 100; now <= 60000; now += 100) {
+    if (state.poll_due(now, INTERVAL_MS)) {
+      state.mark_polled(now);
+      polls++;
+      last_poll = now;
+    }
+  }
+  require(polls <= 10, "a known 60 s travel should need far fewer than 30 polls");
+  require(last_poll >= 58000, "polls should close in on the expected arrival");
+  require(state.poll_due(last_poll + INTERVAL_MS, INTERVAL_MS),
+          "after the expected arrival polls should return to the interval");
+
+  state.start(70000);
+  require(!state.arrival_known && state.poll_due(70000 + INTERVAL_MS, INTERVAL_MS),
+          "a new command should forget the previous arrival");
+}
+
+void test_stop_and_disabled_interval() {
+  MotionState state;
+  state.start(0);
+  require(!state.poll_due(5000, 0), "an interval of 0 disables tracking polls");
+  state.stop();
+  require(!state.moving && !state.poll_due(5000, INTERVAL_MS), "stop should end tracking");
+}
+
+}  // namespace
+
+int main() {
+  test_motion_polls_until_arrival();
+  test_unprompted_motion_is_tracked();
+  test_motion_times_out_without_arrival();
+  test_learned_arrival_spaces_polls();
+  test_stop_and_disabled_interval();
+  std::cout << "motion tracker tests passed" << std::endl;
+  return 0;
+}
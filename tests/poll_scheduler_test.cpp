@@ -0,0 +1,110 @@
+#include "poll_scheduler.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using esphome::arc_bridge::POLL_URGENCY_NEVER_HEARD;
+using esphome::arc_bridge::POLL_URGENCY_OVERDUE;
+using esphome::arc_bridge::PollState;
+using esphome::arc_bridge::poll_urgency;
+
+namespace {
+
+constexpr uint32_t MIN_AGE_MS = 60000;
+
+void require(bool condition, const std::string &message) {
+  if (!condition) {
+    std::cerr << "FAIL: " << message << std::endl;
+    std::exit(1);
+  }
+}
+
+PollState heard_at(uint32_t heard_ms) {
+  PollState state;
+  state.mark_heard(heard_ms);
+  return state;
+}
+
+void test_recently_heard_blinds_are_skipped() {
+  const PollState state = heard_at(100000);
+  require(poll_urgency(state, 130000, MIN_AGE_MS) == 0,
+          "a blind heard 30 s ago should not be polled");
+  require(poll_urgency(state, 160000, MIN_AGE_MS) > 0,
+          "a blind silent for the minimum age should be polled");
+  require(state.age_ms(160000) == 60000, "age should count from the last frame heard");
+}
+
+void test_most_stale_blind_ranks_first() {
+  const PollState old_blind = heard_at(0);
+  const PollState recent_blind = heard_at(200000);
+  require(poll_urgency(old_blind, 300000, MIN_AGE_MS) >
+              poll_urgency(recent_blind, 300000, MIN_AGE_MS),
+          "the blind heard longest ago should be polled first");
+
+  const PollState silent;
+  require(poll_urgency(silent, 300000, MIN_AGE_MS) == POLL_URGENCY_NEVER_HEARD &&
+              silent.age_ms(300000) == UINT32_MAX,
+          "a blind never heard from should outrank every other blind");
+}
+
+void test_weight_scales_staleness() {
+  PollState eager = heard_at(200000);
+  eager.weight = 3.0f;
+  const PollState normal = heard_at(100000);
+  require(poll_urgency(eager, 300000, MIN_AGE_MS) > poll_urgency(normal, 300000, MIN_AGE_MS),
+          "a weight of 3 should rank 100 s of silence above 200 s at weight 1");
+
+  PollState idle = heard_at(0);
+  idle.weight = 0.0f;
+  require(poll_urgency(idle, 300000, MIN_AGE_MS) == 1,
+          "a zero weight should still poll an old blind, behind everything else");
+}
+
+void test_max_staleness_target() {
+  PollState target = heard_at(0);
+  target.max_staleness_ms = 30000;
+  require(poll_urgency(target, 20000, MIN_AGE_MS) == 0,
+          "a blind within its target and minimum age should be skipped");
+  require(poll_urgency(target, 35000, MIN_AGE_MS) == POLL_URGENCY_OVERDUE + 5000,
+          "a target shorter than the minimum age should still be honoured");
+
+  PollState heavy = heard_at(0);
+  heavy.weight = 100.0f;
+  require(poll_urgency(target, 40000, MIN_AGE_MS) > poll_urgency(heavy, 3000000, MIN_AGE_MS),
+          "an overdue blind should outrank any blind within its target");
+}
+
+void test_pending_poll_is_not_repeated() {
+  PollState state = heard_at(0);
+  state.mark_polled(100000);
+  require(poll_urgency(state, 110000, MIN_AGE_MS) == 0,
+          "a blind polled moments ago should get time to answer");
+  require(poll_urgency(state, 160000, MIN_AGE_MS) > 0,
+          "an unanswered poll should be retried after the minimum age");
+
+  PollState silent;
+  silent.mark_polled(100000);
+  require(poll_urgency(silent, 110000, MIN_AGE_MS) == 0,
+          "a never-heard blind should not be polled on every tick");
+}
+
+void test_millis_rollover() {
+  const PollState state = heard_at(UINT32_MAX - 10000);
+  require(poll_urgency(state, 20000, MIN_AGE_MS) == 0,
+          "age should be measured across a millis() rollover");
+  require(state.age_ms(20000) == 30001, "age should wrap with millis()");
+}
+
+}  // namespace
+
+int main() {
+  test_recently_heard_blinds_are_skipped();
+  test_most_stale_blind_ranks_first();
+  test_weight_scales_staleness();
+  test_max_staleness_target();
+  test_pending_poll_is_not_repeated();
+  test_millis_rollover();
+  std::cout << "poll scheduler tests passed" << std::endl;
+  return 0;
+}
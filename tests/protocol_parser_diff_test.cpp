@@ -0,0 +1,130 @@
+#include "legacy_protocol_parser.h"
+#include "protocol.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using esphome::arc_bridge::ParsedFrame;
+using esphome::arc_bridge::parse_arc_frame;
+
+namespace legacy = esphome::arc_bridge::legacy;
+
+namespace {
+
+void require(bool condition, const std::string &message) {
+  if (!condition) {
+    std::cerr << "FAIL: " << message << std::endl;
+    std::exit(1);
+  }
+}
+
+// Every frame used by the existing parser, pairing and README examples.
+const std::vector<std::string> TEST_VECTORS = {
+    "!USZr100b180,RA6;", "!USZ<09b00;",  "!QJ0o,R98;",   "!QJ0s,R9D;",  "!QJ0oA,R9C;",
+    "!QJ0m050,R9C;",     "!USZEnl;",     "!USZEnp;",     "!USZA;",      "!USZEdf;",
+    "!USZU;",            "!USZpVc123;",  "!USZpSc028;",  "!USZvA21;",   "!USZpP03;",
+    "!QJ0A;",            "!QJ0Edf;",     "!USZr100b180;", "!NOMvD22,R9C;", "!USZpVc1180,RB2;",
+    "!USZr050b000,R5F;", "!USZ<55b00,R60;", "!USZE;",    "!USZEbz;",    "!USZ;",
+    "!USZr;",            "!USZ<;",       "!USZ<r40;",    "!USZRz1;",    "!USZvA;",
+    "!USZvA2;",          "!USZv1A21;",   "!USZpP0;",     "!USZpP0!;",   "!USZpVc;",
+    "USZr100;",          "!USZr100",     "!US;",         "!USZr100,Enl;", "!USZ,Enp,r010;",
+};
+
+std::string describe(const std::string &frame) { return "frame '" + frame + "'"; }
+
+template<typename T>
+void require_optional(const esphome_arc_bridge_std_optional::optional<T> &expected, bool present,
+                      const T &actual, const std::string &field, const std::string &frame) {
+  require(static_cast<bool>(expected) == present, describe(frame) + " presence of " + field);
+  if (expected) {
+    require(*expected == actual, describe(frame) + " value of " + field);
+  }
+}
+
+void compare(const std::string &frame) {
+  const legacy::ParsedFrame expected = legacy::parse_arc_frame(frame);
+  const ParsedFrame actual = parse_arc_frame(frame);
+
+  require(expected.valid == actual.valid, describe(frame) + " validity");
+  if (!expected.valid) {
+    return;
+  }
+
+  require(expected.id == std::string(actual.id_view()), describe(frame) + " id");
+  require(expected.reply_token.substr(0, ParsedFrame::MAX_REPLY_TOKEN_LENGTH) ==
+              std::string(actual.reply_token_view()),
+          describe(frame) + " reply token");
+  require(expected.address_ack == actual.address_ack, describe(frame) + " address ack");
+  require(expected.position_in_motion == actual.position_in_motion, describe(frame) + " motion");
+  require(expected.lost_link == actual.lost_link, describe(frame) + " lost link");
+  require(expected.not_paired == actual.not_paired, describe(frame) + " not paired");
+  require(expected.no_position == actual.no_position, describe(frame) + " no position");
+
+  require_optional<int>(expected.position_percent, actual.has(ParsedFrame::POSITION),
+                        actual.position_percent, "position", frame);
+  require_optional<int>(expected.tilt_degrees, actual.has(ParsedFrame::TILT), actual.tilt_degrees,
+                        "tilt", frame);
+  require_optional<int>(expected.rssi_raw, actual.has(ParsedFrame::RSSI), actual.rssi_raw, "rssi",
+                        frame);
+  require_optional<int>(expected.voltage_centivolts, actual.has(ParsedFrame::VOLTAGE),
+                        actual.voltage_centivolts, "voltage", frame);
+  require_optional<int>(expected.speed_rpm, actual.has(ParsedFrame::SPEED), actual.speed_rpm,
+                        "speed", frame);
+  require_optional<char>(expected.motor_type_code, actual.has(ParsedFrame::VERSION),
+                         actual.motor_type_code, "motor type", frame);
+  require_optional<std::string>(expected.version_code, actual.has(ParsedFrame::VERSION),
+                                std::string(actual.version_code_view()), "version code", frame);
+  require_optional<int>(expected.version_major, actual.has(ParsedFrame::VERSION_NUMBER),
+                        actual.version_major, "version major", frame);
+  require_optional<int>(expected.version_minor, actual.has(ParsedFrame::VERSION_NUMBER),
+                        actual.version_minor, "version minor", frame);
+  require_optional<std::string>(expected.limits_code, actual.has(ParsedFrame::LIMITS),
+                                std::string(actual.limits_code_view()), "limits", frame);
+  require_optional<std::string>(expected.error_code, actual.has(ParsedFrame::ERROR),
+                                std::string(actual.error_code_view()), "error", frame);
+}
+
+void test_existing_vectors_match() {
+  for (const auto &frame : TEST_VECTORS) {
+    compare(frame);
+  }
+}
+
+// Deterministic token soup built from the markers the parser recognises, so
+// marker ordering and overlap quirks are exercised beyond the fixed vectors.
+void test_generated_frames_match() {
+  static const char *const TOKENS[] = {
+      "r",  "r100", "<",   "<42", "b",  "b180", "R",   "RA6", "Rz",  "v",  "vA21", "vD2",
+      "p",  "pP",   "pP03", "pVc", "pVc1234", "pSc", "pSc28", "E",  "Enl", "Enp", "Edf", "A",
+      "U",  ",",    "o",   "m050", "c",  "s",   "x",   "9",   "!",   "",
+  };
+  constexpr size_t TOKEN_COUNT = sizeof(TOKENS) / sizeof(TOKENS[0]);
+
+  uint32_t state = 0x12345678u;
+  auto next = [&state]() {
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+  };
+
+  for (int i = 0; i < 20000; i++) {
+    std::string frame = "!QJ0";
+    const uint32_t parts = next() % 5;
+    for (uint32_t part = 0; part < parts; part++) {
+      frame += TOKENS[next() % TOKEN_COUNT];
+    }
+    frame += ';';
+    compare(frame);
+  }
+}
+
+}  // namespace
+
+int main() {
+  test_existing_vectors_match();
+  test_generated_frames_match();
+  std::cout << "protocol parser differential tests passed" << std::endl;
+  return 0;
+}
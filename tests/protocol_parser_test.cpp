@@ -19,14 +19,14 @@ void require(bool condition, const std::string &message) {
 void test_position_and_rssi() {
   const ParsedFrame frame = parse_arc_frame("!USZr100b180,RA6;");
   require(frame.valid, "position/RSSI frame should parse");
-  require(frame.id == "USZ", "position/RSSI frame should preserve the blind id");
-  require(frame.reply_token == "r100b180",
+  require(frame.id_view() == "USZ", "position/RSSI frame should preserve the blind id");
+  require(frame.reply_token_view() == "r100b180",
           "position/RSSI frame should preserve the leading reply token");
-  require(static_cast<bool>(frame.position_percent) && *frame.position_percent == 100,
+  require(frame.has(ParsedFrame::POSITION) && frame.position_percent == 100,
           "position/RSSI frame should extract the final position");
-  require(static_cast<bool>(frame.tilt_degrees) && *frame.tilt_degrees == 180,
+  require(frame.has(ParsedFrame::TILT) && frame.tilt_degrees == 180,
           "position/RSSI frame should extract the tilt");
-  require(static_cast<bool>(frame.rssi_raw) && *frame.rssi_raw == 0xA6,
+  require(frame.has(ParsedFrame::RSSI) && frame.rssi_raw == 0xA6,
           "position/RSSI frame should extract the RSSI byte");
   require(!frame.position_in_motion, "final position frame should not be marked moving");
 }
@@ -34,28 +34,28 @@ void test_position_and_rssi() {
 void test_in_motion_position() {
   const ParsedFrame frame = parse_arc_frame("!USZ<09b00;");
   require(frame.valid, "in-motion frame should parse");
-  require(frame.reply_token == "<09b00",
+  require(frame.reply_token_view() == "<09b00",
           "in-motion frame should preserve the leading reply token");
-  require(static_cast<bool>(frame.position_percent) && *frame.position_percent == 9,
+  require(frame.has(ParsedFrame::POSITION) && frame.position_percent == 9,
           "in-motion frame should extract the current position");
   require(frame.position_in_motion, "in-motion frame should be marked moving");
 }
 
 void test_motion_echo_tokens() {
   const ParsedFrame open_echo = parse_arc_frame("!QJ0o,R98;");
-  require(open_echo.valid && open_echo.reply_token == "o",
+  require(open_echo.valid && open_echo.reply_token_view() == "o",
           "open echo should preserve the immediate reply token");
 
   const ParsedFrame stop_echo = parse_arc_frame("!QJ0s,R9D;");
-  require(stop_echo.valid && stop_echo.reply_token == "s",
+  require(stop_echo.valid && stop_echo.reply_token_view() == "s",
           "stop echo should preserve the immediate reply token");
 
   const ParsedFrame jog_echo = parse_arc_frame("!QJ0oA,R9C;");
-  require(jog_echo.valid && jog_echo.reply_token == "oA",
+  require(jog_echo.valid && jog_echo.reply_token_view() == "oA",
           "jog-open echo should preserve the immediate reply token");
 
   const ParsedFrame move_echo = parse_arc_frame("!QJ0m050,R9C;");
-  require(move_echo.valid && move_echo.reply_token == "m050",
+  require(move_echo.valid && move_echo.reply_token_view() == "m050",
           "move echo should preserve the immediate reply token");
 }
 
@@ -70,8 +70,8 @@ void test_unavailable_and_pairing_states() {
   require(address_ack.valid && address_ack.address_ack, "A should map to an address acknowledgement");
 
   const ParsedFrame generic_error = parse_arc_frame("!USZEdf;");
-  require(generic_error.valid && static_cast<bool>(generic_error.error_code) &&
-              *generic_error.error_code == "df",
+  require(generic_error.valid && generic_error.has(ParsedFrame::ERROR) &&
+              generic_error.error_code_view() == "df",
           "generic Exx should extract the error code");
   require(!generic_error.lost_link && !generic_error.not_paired,
           "generic Exx errors should not be remapped to Enl/Enp states");
@@ -82,25 +82,25 @@ void test_unavailable_and_pairing_states() {
 
 void test_extended_queries() {
   const ParsedFrame voltage = parse_arc_frame("!USZpVc123;");
-  require(static_cast<bool>(voltage.voltage_centivolts) && *voltage.voltage_centivolts == 123,
+  require(voltage.has(ParsedFrame::VOLTAGE) && voltage.voltage_centivolts == 123,
           "pVc should extract the voltage payload");
 
   const ParsedFrame speed = parse_arc_frame("!USZpSc028;");
-  require(static_cast<bool>(speed.speed_rpm) && *speed.speed_rpm == 28,
+  require(speed.has(ParsedFrame::SPEED) && speed.speed_rpm == 28,
           "pSc should extract the speed payload");
 
   const ParsedFrame version = parse_arc_frame("!USZvA21;");
-  require(static_cast<bool>(version.version_code) && *version.version_code == "A21",
+  require(version.has(ParsedFrame::VERSION) && version.version_code_view() == "A21",
           "version should extract the raw motor version");
-  require(static_cast<bool>(version.motor_type_code) && *version.motor_type_code == 'A',
+  require(version.has(ParsedFrame::VERSION) && version.motor_type_code == 'A',
           "version should extract the motor type");
-  require(static_cast<bool>(version.version_major) && *version.version_major == 2,
+  require(version.has(ParsedFrame::VERSION_NUMBER) && version.version_major == 2,
           "version should extract the major version");
-  require(static_cast<bool>(version.version_minor) && *version.version_minor == 1,
+  require(version.has(ParsedFrame::VERSION_NUMBER) && version.version_minor == 1,
           "version should extract the minor version");
 
   const ParsedFrame limits = parse_arc_frame("!USZpP03;");
-  require(static_cast<bool>(limits.limits_code) && *limits.limits_code == "03",
+  require(limits.has(ParsedFrame::LIMITS) && limits.limits_code_view() == "03",
           "pP should extract the limits code");
 }
 
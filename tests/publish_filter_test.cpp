@@ -0,0 +1,110 @@
+#include "publish_filter.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using esphome::arc_bridge::PublishFilter;
+using esphome::arc_bridge::PublishPolicy;
+using esphome::arc_bridge::PublishSlot;
+using esphome::arc_bridge::SensorKind;
+
+namespace {
+
+void require(bool condition, const std::string &message) {
+  if (!condition) {
+    std::cerr << "FAIL: " << message << std::endl;
+    std::exit(1);
+  }
+}
+
+void test_numeric_values_publish_on_change_beyond_delta() {
+  PublishFilter filter;
+  filter.set_policy(SensorKind::VOLTAGE, {0.05f, 0, 60000});
+  PublishSlot slot;
+
+  require(filter.admit(slot, SensorKind::VOLTAGE, 12.30f, 0), "the first value should publish");
+  require(!filter.admit(slot, SensorKind::VOLTAGE, 12.30f, 1000), "repeats should be dropped");
+  require(!filter.admit(slot, SensorKind::VOLTAGE, 12.33f, 2000),
+          "changes below the delta should be dropped");
+  require(!filter.admit(slot, SensorKind::VOLTAGE, 12.27f, 3000),
+          "the delta should be measured from the last published value");
+  require(filter.admit(slot, SensorKind::VOLTAGE, 12.20f, 4000),
+          "changes beyond the delta should publish");
+  require(filter.admit(slot, SensorKind::VOLTAGE, 12.20f, 64000),
+          "an unchanged value should publish again at the heartbeat");
+
+  require(filter.stats(SensorKind::VOLTAGE).emitted == 3 &&
+              filter.stats(SensorKind::VOLTAGE).suppressed == 3,
+          "emitted and suppressed publishes should be counted per kind");
+  require(filter.stats(SensorKind::SPEED).emitted == 0, "other kinds should be unaffected");
+}
+
+void test_min_interval_holds_back_changes_but_not_availability() {
+  PublishFilter filter;
+  filter.set_policy(SensorKind::LINK_QUALITY, {2.0f, 30000, 0});
+  PublishSlot slot;
+
+  require(filter.admit(slot, SensorKind::LINK_QUALITY, -60.0f, 0), "first value");
+  require(!filter.admit(slot, SensorKind::LINK_QUALITY, -70.0f, 10000),
+          "a change inside the minimum interval should be held back");
+  require(filter.admit(slot, SensorKind::LINK_QUALITY, -70.0f, 30000),
+          "the held back change should publish with the next report after the interval");
+  require(filter.admit(slot, SensorKind::LINK_QUALITY, NAN, 31000),
+          "becoming unavailable should skip the minimum interval");
+  require(!filter.admit(slot, SensorKind::LINK_QUALITY, NAN, 32000),
+          "staying unavailable should not publish");
+  require(filter.admit(slot, SensorKind::LINK_QUALITY, -71.0f, 33000),
+          "becoming available again should skip the minimum interval");
+  require(!filter.admit(slot, SensorKind::LINK_QUALITY, -71.0f, 999000),
+          "a zero heartbeat should never repeat a value");
+}
+
+void test_text_values_publish_on_change() {
+  PublishFilter filter;
+  filter.set_policy(SensorKind::STATUS, {0.0f, 0, 900000});
+  PublishSlot slot;
+
+  require(filter.admit_text(slot, SensorKind::STATUS, "Online", 0), "first status");
+  require(!filter.admit_text(slot, SensorKind::STATUS, "Online", 10000), "repeated status");
+  require(filter.admit_text(slot, SensorKind::STATUS, "Offline", 20000), "changed status");
+  require(filter.admit_text(slot, SensorKind::STATUS, "Online", 30000), "restored status");
+  require(filter.admit_text(slot, SensorKind::STATUS, "Online", 930000), "status heartbeat");
+}
+
+void test_polled_install_mostly_suppresses_repeats() {
+  // 30 blinds each answering a poll every 10 s for an hour, always Online and
+  // with link quality jittering by a dBm.
+  PublishFilter filter;
+  std::vector<PublishSlot> status(30);
+  std::vector<PublishSlot> lq(30);
+  for (uint32_t now = 0; now < 3600000; now += 10000) {
+    for (size_t blind = 0; blind < status.size(); blind++) {
+      filter.admit_text(status[blind], SensorKind::STATUS, "Online", now);
+      const float dbm = -65.0f + static_cast<float>((now / 10000 + blind) % 3) * 0.5f;
+      filter.admit(lq[blind], SensorKind::LINK_QUALITY, dbm, now);
+    }
+  }
+  const auto &status_stats = filter.stats(SensorKind::STATUS);
+  const auto &lq_stats = filter.stats(SensorKind::LINK_QUALITY);
+  std::cout << "30 blinds for 1 h: status emitted " << status_stats.emitted << " suppressed "
+            << status_stats.suppressed << ", link quality emitted " << lq_stats.emitted
+            << " suppressed " << lq_stats.suppressed << std::endl;
+  require(status_stats.emitted + status_stats.suppressed == 30 * 360, "every report counted");
+  require(status_stats.emitted == 30 * 4,
+          "status should publish once plus a heartbeat every 15 minutes");
+  require(lq_stats.emitted == 30 * 4, "link quality jitter below the delta should not publish");
+}
+
+}  // namespace
+
+int main() {
+  test_numeric_values_publish_on_change_beyond_delta();
+  test_min_interval_holds_back_changes_but_not_availability();
+  test_text_values_publish_on_change();
+  test_polled_install_mostly_suppresses_repeats();
+  std::cout << "publish filter tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,101 @@
+from __future__ import annotations
+
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+
+
+def find_compiler() -> str:
+    candidates = []
+    if os.environ.get("CXX"):
+        candidates.append(os.environ["CXX"])
+    candidates.append(
+        str(Path.home() / ".platformio" / "packages" / "toolchain-gccmingw32" / "bin" / "g++.exe")
+    )
+    candidates.extend(["c++", "g++", "clang++"])
+
+    for candidate in candidates:
+        resolved = shutil.which(candidate)
+        if resolved:
+            return resolved
+        if Path(candidate).exists():
+            return candidate
+    raise SystemExit("No C++ compiler found in PATH")
+
+
+def find_std_flag(compiler: str, repo_root: Path) -> str:
+    candidates = ["-std=c++17", "-std=gnu++17", "-std=c++1z", "-std=gnu++1z"]
+    with tempfile.TemporaryDirectory() as tmpdir:
+        source = Path(tmpdir) / "probe.cpp"
+        binary = Path(tmpdir) / ("probe.exe" if os.name == "nt" else "probe")
+        source.write_text("int main() { return 0; }\n", encoding="utf-8")
+        for flag in candidates:
+            result = subprocess.run(
+                [compiler, flag, str(source), "-o", str(binary)],
+                cwd=repo_root,
+                stdout=subprocess.DEVNULL,
+                stderr=subprocess.DEVNULL,
+            )
+            if result.returncode == 0:
+                return flag
+    raise SystemExit("No supported C++17-compatible standard flag found for the detected compiler")
+
+
+def main() -> None:
+    repo_root = Path(__file__).resolve().parents[1]
+    component_dir = repo_root / "esphome" / "components" / "arc_bridge"
+    test_cpp = repo_root / "tests" / "bridge_engine_test.cpp"
+    alloc_tracker_cpp = repo_root / "tests" / "alloc_tracker.cpp"
+    virtual_hub_cpp = repo_root / "tests" / "virtual_hub.cpp"
+    sources = [
+        component_dir / "battery.cpp",
+        component_dir / "blind_registry.cpp",
+        component_dir / "bridge_engine.cpp",
+        component_dir / "cover_motion.cpp",
+        component_dir / "delivery.cpp",
+        component_dir / "frame_extractor.cpp",
+        component_dir / "latency_histogram.cpp",
+        component_dir / "loop_profiler.cpp",
+        component_dir / "motion_batch.cpp",
+        component_dir / "motion_tracker.cpp",
+        component_dir / "pairing.cpp",
+        component_dir / "poll_scheduler.cpp",
+        component_dir / "protocol.cpp",
+        component_dir / "publish_filter.cpp",
+        component_dir / "startup_guard.cpp",
+        component_dir / "startup_sweep.cpp",
+        component_dir / "state_cache.cpp",
+        component_dir / "travel_model.cpp",
+        component_dir / "tx_queue.cpp",
+        component_dir / "uart_trace.cpp",
+    ]
+
+    compiler = find_compiler()
+    std_flag = find_std_flag(compiler, repo_root)
+    with tempfile.TemporaryDirectory() as tmpdir:
+        binary = Path(tmpdir) / ("bridge_engine_test.exe" if os.name == "nt" else "bridge_engine_test")
+        cmd = [
+            compiler,
+            std_flag,
+            "-Wall",
+            "-Wextra",
+            "-pedantic",
+            "-DARC_BRIDGE_HOST",
+            str(test_cpp),
+            str(alloc_tracker_cpp),
+            str(virtual_hub_cpp),
+            *[str(source) for source in sources],
+            "-I",
+            str(component_dir),
+            "-o",
+            str(binary),
+        ]
+        subprocess.run(cmd, check=True, cwd=repo_root)
+        subprocess.run([str(binary)], check=True, cwd=repo_root)
+
+
+if __name__ == "__main__":
+    main()
@@ -282,6 +282,26 @@ text_sensor:
     entity_category: diagnostic
 """
 
+INVALID_BLIND_ID_BODY = """
+cover:
+  - platform: arc_bridge
+    bridge_id: arc
+    id: usz
+    name: "Office Blind"
+    device_class: shade
+    blind_id: "US"
+
+text_sensor:
+  - platform: template
+    id: pairing_status
+    name: "ARC Pairing Status"
+    entity_category: diagnostic
+  - platform: template
+    id: last_paired_id
+    name: "ARC Last Paired ID"
+    entity_category: diagnostic
+"""
+
 
 def run_esphome(args: list[str], cwd: Path) -> None:
     subprocess.run([sys.executable, "-m", "esphome", *args], check=True, cwd=cwd)
@@ -293,6 +313,14 @@ def expect_esphome_failure(args: list[str], cwd: Path) -> None:
         raise SystemExit(f"Expected failure but command succeeded: {' '.join(args)}")
 
 
+def expect_generated_code(config_path: Path, name: str, snippets: list[str]) -> None:
+    main_cpp = config_path.parent / ".esphome" / "build" / name / "src" / "main.cpp"
+    source = main_cpp.read_text(encoding="utf-8")
+    for snippet in snippets:
+        if snippet not in source:
+            raise SystemExit(f"Expected {snippet!r} in the code generated for {config_path.name}")
+
+
 def write_config(path: Path, name: str, framework: str, component_path: str, body: str) -> None:
     path.write_text(
         COMMON_CONFIG.format(name=name, framework=framework, component_path=component_path) + body,
@@ -313,6 +341,12 @@ def main() -> None:
             write_config(config_path, name, framework, component_path, VALID_CONFIG_BODY)
             run_esphome(["config", str(config_path)], repo_root)
             run_esphome(["compile", str(config_path)], repo_root)
+            # ARC covers run their own loop for motion interpolation and timeouts.
+            expect_generated_code(
+                config_path,
+                name,
+                ["App.register_component(usz)", "App.register_component(khn)"],
+            )
 
         battery_only_path = tmp_root / "battery-only.yaml"
         write_config(
@@ -329,6 +363,7 @@ def main() -> None:
             "group-duplicate.yaml": INVALID_GROUP_DUPLICATE_BODY,
             "group-nested.yaml": INVALID_GROUP_NESTED_BODY,
             "group-self.yaml": INVALID_GROUP_SELF_BODY,
+            "blind-id-length.yaml": INVALID_BLIND_ID_BODY,
         }
 
         for filename, body in invalid_configs.items():
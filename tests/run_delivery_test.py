@@ -48,6 +48,7 @@ def main() -> None:
     repo_root = Path(__file__).resolve().parents[1]
     component_dir = repo_root / "esphome" / "components" / "arc_bridge"
     test_cpp = repo_root / "tests" / "delivery_test.cpp"
+    alloc_tracker_cpp = repo_root / "tests" / "alloc_tracker.cpp"
     delivery_cpp = component_dir / "delivery.cpp"
 
     compiler = find_compiler()
@@ -61,6 +62,7 @@ def main() -> None:
             "-Wextra",
             "-pedantic",
             str(test_cpp),
+            str(alloc_tracker_cpp),
             str(delivery_cpp),
             "-I",
             str(component_dir),
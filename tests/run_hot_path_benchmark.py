@@ -0,0 +1,151 @@
+from __future__ import annotations
+
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import tempfile
+from pathlib import Path
+
+
+def find_compiler() -> str:
+    candidates = []
+    if os.environ.get("CXX"):
+        candidates.append(os.environ["CXX"])
+    candidates.append(
+        str(Path.home() / ".platformio" / "packages" / "toolchain-gccmingw32" / "bin" / "g++.exe")
+    )
+    candidates.extend(["c++", "g++", "clang++"])
+
+    for candidate in candidates:
+        resolved = shutil.which(candidate)
+        if resolved:
+            return resolved
+        if Path(candidate).exists():
+            return candidate
+    raise SystemExit("No C++ compiler found in PATH")
+
+
+def find_std_flag(compiler: str, repo_root: Path) -> str:
+    candidates = ["-std=c++17", "-std=gnu++17", "-std=c++1z", "-std=gnu++1z"]
+    with tempfile.TemporaryDirectory() as tmpdir:
+        source = Path(tmpdir) / "probe.cpp"
+        binary = Path(tmpdir) / ("probe.exe" if os.name == "nt" else "probe")
+        source.write_text("int main() { return 0; }\n", encoding="utf-8")
+        for flag in candidates:
+            result = subprocess.run(
+                [compiler, flag, str(source), "-o", str(binary)],
+                cwd=repo_root,
+                stdout=subprocess.DEVNULL,
+                stderr=subprocess.DEVNULL,
+            )
+            if result.returncode == 0:
+                return flag
+    raise SystemExit("No supported C++17-compatible standard flag found for the detected compiler")
+
+
+def print_table(results: dict, baseline: dict | None) -> None:
+    header = f"{'benchmark':<52} {'ns/op':>10} {'allocs/op':>10}"
+    if baseline is not None:
+        header += f" {'base ns/op':>11} {'delta':>8} {'base allocs':>11}"
+    print(header)
+    for bench in results["benchmarks"]:
+        line = f"{bench['name']:<52} {bench['ns_per_op']:>10.1f} {bench['allocs_per_op']:>10.2f}"
+        if baseline is not None:
+            base = next((b for b in baseline["benchmarks"] if b["name"] == bench["name"]), None)
+            if base is None:
+                line += f" {'-':>11} {'new':>8} {'-':>11}"
+            else:
+                # A baseline that timed at 0 ns/op has no meaningful relative change.
+                if base["ns_per_op"] > 0:
+                    delta = (bench["ns_per_op"] - base["ns_per_op"]) / base["ns_per_op"] * 100.0
+                    delta_text = f"{delta:>+7.1f}%"
+                else:
+                    delta_text = f"{'n/a':>8}"
+                line += (
+                    f" {base['ns_per_op']:>11.1f} {delta_text} {base['allocs_per_op']:>11.2f}"
+                )
+        print(line)
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description="Run the host hot-path microbenchmarks.")
+    parser.add_argument("--output", type=Path, help="write the JSON results to this file")
+    parser.add_argument("--compare", type=Path, help="JSON results from an earlier run to diff against")
+    parser.add_argument("--quick", action="store_true", help="short runs for CI smoke testing")
+    args = parser.parse_args()
+
+    repo_root = Path(__file__).resolve().parents[1]
+    component_dir = repo_root / "esphome" / "components" / "arc_bridge"
+    group_dir = repo_root / "esphome" / "components" / "arc_bridge_group"
+    bench_cpp = repo_root / "tests" / "hot_path_benchmark.cpp"
+    sources = [
+        repo_root / "tests" / "alloc_tracker.cpp",
+        repo_root / "tests" / "virtual_hub.cpp",
+        component_dir / "battery.cpp",
+        component_dir / "blind_registry.cpp",
+        component_dir / "bridge_engine.cpp",
+        component_dir / "cover_motion.cpp",
+        component_dir / "delivery.cpp",
+        component_dir / "frame_extractor.cpp",
+        component_dir / "latency_histogram.cpp",
+        component_dir / "loop_profiler.cpp",
+        component_dir / "motion_batch.cpp",
+        component_dir / "motion_tracker.cpp",
+        component_dir / "pairing.cpp",
+        component_dir / "poll_scheduler.cpp",
+        component_dir / "protocol.cpp",
+        component_dir / "publish_filter.cpp",
+        component_dir / "startup_guard.cpp",
+        component_dir / "startup_sweep.cpp",
+        component_dir / "state_cache.cpp",
+        component_dir / "travel_model.cpp",
+        component_dir / "tx_queue.cpp",
+        component_dir / "uart_trace.cpp",
+        group_dir / "group_aggregate.cpp",
+        repo_root / "tests" / "legacy_protocol_parser.cpp",
+    ]
+
+    compiler = find_compiler()
+    std_flag = find_std_flag(compiler, repo_root)
+    with tempfile.TemporaryDirectory() as tmpdir:
+        binary = Path(tmpdir) / ("hot_path_benchmark.exe" if os.name == "nt" else "hot_path_benchmark")
+        cmd = [
+            compiler,
+            std_flag,
+            "-O2",
+            "-Wall",
+            "-Wextra",
+            "-pedantic",
+            "-DARC_BRIDGE_HOST",
+            str(bench_cpp),
+            *[str(source) for source in sources],
+            "-I",
+            str(component_dir),
+            "-I",
+            str(group_dir),
+            "-I",
+            str(repo_root / "tests"),
+            "-o",
+            str(binary),
+        ]
+        subprocess.run(cmd, check=True, cwd=repo_root)
+        run_cmd = [str(binary)]
+        if args.quick:
+            run_cmd.append("--quick")
+        output = subprocess.run(run_cmd, check=True, cwd=repo_root, capture_output=True, text=True)
+
+    results = json.loads(output.stdout)
+    results["compiler"] = compiler
+    if args.output:
+        args.output.write_text(json.dumps(results, indent=2) + "\n", encoding="utf-8")
+
+    baseline = None
+    if args.compare:
+        baseline = json.loads(args.compare.read_text(encoding="utf-8"))
+    print_table(results, baseline)
+
+
+if __name__ == "__main__":
+    main()
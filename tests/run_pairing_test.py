@@ -47,6 +47,7 @@ def main() -> None:
     repo_root = Path(__file__).resolve().parents[1]
     component_dir = repo_root / "esphome" / "components" / "arc_bridge"
     test_cpp = repo_root / "tests" / "pairing_test.cpp"
+    alloc_tracker_cpp = repo_root / "tests" / "alloc_tracker.cpp"
     pairing_cpp = component_dir / "pairing.cpp"
     protocol_cpp = component_dir / "protocol.cpp"
 
@@ -61,6 +62,7 @@ def main() -> None:
             "-Wextra",
             "-pedantic",
             str(test_cpp),
+            str(alloc_tracker_cpp),
             str(pairing_cpp),
             str(protocol_cpp),
             "-I",
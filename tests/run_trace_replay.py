@@ -0,0 +1,150 @@
+from __future__ import annotations
+
+import argparse
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+
+
+def find_compiler() -> str:
+    candidates = []
+    if os.environ.get("CXX"):
+        candidates.append(os.environ["CXX"])
+    candidates.append(
+        str(Path.home() / ".platformio" / "packages" / "toolchain-gccmingw32" / "bin" / "g++.exe")
+    )
+    candidates.extend(["c++", "g++", "clang++"])
+
+    for candidate in candidates:
+        resolved = shutil.which(candidate)
+        if resolved:
+            return resolved
+        if Path(candidate).exists():
+            return candidate
+    raise SystemExit("No C++ compiler found in PATH")
+
+
+def find_std_flag(compiler: str, repo_root: Path) -> str:
+    candidates = ["-std=c++17", "-std=gnu++17", "-std=c++1z", "-std=gnu++1z"]
+    with tempfile.TemporaryDirectory() as tmpdir:
+        source = Path(tmpdir) / "probe.cpp"
+        binary = Path(tmpdir) / ("probe.exe" if os.name == "nt" else "probe")
+        source.write_text("int main() { return 0; }\n", encoding="utf-8")
+        for flag in candidates:
+            result = subprocess.run(
+                [compiler, flag, str(source), "-o", str(binary)],
+                cwd=repo_root,
+                stdout=subprocess.DEVNULL,
+                stderr=subprocess.DEVNULL,
+            )
+            if result.returncode == 0:
+                return flag
+    raise SystemExit("No supported C++17-compatible standard flag found for the detected compiler")
+
+
+LOG_LINE = re.compile(r"uart_trace ([0-9A-F]{4}): ([0-9a-f]+)")
+
+
+def capture_bytes(path: Path) -> bytes:
+    """Returns the binary capture in `path`, or reassembles it from the hex
+    lines dump_uart_trace() wrote to a saved ESPHome log."""
+    data = path.read_bytes()
+    if data.startswith(b"ARCT"):
+        return data
+    chunks: dict[int, bytes] = {}
+    for line in data.decode("utf-8", errors="replace").splitlines():
+        match = LOG_LINE.search(line)
+        if match:
+            chunks[int(match.group(1), 16)] = bytes.fromhex(match.group(2))
+    capture = b""
+    for offset in sorted(chunks):
+        if offset != len(capture):
+            raise SystemExit(f"{path}: trace dump is missing bytes before offset {offset:#06x}")
+        capture += chunks[offset]
+    if not capture:
+        raise SystemExit(f"{path}: no UART trace capture or dump found")
+    return capture
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(
+        description="Replay a UART trace capture into the bridge engine on the host."
+    )
+    parser.add_argument(
+        "--capture",
+        type=Path,
+        help="binary capture or saved log with a dump_uart_trace() dump; "
+        "without it a virtual hub run is recorded and replayed as a self-test",
+    )
+    parser.add_argument("--quick", action="store_true", help="short parser runs for CI smoke testing")
+    args, replay_args = parser.parse_known_args()
+
+    repo_root = Path(__file__).resolve().parents[1]
+    component_dir = repo_root / "esphome" / "components" / "arc_bridge"
+    replay_cpp = repo_root / "tests" / "trace_replay.cpp"
+    alloc_tracker_cpp = repo_root / "tests" / "alloc_tracker.cpp"
+    virtual_hub_cpp = repo_root / "tests" / "virtual_hub.cpp"
+    sources = [
+        component_dir / "battery.cpp",
+        component_dir / "blind_registry.cpp",
+        component_dir / "bridge_engine.cpp",
+        component_dir / "cover_motion.cpp",
+        component_dir / "delivery.cpp",
+        component_dir / "frame_extractor.cpp",
+        component_dir / "latency_histogram.cpp",
+        component_dir / "loop_profiler.cpp",
+        component_dir / "motion_batch.cpp",
+        component_dir / "motion_tracker.cpp",
+        component_dir / "pairing.cpp",
+        component_dir / "poll_scheduler.cpp",
+        component_dir / "protocol.cpp",
+        component_dir / "publish_filter.cpp",
+        component_dir / "startup_guard.cpp",
+        component_dir / "startup_sweep.cpp",
+        component_dir / "state_cache.cpp",
+        component_dir / "travel_model.cpp",
+        component_dir / "tx_queue.cpp",
+        component_dir / "uart_trace.cpp",
+    ]
+
+    compiler = find_compiler()
+    std_flag = find_std_flag(compiler, repo_root)
+    with tempfile.TemporaryDirectory() as tmpdir:
+        binary = Path(tmpdir) / ("trace_replay.exe" if os.name == "nt" else "trace_replay")
+        cmd = [
+            compiler,
+            std_flag,
+            "-O2",
+            "-Wall",
+            "-Wextra",
+            "-pedantic",
+            "-DARC_BRIDGE_HOST",
+            str(replay_cpp),
+            str(alloc_tracker_cpp),
+            str(virtual_hub_cpp),
+            *[str(source) for source in sources],
+            "-I",
+            str(component_dir),
+            "-o",
+            str(binary),
+        ]
+        subprocess.run(cmd, check=True, cwd=repo_root)
+
+        run_cmd = [str(binary)]
+        if args.capture:
+            capture = Path(tmpdir) / "capture.bin"
+            capture.write_bytes(capture_bytes(args.capture))
+            run_cmd.append(str(capture))
+        else:
+            run_cmd.append("--self-test")
+        if args.quick:
+            run_cmd.append("--quick")
+        subprocess.run([*run_cmd, *replay_args], check=True, cwd=repo_root)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,98 @@
+#include "startup_guard.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using esphome::arc_bridge::StartupGuard;
+using esphome::arc_bridge::StartupGuardState;
+using esphome::arc_bridge::startup_guard_state_name;
+
+namespace {
+
+constexpr uint32_t BOOT_MS = 1000;
+
+void require(bool condition, const std::string &message) {
+  if (!condition) {
+    std::cerr << "FAIL: " << message << std::endl;
+    std::exit(1);
+  }
+}
+
+// Runs the guard the way the bridge loop does; `answer_ms` is when the hub
+// first answers a probe, 0 for never. Returns when the guard cleared.
+uint32_t run_guard(StartupGuard &guard, uint32_t answer_ms, uint32_t *probes = nullptr) {
+  guard.begin(BOOT_MS);
+  for (uint32_t now = BOOT_MS; now < BOOT_MS + 60000; now += 10) {
+    if (guard.update(now)) {
+      if (probes != nullptr) {
+        *probes = guard.probes_sent();
+      }
+      return now;
+    }
+    if (guard.probe_due(now)) {
+      guard.mark_probed(now);
+    }
+    if (answer_ms != 0 && now >= BOOT_MS + answer_ms && guard.probes_sent() > 0) {
+      guard.frame_received();
+    }
+  }
+  return 0;
+}
+
+void test_guard_clears_when_the_hub_answers() {
+  StartupGuard guard;
+  uint32_t probes = 0;
+  const uint32_t cleared = run_guard(guard, 700, &probes);
+  require(guard.cleared() && guard.state() == StartupGuardState::HUB_READY,
+          "a hub answer should clear the guard");
+  require(cleared - BOOT_MS <= 720 && guard.duration_ms() == cleared - BOOT_MS,
+          "the guard should clear right after the answer, not after 10 s");
+  require(probes == 1, "one probe should do when the hub answers it");
+  require(std::string(startup_guard_state_name(guard.state())) == "hub ready",
+          "states should have log names");
+}
+
+void test_guard_waits_for_the_uart_to_settle() {
+  StartupGuard guard;
+  guard.begin(BOOT_MS);
+  guard.frame_received();
+  require(!guard.update(BOOT_MS + 100) && !guard.probe_due(BOOT_MS + 100),
+          "nothing should clear or probe before the settle time");
+  require(guard.update(BOOT_MS + 500) && guard.duration_ms() == 500,
+          "an early frame should clear the guard at the settle time");
+}
+
+void test_guard_probes_until_the_upper_bound() {
+  StartupGuard guard;
+  uint32_t probes = 0;
+  const uint32_t cleared = run_guard(guard, 0, &probes);
+  require(guard.state() == StartupGuardState::TIMED_OUT && cleared - BOOT_MS == 10000,
+          "a silent hub should hold the guard for the full upper bound");
+  require(probes == 10, "a silent hub should be probed once a second after settling");
+
+  guard.set_max_ms(20000);
+  require(run_guard(guard, 15000) - BOOT_MS < 15100 &&
+              guard.state() == StartupGuardState::HUB_READY,
+          "a slow hub should still clear the guard within a longer bound");
+}
+
+void test_cleared_guard_ignores_frames() {
+  StartupGuard guard;
+  run_guard(guard, 0);
+  guard.frame_received();
+  require(guard.state() == StartupGuardState::TIMED_OUT && !guard.update(BOOT_MS + 20000),
+          "a cleared guard should stay as it cleared");
+  require(!guard.probe_due(BOOT_MS + 20000), "a cleared guard should not probe");
+}
+
+}  // namespace
+
+int main() {
+  test_guard_clears_when_the_hub_answers();
+  test_guard_waits_for_the_uart_to_settle();
+  test_guard_probes_until_the_upper_bound();
+  test_cleared_guard_ignores_frames();
+  std::cout << "startup guard tests passed" << std::endl;
+  return 0;
+}
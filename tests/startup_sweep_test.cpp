@@ -0,0 +1,124 @@
+#include "startup_sweep.h"
+#include "tx_queue.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using esphome::arc_bridge::BlindId;
+using esphome::arc_bridge::StartupSweep;
+using esphome::arc_bridge::SweepPhase;
+using esphome::arc_bridge::TxPacingClass;
+using esphome::arc_bridge::TxPriorityClass;
+using esphome::arc_bridge::TxQueueItem;
+using esphome::arc_bridge::TxScheduler;
+using esphome::arc_bridge::build_command_frame;
+using esphome::arc_bridge::tx_gap_ms_for;
+
+namespace {
+
+void require(bool condition, const std::string &message) {
+  if (!condition) {
+    std::cerr << "FAIL: " << message << std::endl;
+    std::exit(1);
+  }
+}
+
+void test_sweep_visits_every_blind_per_phase() {
+  StartupSweep sweep;
+  require(!sweep.active(), "a sweep should not run before it begins");
+  sweep.begin(3, 1000);
+  require(sweep.active() && sweep.started_ms() == 1000, "begin should start the sweep");
+
+  std::vector<std::pair<size_t, SweepPhase>> steps;
+  size_t blind = 0;
+  SweepPhase phase = SweepPhase::DONE;
+  while (sweep.next(blind, phase)) {
+    steps.emplace_back(blind, phase);
+  }
+  require(steps.size() == 9, "three blinds over three phases should take nine steps");
+  for (size_t i = 0; i < steps.size(); i++) {
+    require(steps[i].first == i % 3, "each phase should walk the blinds in order");
+    require(steps[i].second == static_cast<SweepPhase>(i / 3),
+            "every position should come before any telemetry, and static values last");
+  }
+  require(!sweep.active() && !sweep.aborted(), "a finished sweep is done, not aborted");
+
+  sweep.begin(0, 0);
+  require(!sweep.active(), "a bridge without blinds has nothing to sweep");
+}
+
+void test_abort_ends_the_sweep() {
+  StartupSweep sweep;
+  sweep.begin(30, 0);
+  size_t blind = 0;
+  SweepPhase phase = SweepPhase::DONE;
+  sweep.next(blind, phase);
+  sweep.abort();
+  require(!sweep.active() && sweep.aborted(), "abort should end the sweep");
+  require(!sweep.next(blind, phase), "an aborted sweep should not hand out more steps");
+  sweep.abort();
+  require(sweep.aborted(), "a second abort should be harmless");
+}
+
+// Feeds the sweep into a scheduler whenever its queue runs empty, the way the
+// bridge loop does, and returns when the last position query went out.
+uint32_t simulate_position_sweep(size_t blinds) {
+  StartupSweep sweep;
+  TxScheduler scheduler;
+  const uint32_t gap = tx_gap_ms_for(TxPacingClass::STANDARD);
+  uint32_t last_tx = 0;
+  uint32_t last_position_tx = 0;
+  size_t sent = 0;
+  sweep.begin(blinds, 0);
+  for (uint32_t now = 0; now < 600000; now += 10) {
+    size_t blind = 0;
+    SweepPhase phase = SweepPhase::DONE;
+    // Only positions are queried; the other phases have nothing to send.
+    while (scheduler.empty() && sweep.next(blind, phase)) {
+      if (phase != SweepPhase::POSITION) {
+        continue;
+      }
+      char text[4];
+      snprintf(text, sizeof(text), "B%02u", static_cast<unsigned>(blind));
+      TxQueueItem item;
+      item.is_poll = true;
+      item.blind_id = BlindId::from_text(text);
+      build_command_frame(item.frame, item.blind_id, 'r', "?");
+      scheduler.push(item, TxPriorityClass::BACKGROUND_POLL, now);
+    }
+    if (!scheduler.empty() && (sent == 0 || now - last_tx >= gap)) {
+      scheduler.complete(scheduler.select(now), now);
+      last_tx = now;
+      last_position_tx = now;
+      sent++;
+    }
+    if (!sweep.active() && scheduler.empty()) {
+      break;
+    }
+  }
+  require(sent == blinds, "every blind should be queried once");
+  return last_position_tx;
+}
+
+void test_sweep_runs_at_the_tx_gap() {
+  const uint32_t sweep_ms = simulate_position_sweep(30);
+  const uint32_t auto_poll_ms = 30 * 10000;
+  std::cout << "30 blinds: sweep " << sweep_ms << " ms, auto-poll " << auto_poll_ms << " ms"
+            << std::endl;
+  require(sweep_ms <= 30 * tx_gap_ms_for(TxPacingClass::STANDARD),
+          "the sweep should query back to back at the standard gap");
+  require(sweep_ms * 10 < auto_poll_ms, "the sweep should fill state ten times faster");
+}
+
+}  // namespace
+
+int main() {
+  test_sweep_visits_every_blind_per_phase();
+  test_abort_ends_the_sweep();
+  test_sweep_runs_at_the_tx_gap();
+  std::cout << "startup sweep tests passed" << std::endl;
+  return 0;
+}
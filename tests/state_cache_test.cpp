@@ -0,0 +1,110 @@
+#include "protocol.h"
+#include "state_cache.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+using esphome::arc_bridge::BlindId;
+using esphome::arc_bridge::BlindSnapshot;
+using esphome::arc_bridge::BlindStatus;
+using esphome::arc_bridge::ParsedFrame;
+using esphome::arc_bridge::blind_status_text;
+using esphome::arc_bridge::parse_arc_frame;
+
+namespace {
+
+void require(bool condition, const std::string &message) {
+  if (!condition) {
+    std::cerr << "FAIL: " << message << std::endl;
+    std::exit(1);
+  }
+}
+
+bool feed(BlindSnapshot &snapshot, const char *frame) {
+  const ParsedFrame parsed = parse_arc_frame(frame);
+  require(parsed.valid, std::string("parse ") + frame);
+  return snapshot.update(parsed);
+}
+
+void test_snapshot_keeps_the_last_reported_state() {
+  BlindSnapshot snapshot = BlindSnapshot::empty(BlindId::from_text("USZ"));
+  require(snapshot.matches(BlindId::from_text("USZ")) && snapshot.present == 0,
+          "an empty snapshot should belong to its blind and hold nothing");
+
+  require(feed(snapshot, "!USZr050b180,RA6;"), "a first position should change the snapshot");
+  require(snapshot.status == BlindStatus::ONLINE && snapshot.has(BlindSnapshot::POSITION) &&
+              snapshot.position == 50,
+          "a final position should be kept with an online status");
+  require(!feed(snapshot, "!USZr050b180,RA6;"), "a repeated reply should not need a save");
+  require(!feed(snapshot, "!USZ<40b180,RA6;") && snapshot.position == 50,
+          "in-motion positions should not be saved");
+
+  require(feed(snapshot, "!USZpVc123;") && snapshot.voltage_centivolts == 123,
+          "voltage should be kept");
+  require(feed(snapshot, "!USZvA21;") && snapshot.has(BlindSnapshot::VERSION),
+          "version should be kept");
+  require(feed(snapshot, "!USZpP03;") && std::strcmp(snapshot.limits_code, "03") == 0,
+          "limits should be kept");
+
+  require(feed(snapshot, "!USZEnl;") && snapshot.status == BlindStatus::OFFLINE &&
+              snapshot.position == 50,
+          "a lost link should keep the last position but mark the blind offline");
+  require(std::string(blind_status_text(snapshot.status)) == "Offline",
+          "statuses should map to the status sensor text");
+  require(blind_status_text(BlindStatus::UNKNOWN) == nullptr, "unknown has no text");
+}
+
+void test_static_values_round_trip_to_a_frame() {
+  BlindSnapshot snapshot = BlindSnapshot::empty(BlindId::from_text("USZ"));
+  const ParsedFrame version = parse_arc_frame("!USZvA21;");
+  feed(snapshot, "!USZvA21;");
+  feed(snapshot, "!USZpP03;");
+
+  const ParsedFrame restored = snapshot.static_frame();
+  require(restored.has(ParsedFrame::VERSION) && restored.has(ParsedFrame::LIMITS),
+          "restored static values should look like replies");
+  require(restored.motor_type_code == version.motor_type_code &&
+              restored.has(ParsedFrame::VERSION_NUMBER) ==
+                  version.has(ParsedFrame::VERSION_NUMBER) &&
+              restored.version_major == version.version_major &&
+              restored.version_minor == version.version_minor &&
+              restored.version_code_view() == version.version_code_view(),
+          "the restored version should format like the original reply");
+  require(restored.limits_code_view() == "03", "the restored limits should match");
+  require(!restored.has(ParsedFrame::POSITION) && !restored.has(ParsedFrame::VOLTAGE),
+          "only static values should be replayed");
+}
+
+void test_stale_snapshots_are_discarded() {
+  BlindSnapshot snapshot = BlindSnapshot::empty(BlindId::from_text("USZ"));
+  require(!snapshot.matches(BlindId::from_text("KHN")),
+          "a snapshot saved for another blind should not be restored");
+  snapshot.format = 0;
+  require(!snapshot.matches(BlindId::from_text("USZ")),
+          "a snapshot in another format should not be restored");
+  BlindSnapshot blank;
+  require(!blank.matches(BlindId::from_text("USZ")), "a blank preference is not a snapshot");
+}
+
+void test_static_replies_reset_the_restore_count() {
+  BlindSnapshot snapshot = BlindSnapshot::empty(BlindId::from_text("USZ"));
+  feed(snapshot, "!USZvA21;");
+  snapshot.static_restores = 5;
+  feed(snapshot, "!USZr050;");
+  require(snapshot.static_restores == 5, "other replies should not confirm static values");
+  require(feed(snapshot, "!USZpP03;") && snapshot.static_restores == 0,
+          "a limits reply should confirm the static values");
+}
+
+}  // namespace
+
+int main() {
+  test_snapshot_keeps_the_last_reported_state();
+  test_static_values_round_trip_to_a_frame();
+  test_stale_snapshots_are_discarded();
+  test_static_replies_reset_the_restore_count();
+  std::cout << "state cache tests passed" << std::endl;
+  return 0;
+}
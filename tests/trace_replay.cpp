@@ -0,0 +1,489 @@
+#include "bridge_engine.h"
+#include "frame_extractor.h"
+#include "protocol.h"
+#include "uart_trace.h"
+#include "virtual_hub.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Replays a UART trace capture at full speed. RX frames and API motion
+// commands from the capture go into a fresh BridgeEngine on a virtual clock,
+// and every frame the engine transmits is compared with the recorded TX
+// frames. Also measures raw parser throughput over the recorded RX frames.
+//
+//   trace_replay CAPTURE [options]   replay a capture file
+//   trace_replay --self-test         record a virtual hub run, then replay it
+//   --save PATH                      also write the self-test capture to PATH
+//
+// Options match the bridge settings of the site the capture came from:
+//   --auto-poll-interval MS, --motion-tx-gap MS, --command-retries N,
+//   --command-retry-timeout MS, --no-auto-poll, --no-startup-sweep, --quick
+
+using esphome::arc_bridge::BlindId;
+using esphome::arc_bridge::BridgeClock;
+using esphome::arc_bridge::BridgeEngine;
+using esphome::arc_bridge::BridgeTransport;
+using esphome::arc_bridge::FrameExtractor;
+using esphome::arc_bridge::ParsedFrame;
+using esphome::arc_bridge::SensorKind;
+using esphome::arc_bridge::TraceDirection;
+using esphome::arc_bridge::TraceRecord;
+using esphome::arc_bridge::UartTraceReader;
+using esphome::arc_bridge::parse_arc_frame;
+using esphome::arc_bridge::testing::VirtualBlindConfig;
+using esphome::arc_bridge::testing::VirtualHub;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+volatile uint64_t g_sink = 0;
+
+struct Options {
+  const char *capture_path{nullptr};
+  const char *save_path{nullptr};
+  bool self_test{false};
+  bool quick{false};
+  bool auto_poll{true};
+  bool startup_sweep{true};
+  uint32_t auto_poll_interval_ms{10000};
+  uint32_t motion_tx_gap_ms{200};
+  uint8_t command_retries{1};
+  uint32_t command_retry_timeout_ms{1500};
+};
+
+void configure(BridgeEngine &engine, const Options &options) {
+  engine.set_auto_poll_enabled(options.auto_poll);
+  engine.set_auto_poll_interval(options.auto_poll_interval_ms);
+  engine.set_startup_sweep_enabled(options.startup_sweep);
+  engine.set_motion_tx_gap(options.motion_tx_gap_ms);
+  engine.set_command_retry_count(options.command_retries);
+  engine.set_command_retry_timeout(options.command_retry_timeout_ms);
+}
+
+struct Capture {
+  std::vector<uint8_t> bytes;
+  uint32_t origin_ms{0};
+  uint32_t dropped{0};
+  std::vector<TraceRecord> records;
+};
+
+bool decode_capture(Capture &capture) {
+  UartTraceReader reader(capture.bytes.data(), capture.bytes.size());
+  if (!reader.valid()) {
+    std::fprintf(stderr, "not a UART trace capture\n");
+    return false;
+  }
+  capture.origin_ms = reader.origin_ms();
+  capture.dropped = reader.dropped();
+  TraceRecord record;
+  while (reader.next(record)) {
+    capture.records.push_back(record);
+  }
+  if (reader.truncated()) {
+    std::fprintf(stderr, "warning: capture is truncated after %zu records\n",
+                 capture.records.size());
+  }
+  return true;
+}
+
+// The blind a bridge-side frame (`!IDcmd;`) addresses; invalid for pairing.
+BlindId frame_blind(std::string_view frame) {
+  if (frame.size() < 5 || frame[0] != '!' || frame.substr(1, 3) == "000") {
+    return {};
+  }
+  return BlindId::from_text(frame.substr(1, 3));
+}
+
+// Plays the capture's RX frames back through the transport at their recorded
+// times and collects what the engine transmits.
+class ReplayBridge : public BridgeClock, public BridgeTransport {
+ public:
+  struct Sent {
+    uint32_t at_ms;
+    std::string frame;
+  };
+
+  ReplayBridge(const Capture &capture, const Options &options) : capture(capture) {
+    this->engine.set_clock(this);
+    this->engine.set_transport(this);
+    configure(this->engine, options);
+
+    // Blinds in the order the bridge first addressed them, which is the order
+    // the startup probes and sweep walk the registry in. Sensor kinds are
+    // inferred from the telemetry queries sent to each blind.
+    for (const TraceRecord &record : capture.records) {
+      if (record.direction == TraceDirection::RX) {
+        continue;
+      }
+      const BlindId id = frame_blind(record.frame);
+      if (!id.valid()) {
+        continue;
+      }
+      const std::string text = id.str();
+      this->engine.add_cover(text);
+      const std::string_view command = record.frame.substr(4, record.frame.size() - 5);
+      if (command == "pVc?") {
+        this->engine.map_sensor(text, SensorKind::VOLTAGE);
+      } else if (command == "pSc?") {
+        this->engine.map_sensor(text, SensorKind::SPEED);
+      } else if (command == "v?") {
+        this->engine.map_sensor(text, SensorKind::VERSION);
+      } else if (command == "pP?") {
+        this->engine.map_sensor(text, SensorKind::LIMITS);
+      }
+    }
+  }
+
+  void run() {
+    this->now = this->capture.origin_ms;
+    this->engine.start();
+    const uint32_t end_ms =
+        this->capture.records.empty() ? this->now : this->capture.records.back().at_ms;
+    while (static_cast<int32_t>(end_ms - this->now) > 0) {
+      this->now++;
+      this->engine.run();
+      this->replay_commands_();
+      this->loops++;
+    }
+  }
+
+  uint32_t now_ms() const override { return this->now; }
+
+  size_t receive(char *buffer, size_t size) override {
+    while (this->pending.empty() && this->next_rx < this->capture.records.size()) {
+      const TraceRecord &record = this->capture.records[this->next_rx];
+      if (record.direction != TraceDirection::RX) {
+        this->next_rx++;
+        continue;
+      }
+      if (static_cast<int32_t>(record.at_ms - this->now) > 0) {
+        break;
+      }
+      this->pending.assign(record.frame.data(), record.frame.size());
+      this->next_rx++;
+      this->rx_frames++;
+    }
+    const size_t count = this->pending.size() < size ? this->pending.size() : size;
+    this->pending.copy(buffer, count);
+    this->pending.erase(0, count);
+    return count;
+  }
+
+  void transmit(std::string_view bytes) override {
+    this->sent.push_back({this->now, std::string(bytes)});
+  }
+
+  const Capture &capture;
+  BridgeEngine engine;
+  uint32_t now{0};
+  uint64_t loops{0};
+  uint32_t rx_frames{0};
+  std::vector<Sent> sent;
+
+ protected:
+  // API commands are requested after the loop pass they followed.
+  void replay_commands_() {
+    while (this->next_command < this->capture.records.size()) {
+      const TraceRecord &record = this->capture.records[this->next_command];
+      if (record.direction != TraceDirection::COMMAND) {
+        this->next_command++;
+        continue;
+      }
+      if (static_cast<int32_t>(record.at_ms - this->now) > 0) {
+        break;
+      }
+      this->request_(record.frame);
+      this->next_command++;
+    }
+  }
+
+  void request_(std::string_view frame) {
+    const BlindId id = frame_blind(frame);
+    const std::string_view command = frame.substr(4, frame.size() - 5);
+    if (!id.valid() || command.empty()) {
+      return;
+    }
+    if (command == "o") {
+      this->engine.send_open(id);
+    } else if (command == "c") {
+      this->engine.send_close(id);
+    } else if (command == "s") {
+      this->engine.send_stop(id);
+    } else if (command == "f") {
+      this->engine.send_favorite(id);
+    } else if (command == "oA") {
+      this->engine.send_jog_open(id);
+    } else if (command == "cA") {
+      this->engine.send_jog_close(id);
+    } else if (command[0] == 'm') {
+      const int percent = std::atoi(std::string(command.substr(1)).c_str());
+      this->engine.send_move(id, static_cast<uint8_t>(percent));
+    }
+  }
+
+  size_t next_rx{0};
+  size_t next_command{0};
+  std::string pending;
+};
+
+struct ReplayReport {
+  size_t recorded_tx{0};
+  size_t replayed_tx{0};
+  size_t matching_prefix{0};
+  size_t mismatches{0};
+  uint32_t max_skew_ms{0};
+};
+
+ReplayReport replay(const Capture &capture, const Options &options) {
+  ReplayBridge bridge(capture, options);
+  const auto start = Clock::now();
+  bridge.run();
+  const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+  std::vector<const TraceRecord *> recorded;
+  for (const TraceRecord &record : capture.records) {
+    if (record.direction == TraceDirection::TX) {
+      recorded.push_back(&record);
+    }
+  }
+
+  ReplayReport report;
+  report.recorded_tx = recorded.size();
+  report.replayed_tx = bridge.sent.size();
+  const size_t common = std::min(recorded.size(), bridge.sent.size());
+  bool diverged = false;
+  for (size_t i = 0; i < common; i++) {
+    const ReplayBridge::Sent &sent = bridge.sent[i];
+    if (sent.frame != recorded[i]->frame) {
+      if (!diverged) {
+        std::printf("first divergence at tx #%zu: recorded %.*s at %u ms, replayed %s at %u ms\n",
+                    i, static_cast<int>(recorded[i]->frame.size()), recorded[i]->frame.data(),
+                    static_cast<unsigned>(recorded[i]->at_ms - capture.origin_ms),
+                    sent.frame.c_str(), static_cast<unsigned>(sent.at_ms - capture.origin_ms));
+      }
+      diverged = true;
+      report.mismatches++;
+      continue;
+    }
+    if (!diverged) {
+      report.matching_prefix++;
+      const uint32_t skew = sent.at_ms > recorded[i]->at_ms ? sent.at_ms - recorded[i]->at_ms
+                                                            : recorded[i]->at_ms - sent.at_ms;
+      report.max_skew_ms = std::max(report.max_skew_ms, skew);
+    }
+  }
+  report.mismatches += std::max(recorded.size(), bridge.sent.size()) - common;
+
+  const double virtual_seconds = static_cast<double>(bridge.now - capture.origin_ms) / 1000.0;
+  std::printf("engine replay: %.1f s of traffic in %.3f s (%.0fx), %llu loop passes, "
+              "%.0f ns per pass, %u rx frames\n",
+              virtual_seconds, seconds, seconds > 0 ? virtual_seconds / seconds : 0.0,
+              static_cast<unsigned long long>(bridge.loops),
+              bridge.loops > 0 ? seconds * 1e9 / static_cast<double>(bridge.loops) : 0.0,
+              bridge.rx_frames);
+  std::printf("tx frames: %zu recorded, %zu replayed, %zu identical before the first "
+              "divergence (max skew %u ms), %zu diverging\n",
+              report.recorded_tx, report.replayed_tx, report.matching_prefix,
+              static_cast<unsigned>(report.max_skew_ms), report.mismatches);
+  return report;
+}
+
+void bench_parser(const Capture &capture, const Options &options) {
+  std::vector<std::string_view> frames;
+  size_t bytes = 0;
+  for (const TraceRecord &record : capture.records) {
+    if (record.direction == TraceDirection::RX) {
+      frames.push_back(record.frame);
+      bytes += record.frame.size();
+    }
+  }
+  if (frames.empty()) {
+    std::printf("parser: no rx frames in the capture\n");
+    return;
+  }
+
+  const double min_seconds = options.quick ? 0.02 : 0.25;
+  FrameExtractor extractor;
+  char buffer[FrameExtractor::CAPACITY];
+  uint64_t passes = 0;
+  const auto start = Clock::now();
+  double elapsed = 0.0;
+  while (elapsed < min_seconds) {
+    for (std::string_view frame : frames) {
+      for (char c : frame) {
+        extractor.push(c);
+      }
+      const size_t length = extractor.next_frame(buffer, sizeof(buffer));
+      const ParsedFrame parsed = parse_arc_frame(std::string_view(buffer, length));
+      g_sink = g_sink + parsed.present;
+    }
+    passes++;
+    elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+  }
+  const double total_frames = static_cast<double>(passes * frames.size());
+  std::printf("parser: %.0f frames/s, %.1f MB/s over %zu rx frames\n", total_frames / elapsed,
+              static_cast<double>(passes * bytes) / elapsed / 1e6, frames.size());
+}
+
+// Records half an hour of a 12 blind site with RF trouble and some commands,
+// for the replay to reproduce frame for frame.
+Capture record_self_test_capture(const Options &options) {
+  VirtualHub hub(11);
+  hub.set_transcript_enabled(false);
+  std::vector<std::string> ids;
+  for (int i = 0; i < 12; i++) {
+    char text[4];
+    std::snprintf(text, sizeof(text), "S%02d", i);
+    VirtualBlindConfig config;
+    config.reply_jitter_ms = 60;
+    config.rf_loss_rate = 0.03f;
+    config.lost_link_rate = 0.02f;
+    config.travel_ms = 8000 + 1000 * static_cast<uint32_t>(i);
+    config.position = static_cast<uint8_t>(i * 8);
+    hub.add_blind(text, config);
+    ids.emplace_back(text);
+  }
+
+  struct Link : BridgeClock, BridgeTransport {
+    explicit Link(VirtualHub &hub) : hub(hub) {}
+    uint32_t now_ms() const override { return this->now; }
+    size_t receive(char *buffer, size_t size) override {
+      if (this->rx.empty()) {
+        this->rx = this->hub.read();
+      }
+      const size_t count = this->rx.size() < size ? this->rx.size() : size;
+      this->rx.copy(buffer, count);
+      this->rx.erase(0, count);
+      return count;
+    }
+    void transmit(std::string_view bytes) override { this->hub.write(bytes); }
+    VirtualHub &hub;
+    uint32_t now{0};
+    std::string rx;
+  } link(hub);
+
+  BridgeEngine engine;
+  engine.set_clock(&link);
+  engine.set_transport(&link);
+  configure(engine, options);
+  engine.set_uart_trace_size(32768);
+  for (const std::string &id : ids) {
+    engine.add_cover(id);
+    engine.map_sensor(id, SensorKind::VOLTAGE);
+  }
+  engine.start();
+
+  const uint32_t end_ms = 30 * 60 * 1000;
+  while (link.now < end_ms) {
+    link.now++;
+    hub.advance_to(link.now);
+    engine.run();
+    if (link.now % 97000 == 0) {
+      const BlindId id = BlindId::from_text(ids[(link.now / 97000) % ids.size()]);
+      const uint32_t step = link.now / 97000;
+      if (step % 3 == 0) {
+        engine.send_close(id);
+      } else if (step % 3 == 1) {
+        engine.send_move(id, static_cast<uint8_t>(step * 7 % 100));
+      } else {
+        engine.send_open(id);
+        engine.send_stop(id);
+      }
+    }
+  }
+
+  Capture capture;
+  engine.get_uart_trace().export_capture(capture.bytes);
+  return capture;
+}
+
+bool parse_options(int argc, char **argv, Options &options) {
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (std::strcmp(arg, "--self-test") == 0) {
+      options.self_test = true;
+    } else if (std::strcmp(arg, "--quick") == 0) {
+      options.quick = true;
+    } else if (std::strcmp(arg, "--no-auto-poll") == 0) {
+      options.auto_poll = false;
+    } else if (std::strcmp(arg, "--no-startup-sweep") == 0) {
+      options.startup_sweep = false;
+    } else if (std::strcmp(arg, "--save") == 0 && has_value) {
+      options.save_path = argv[++i];
+    } else if (std::strcmp(arg, "--auto-poll-interval") == 0 && has_value) {
+      options.auto_poll_interval_ms = static_cast<uint32_t>(std::atol(argv[++i]));
+    } else if (std::strcmp(arg, "--motion-tx-gap") == 0 && has_value) {
+      options.motion_tx_gap_ms = static_cast<uint32_t>(std::atol(argv[++i]));
+    } else if (std::strcmp(arg, "--command-retries") == 0 && has_value) {
+      options.command_retries = static_cast<uint8_t>(std::atoi(argv[++i]));
+    } else if (std::strcmp(arg, "--command-retry-timeout") == 0 && has_value) {
+      options.command_retry_timeout_ms = static_cast<uint32_t>(std::atol(argv[++i]));
+    } else if (arg[0] != '-' && options.capture_path == nullptr) {
+      options.capture_path = arg;
+    } else {
+      std::fprintf(stderr, "unknown argument: %s\n", arg);
+      return false;
+    }
+  }
+  return options.self_test || options.capture_path != nullptr;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  Options options;
+  if (!parse_options(argc, argv, options)) {
+    std::fprintf(stderr, "usage: trace_replay (CAPTURE | --self-test) [options]\n");
+    return 2;
+  }
+
+  Capture capture;
+  if (options.self_test) {
+    capture = record_self_test_capture(options);
+    if (options.save_path != nullptr) {
+      std::ofstream file(options.save_path, std::ios::binary);
+      file.write(reinterpret_cast<const char *>(capture.bytes.data()),
+                 static_cast<std::streamsize>(capture.bytes.size()));
+    }
+  } else {
+    std::ifstream file(options.capture_path, std::ios::binary);
+    if (!file) {
+      std::fprintf(stderr, "cannot open %s\n", options.capture_path);
+      return 2;
+    }
+    capture.bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+  if (!decode_capture(capture)) {
+    return 2;
+  }
+
+  std::printf("capture: %zu records, %zu bytes, %u dropped\n", capture.records.size(),
+              capture.bytes.size(), static_cast<unsigned>(capture.dropped));
+  if (capture.dropped > 0) {
+    std::printf("note: the ring wrapped, so the replay starts without the state the dropped "
+                "frames built up and early divergence is expected\n");
+  }
+  bench_parser(capture, options);
+  const ReplayReport report = replay(capture, options);
+
+  if (options.self_test) {
+    if (capture.dropped > 0 || report.recorded_tx == 0 || report.mismatches > 0 ||
+        report.max_skew_ms > 0) {
+      std::fprintf(stderr, "FAIL: the replay should reproduce the recorded run exactly\n");
+      return 1;
+    }
+    std::printf("trace replay self-test passed\n");
+  }
+  return 0;
+}
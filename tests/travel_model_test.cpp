@@ -0,0 +1,119 @@
+#include "travel_model.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using esphome::arc_bridge::TravelDirection;
+using esphome::arc_bridge::TravelMeasurement;
+using esphome::arc_bridge::TravelModel;
+
+namespace {
+
+void require(bool condition, const std::string &message) {
+  if (!condition) {
+    std::cerr << "FAIL: " << message << std::endl;
+    std::exit(1);
+  }
+}
+
+void test_final_reply_times_the_move() {
+  TravelMeasurement measurement;
+  measurement.start(100, 0, 1000);
+  require(measurement.active() && measurement.direction() == TravelDirection::OPENING,
+          "an open from closed should be measured as opening");
+  require(measurement.finish(0, 13000) == 12000,
+          "a full open without reports should take ack to final reply");
+
+  measurement.start(0, 50, 0);
+  require(measurement.finish(50, 6000) == 12000, "half a move should scale to a full one");
+
+  measurement.start(40, 40, 0);
+  require(!measurement.active(), "a move to the current position is not measured");
+}
+
+void test_in_motion_reports_exclude_poll_delay() {
+  TravelMeasurement measurement;
+  measurement.start(0, 100, 0);
+  measurement.sample(10, 2000);
+  measurement.sample(50, 10000);
+  measurement.sample(90, 18000);
+  require(measurement.finish(100, 23000) == 20000,
+          "reports spanning the move should give the rate, not the late final reply");
+}
+
+void test_unusable_moves_are_not_measured() {
+  TravelMeasurement measurement;
+  measurement.start(0, 100, 0);
+  require(measurement.finish(60, 12000) == 0, "a move stopped short of its target is not used");
+
+  measurement.start(50, 60, 0);
+  require(measurement.finish(60, 2000) == 0, "a short move is dominated by latency");
+
+  measurement.start(0, 100, 0);
+  measurement.sample(30, 6000);
+  measurement.sample(20, 8000);
+  require(measurement.finish(100, 20000) == 0, "a reversed move is not used");
+
+  measurement.start(-1, 100, 0);
+  require(measurement.finish(100, 20000) == 0,
+          "an unknown start without reports cannot be timed");
+  measurement.start(-1, 100, 0);
+  measurement.sample(40, 5000);
+  require(measurement.finish(100, 17000) == 20000,
+          "an unknown start should be timed from the first report");
+
+  measurement.start(0, 100, 0);
+  measurement.cancel();
+  require(measurement.finish(100, 20000) == 0, "a cancelled move is not used");
+}
+
+void test_model_averages_and_rejects_outliers() {
+  TravelModel model;
+  require(model.eta_ms(0, 100) == 0, "an unlearned model has no eta");
+  require(model.learn(TravelDirection::CLOSING, 20000) && model.closing_ms == 20000,
+          "the first sample should be taken as is");
+  require(model.learn(TravelDirection::CLOSING, 22000) && model.closing_ms == 21000,
+          "early samples should be averaged");
+  require(model.opening_ms == 0, "directions are learned separately");
+
+  require(!model.learn(TravelDirection::CLOSING, 60000) && model.closing_ms == 21000,
+          "a sample over twice the learned time is an outlier");
+  require(!model.learn(TravelDirection::CLOSING, 21000 * 2 + 1000),
+          "outliers should be counted");
+  require(model.learn(TravelDirection::CLOSING, 24000) && model.closing_outliers == 0,
+          "an inlier should reset the outlier count");
+
+  for (int i = 0; i < 2; i++) {
+    require(!model.learn(TravelDirection::CLOSING, 60000), "outliers before a relearn");
+  }
+  require(model.learn(TravelDirection::CLOSING, 60000) && model.closing_ms == 60000 &&
+              model.closing_samples == 1,
+          "three outliers in a row should relearn the blind");
+
+  require(!model.learn(TravelDirection::OPENING, 500) &&
+              !model.learn(TravelDirection::OPENING, 400000),
+          "implausible travel times are never learned");
+}
+
+void test_eta_scales_with_distance() {
+  TravelModel model;
+  model.learn(TravelDirection::OPENING, 8000);
+  model.learn(TravelDirection::CLOSING, 60000);
+  require(model.eta_ms(100, 0) == 8000, "a fast roller opens in its learned time");
+  require(model.eta_ms(0, 25) == 15000, "a quarter close of a slow drape takes a quarter");
+  require(model.eta_ms(-1, 100) == 60000, "an unknown start assumes a full move");
+  require(model.slowest_ms() == 60000, "the slowest direction bounds motion timeouts");
+}
+
+}  // namespace
+
+int main() {
+  test_final_reply_times_the_move();
+  test_in_motion_reports_exclude_poll_delay();
+  test_unusable_moves_are_not_measured();
+  test_model_averages_and_rejects_outliers();
+  test_eta_scales_with_distance();
+  std::cout << "travel model tests passed" << std::endl;
+  return 0;
+}
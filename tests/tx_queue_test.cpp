@@ -1,18 +1,32 @@
 #include "tx_queue.h"
 
+#include <algorithm>
 #include <cstdlib>
-#include <deque>
 #include <iostream>
 #include <string>
+#include <vector>
 
+using esphome::arc_bridge::BlindId;
+using esphome::arc_bridge::TxFrame;
 using esphome::arc_bridge::TxPacingClass;
+using esphome::arc_bridge::TxPriorityClass;
+using esphome::arc_bridge::TxPushResult;
+using esphome::arc_bridge::TxQueryIndex;
+using esphome::arc_bridge::TxQueryKind;
+using esphome::arc_bridge::TxQueue;
 using esphome::arc_bridge::TxQueueItem;
-using esphome::arc_bridge::drop_pending_poll_items;
-using esphome::arc_bridge::tx_item_can_send_while_delivery_pending;
+using esphome::arc_bridge::TxScheduler;
+using esphome::arc_bridge::build_command_frame;
+using esphome::arc_bridge::build_raw_frame;
 using esphome::arc_bridge::tx_gap_ms_for;
+using esphome::arc_bridge::tx_item_fits_delivery_window;
+using esphome::arc_bridge::tx_query_kind;
 
 namespace {
 
+constexpr BlindId QJ0 = BlindId::from_text("QJ0");
+constexpr BlindId USZ = BlindId::from_text("USZ");
+
 void require(bool condition, const std::string &message) {
   if (!condition) {
     std::cerr << "FAIL: " << message << std::endl;
@@ -31,73 +45,421 @@ void test_gap_mapping() {
           "standard queue items should ignore the overridden motion gap");
 }
 
-void test_drop_pending_polls_removes_only_poll_items() {
-  std::deque<TxQueueItem> queue = {
-      {"!USZr?;", TxPacingClass::STANDARD, true, "", esphome::arc_bridge::DeliveryExpectation::NONE,
-       false, 0, "", ""},
-      {"!USZm050;", TxPacingClass::MOTION, false, "",
-       esphome::arc_bridge::DeliveryExpectation::NONE, false, 0, "", ""},
-      {"!USZpVc?;", TxPacingClass::STANDARD, true, "",
-       esphome::arc_bridge::DeliveryExpectation::NONE, false, 0, "", ""},
-      {"!000&;", TxPacingClass::STANDARD, false, "", esphome::arc_bridge::DeliveryExpectation::NONE,
-       false, 0, "", ""},
-  };
+TxQueueItem frame_item(const char *frame) {
+  TxQueueItem item;
+  item.frame = frame;
+  return item;
+}
+
+void test_queue_is_bounded_and_wraps() {
+  TxQueue queue(3);
+  require(queue.push_back(frame_item("!AAAr?;")), "first item should fit");
+  require(queue.push_back(frame_item("!BBBr?;")), "second item should fit");
+  require(queue.push_back(frame_item("!CCCo;")), "third item should fit");
+  require(queue.full() && !queue.push_back(frame_item("!DDDr?;")),
+          "pushing into a full queue should fail instead of growing");
+
+  queue.erase(0);
+  require(queue.push_back(frame_item("!FFFr?;")), "erasing should free a slot for the next push");
+  require(queue.size() == 3 && queue[0].frame == "!BBBr?;" && queue[1].frame == "!CCCo;" &&
+              queue[2].frame == "!FFFr?;",
+          "items should keep FIFO order across the ring boundary");
+  queue.erase(5);
+  require(queue.size() == 3, "erasing past the end should be ignored");
+
+  queue.clear();
+  require(queue.empty() && queue.capacity() == 3, "clearing should keep the preallocated slots");
+}
+
+TxQueueItem poll_item(const char *frame) {
+  TxQueueItem item = frame_item(frame);
+  item.is_poll = true;
+  return item;
+}
+
+void test_capacity_can_be_reconfigured() {
+  TxQueue queue(2);
+  queue.push_back(frame_item("!AAAo;"));
+  queue.set_capacity(5);
+  require(queue.empty() && queue.capacity() == 5, "resizing should reallocate an empty queue");
+  for (int i = 0; i < 5; i++) {
+    require(queue.push_back(frame_item("!AAAo;")), "the new capacity should be usable");
+  }
+  require(queue.full(), "the queue should fill at the configured capacity");
+}
+
+// Sends everything queued, one frame per 200 ms, and returns the frames in
+// the order the scheduler picked them.
+std::string drain(TxScheduler &scheduler, uint32_t &now) {
+  std::string order;
+  while (!scheduler.empty()) {
+    now += 200;
+    const size_t index = scheduler.select(now);
+    order += scheduler.queue()[index].frame.c_str();
+    scheduler.complete(index, now);
+  }
+  return order;
+}
+
+void test_scheduler_orders_by_class() {
+  TxScheduler scheduler(8);
+  uint32_t now = 1000;
+  scheduler.push(poll_item("!AAAr?;"), TxPriorityClass::BACKGROUND_POLL, now);
+  scheduler.push(poll_item("!AAAv?;"), TxPriorityClass::STATIC_QUERY, now);
+  scheduler.push(frame_item("!BBBo;"), TxPriorityClass::MOTION, now);
+  scheduler.push(frame_item("!CCCr?;"), TxPriorityClass::RETRY_VERIFY, now);
+  scheduler.push(poll_item("!DDDr?;"), TxPriorityClass::INTERACTIVE_QUERY, now);
+  scheduler.push(frame_item("!BBBs;"), TxPriorityClass::EMERGENCY_STOP, now);
+  scheduler.push(frame_item("!EEEc;"), TxPriorityClass::MOTION, now);
+
+  require(drain(scheduler, now) == "!BBBs;!BBBo;!EEEc;!CCCr?;!DDDr?;!AAAv?;!AAAr?;",
+          "fresh items should go out by class, oldest first within a class");
+}
+
+void test_scheduler_ages_polls_past_motion() {
+  TxScheduler scheduler(8);
+  scheduler.push(poll_item("!AAAr?;"), TxPriorityClass::BACKGROUND_POLL, 0);
+
+  // Default weights: a poll needs (1000 - 200) * 50 ms to rank with fresh motion.
+  scheduler.push(frame_item("!BBBo;"), TxPriorityClass::MOTION, 30000);
+  const size_t motion = scheduler.select(30000);
+  require(scheduler.queue()[motion].frame == "!BBBo;",
+          "a poll that waited 30 s should still yield to fresh motion");
+  scheduler.complete(motion, 30000);
+  scheduler.push(frame_item("!CCCo;"), TxPriorityClass::MOTION, 40000);
+  require(scheduler.queue()[scheduler.select(40000)].frame == "!AAAr?;",
+          "a poll that waited 40 s should no longer be starved by motion");
+
+  scheduler.push(frame_item("!BBBs;"), TxPriorityClass::EMERGENCY_STOP, 600000);
+  require(scheduler.queue()[scheduler.select(600000)].frame == "!BBBs;",
+          "aging should never let anything overtake a stop");
+
+  scheduler.set_aging_interval(0);
+  scheduler.set_class_weight(TxPriorityClass::BACKGROUND_POLL, 2000);
+  scheduler.set_class_weight(TxPriorityClass::EMERGENCY_STOP, 0);
+  require(scheduler.queue()[scheduler.select(600000)].frame == "!AAAr?;",
+          "configured weights should replace the defaults");
+}
+
+void test_scheduler_respects_eligibility_and_tracks_waits() {
+  TxScheduler scheduler(4);
+  scheduler.push(frame_item("!BBBo;"), TxPriorityClass::MOTION, 100);
+  scheduler.push(poll_item("!AAAr?;"), TxPriorityClass::BACKGROUND_POLL, 100);
+
+  const size_t index =
+      scheduler.select(400, [](const TxQueueItem &item) { return item.is_poll; });
+  require(scheduler.queue()[index].frame == "!AAAr?;",
+          "blocked items should be skipped in favour of eligible ones");
+  scheduler.complete(index, 400);
+  require(scheduler.select(400, [](const TxQueueItem &) { return false; }) == TxScheduler::NONE,
+          "nothing should be selected when every item is blocked");
+
+  scheduler.complete(scheduler.select(1100), 1100);
+  const auto &motion = scheduler.stats(TxPriorityClass::MOTION);
+  const auto &poll = scheduler.stats(TxPriorityClass::BACKGROUND_POLL);
+  require(motion.sent == 1 && motion.last_wait_ms == 1000 && motion.max_wait_ms == 1000,
+          "motion wait time should be recorded");
+  require(poll.sent == 1 && poll.average_wait_ms() == 300, "poll wait time should be recorded");
+  require(scheduler.stats(TxPriorityClass::EMERGENCY_STOP).sent == 0,
+          "classes with no traffic should have empty stats");
+}
+
+void test_scheduler_displaces_polls_when_full() {
+  TxScheduler scheduler(2);
+  require(scheduler.push(poll_item("!AAAr?;"), TxPriorityClass::BACKGROUND_POLL, 0) ==
+                  TxPushResult::QUEUED &&
+              scheduler.push(poll_item("!BBBr?;"), TxPriorityClass::BACKGROUND_POLL, 0) ==
+                  TxPushResult::QUEUED,
+          "polls should fill the queue");
+  require(scheduler.push(poll_item("!CCCr?;"), TxPriorityClass::BACKGROUND_POLL, 0) ==
+              TxPushResult::DROPPED,
+          "polls should not displace each other");
+  require(scheduler.push(frame_item("!DDDs;"), TxPriorityClass::EMERGENCY_STOP, 0) ==
+                  TxPushResult::QUEUED &&
+              scheduler.queue()[0].frame == "!AAAr?;" && scheduler.queue()[1].frame == "!DDDs;",
+          "a command should take the newest poll's slot");
+}
+
+void test_full_queue_displaces_newest_poll() {
+  TxScheduler scheduler(4);
+  scheduler.push(poll_item("!AAAr?;"), TxPriorityClass::BACKGROUND_POLL, 0);
+  scheduler.push(frame_item("!BBBo;"), TxPriorityClass::MOTION, 0);
+  scheduler.push(poll_item("!CCCr?;"), TxPriorityClass::BACKGROUND_POLL, 0);
+  scheduler.push(frame_item("!DDDc;"), TxPriorityClass::MOTION, 0);
+
+  require(scheduler.push(frame_item("!EEEo;"), TxPriorityClass::MOTION, 0) ==
+                  TxPushResult::QUEUED &&
+              scheduler.size() == 4,
+          "a full queue should give up one poll for an incoming command");
+  const TxQueue &queue = scheduler.queue();
+  require(queue[0].frame == "!AAAr?;" && queue[1].frame == "!BBBo;" &&
+              queue[2].frame == "!DDDc;" && queue[3].frame == "!EEEo;",
+          "the newest poll should be dropped and the rest keep their order");
+
+  require(scheduler.push(frame_item("!FFFo;"), TxPriorityClass::MOTION, 0) ==
+                  TxPushResult::QUEUED &&
+              scheduler.push(frame_item("!GGGo;"), TxPriorityClass::MOTION, 0) ==
+                  TxPushResult::DROPPED,
+          "a queue holding only commands has nothing to displace");
+  require(queue[0].frame == "!BBBo;" && queue[3].frame == "!FFFo;",
+          "commands should never be displaced");
+}
+
+TxQueueItem query_item(BlindId id, char command, const char *payload) {
+  TxQueueItem item;
+  build_command_frame(item.frame, id, command, payload);
+  item.blind_id = id;
+  item.is_poll = true;
+  return item;
+}
 
-  drop_pending_poll_items(queue);
+void test_scheduler_drop_polls_keeps_commands() {
+  TxScheduler scheduler(8);
+  scheduler.push(query_item(USZ, 'r', "?"), TxPriorityClass::BACKGROUND_POLL, 0);
+  scheduler.push(frame_item("!USZm050;"), TxPriorityClass::MOTION, 0);
+  scheduler.push(query_item(USZ, 'p', "Vc?"), TxPriorityClass::BACKGROUND_POLL, 0);
+  scheduler.push(frame_item("!000&;"), TxPriorityClass::INTERACTIVE_QUERY, 0);
 
-  require(queue.size() == 2, "dropping polls should leave only non-poll items");
-  require(queue[0].frame == "!USZm050;", "motion frame should remain after poll drop");
-  require(queue[1].frame == "!000&;", "default non-poll frame should remain after poll drop");
+  require(scheduler.drop_polls() == 2, "both poll items should be reported as dropped");
+  require(scheduler.size() == 2 && scheduler.queue()[0].frame == "!USZm050;" &&
+              scheduler.queue()[1].frame == "!000&;",
+          "dropping polls should leave only non-poll items in order");
+  require(scheduler.push(query_item(USZ, 'r', "?"), TxPriorityClass::BACKGROUND_POLL, 10) ==
+              TxPushResult::QUEUED,
+          "dropped polls should be forgotten by the query index");
+  require(scheduler.queue()[scheduler.select(10)].frame == "!USZm050;",
+          "the motion frame should still go out ahead of polls");
 }
 
-void test_priority_motion_sits_ahead_of_polls() {
-  std::deque<TxQueueItem> queue;
-  queue.push_back({"!USZr?;", TxPacingClass::STANDARD, true, "",
-                   esphome::arc_bridge::DeliveryExpectation::NONE, false, 0, "", ""});
-  queue.push_back({"!USZpVc?;", TxPacingClass::STANDARD, true, "",
-                   esphome::arc_bridge::DeliveryExpectation::NONE, false, 0, "", ""});
-  queue.push_front({"!USZo;", TxPacingClass::MOTION, false, "",
-                    esphome::arc_bridge::DeliveryExpectation::NONE, false, 0, "", ""});
+void test_query_kind_classification() {
+  require(tx_query_kind(query_item(USZ, 'r', "?")) == TxQueryKind::POSITION &&
+              tx_query_kind(query_item(USZ, 'p', "Vc?")) == TxQueryKind::VOLTAGE &&
+              tx_query_kind(query_item(USZ, 'p', "Sc?")) == TxQueryKind::SPEED &&
+              tx_query_kind(query_item(USZ, 'v', "?")) == TxQueryKind::VERSION &&
+              tx_query_kind(query_item(USZ, 'p', "P?")) == TxQueryKind::LIMITS,
+          "every polled query should be classified");
+  require(tx_query_kind(query_item(USZ, 'm', "050")) == TxQueryKind::NONE,
+          "commands should not be treated as queries");
+  require(tx_query_kind(frame_item("!USZr?;")) == TxQueryKind::NONE,
+          "frames without a blind id are never merged");
+}
+
+void test_query_index_survives_churn() {
+  TxQueryIndex index;
+  index.reserve(8);
+  std::vector<uint32_t> keys;
+  for (int i = 0; i < 8; i++) {
+    char text[4] = {'B', static_cast<char>('0' + i / 4), static_cast<char>('0' + i % 4), '\0'};
+    keys.push_back(TxQueryIndex::key(BlindId::from_text(text), TxQueryKind::POSITION));
+    require(index.insert(keys.back()), "new keys should be inserted");
+  }
+  require(!index.insert(keys[3]) && index.size() == 8, "keys should only be stored once");
+
+  // Erasing from the middle of probe runs must keep every other key reachable.
+  for (size_t i = 0; i < keys.size(); i += 2) {
+    index.erase(keys[i]);
+  }
+  for (size_t i = 0; i < keys.size(); i++) {
+    require(index.contains(keys[i]) == (i % 2 == 1), "only the erased keys should be gone");
+  }
+  index.clear();
+  require(index.size() == 0 && !index.contains(keys[1]), "clearing should empty the index");
+}
 
-  require(queue.front().frame == "!USZo;",
-          "priority motion frame should sit at the front of the queue");
+void test_scheduler_merges_duplicate_queries() {
+  TxScheduler scheduler(8);
+  require(scheduler.push(query_item(USZ, 'r', "?"), TxPriorityClass::BACKGROUND_POLL, 0) ==
+              TxPushResult::QUEUED,
+          "the first poll should be queued");
+  require(scheduler.push(query_item(USZ, 'r', "?"), TxPriorityClass::BACKGROUND_POLL, 10) ==
+              TxPushResult::MERGED,
+          "an identical poll should be merged");
+  require(scheduler.push(query_item(QJ0, 'r', "?"), TxPriorityClass::BACKGROUND_POLL, 10) ==
+                  TxPushResult::QUEUED &&
+              scheduler.push(query_item(USZ, 'p', "Vc?"), TxPriorityClass::BACKGROUND_POLL, 10) ==
+                  TxPushResult::QUEUED,
+          "other blinds and other queries should still be queued");
+  require(scheduler.size() == 3 && scheduler.pending_queries() == 3,
+          "the index should track one entry per queued query");
 
-  drop_pending_poll_items(queue);
+  // A verification r? is not a poll, so the merged query must survive drop_polls().
+  TxQueueItem verify = query_item(USZ, 'r', "?");
+  verify.is_poll = false;
+  require(scheduler.push(verify, TxPriorityClass::RETRY_VERIFY, 20) == TxPushResult::PROMOTED,
+          "a more urgent request should promote the queued query");
+  require(scheduler.queue()[0].priority_class == TxPriorityClass::RETRY_VERIFY &&
+              scheduler.queue()[0].enqueued_ms == 0,
+          "promotion should keep the original queue time");
+  require(scheduler.stats(TxPriorityClass::BACKGROUND_POLL).merged == 1 &&
+              scheduler.stats(TxPriorityClass::RETRY_VERIFY).merged == 1,
+          "merges should be counted against the requesting class");
 
-  require(queue.size() == 1 && queue.front().frame == "!USZo;",
-          "dropping pending polls should preserve the priority motion frame");
+  require(scheduler.drop_polls() == 2 && scheduler.size() == 1 &&
+              scheduler.pending_queries() == 1,
+          "dropping polls should keep the promoted query and its index entry");
+  scheduler.complete(0, 100);
+  require(scheduler.pending_queries() == 0 &&
+              scheduler.push(query_item(USZ, 'r', "?"), TxPriorityClass::BACKGROUND_POLL, 200) ==
+                  TxPushResult::QUEUED,
+          "a sent query should be queueable again");
 }
 
-void test_delivery_gating_allows_only_matching_retry_or_untracked_frames() {
-  TxQueueItem other_motion{"!USZo;", TxPacingClass::MOTION, false, "USZ",
+void test_frame_builders() {
+  TxFrame frame;
+  require(build_command_frame(frame, USZ, 'm', "050") && frame == "!USZm050;",
+          "command frames should be wrapped in ! and ;");
+  require(build_command_frame(frame, USZ, 'o') && frame == "!USZo;",
+          "command frames without payload should be built");
+  require(!build_command_frame(frame, USZ, 'x', std::string(TxFrame::CAPACITY, '0')),
+          "command frames longer than the inline buffer should be rejected");
+
+  require(build_raw_frame(frame, "USZr?") && frame == "!USZr?;",
+          "raw commands should gain missing delimiters");
+  require(build_raw_frame(frame, "!000&;") && frame == "!000&;",
+          "raw commands that are already framed should be kept as-is");
+  require(!build_raw_frame(frame, ""), "empty raw commands should be rejected");
+  require(!build_raw_frame(frame, std::string(TxFrame::CAPACITY, 'x')),
+          "raw commands that do not fit once framed should be rejected");
+}
+
+void test_delivery_window_admits_one_delivery_per_blind() {
+  TxQueueItem other_motion{"!USZo;", TxPacingClass::MOTION, false, USZ,
                            esphome::arc_bridge::DeliveryExpectation::BLIND_REPLY,
                            true, 2, "o", ""};
-  require(!tx_item_can_send_while_delivery_pending(other_motion, "QJ0", 1),
-          "new motion for another blind should wait while delivery is pending");
+  require(!tx_item_fits_delivery_window(other_motion, 0, 1, 1),
+          "with a window of one, motion for another blind should wait");
+  require(tx_item_fits_delivery_window(other_motion, 0, 1, 4),
+          "motion for an idle blind should go out while the window has room");
+  require(!tx_item_fits_delivery_window(other_motion, 0, 4, 4),
+          "motion for an idle blind should wait while the window is full");
+  require(!tx_item_fits_delivery_window(other_motion, 7, 1, 4),
+          "a blind should never have two deliveries in flight");
 
-  TxQueueItem matching_retry{"!QJ0o;", TxPacingClass::MOTION, false, "QJ0",
+  TxQueueItem matching_retry{"!QJ0o;", TxPacingClass::MOTION, false, QJ0,
                              esphome::arc_bridge::DeliveryExpectation::BLIND_REPLY,
                              true, 1, "o", ""};
-  require(tx_item_can_send_while_delivery_pending(matching_retry, "QJ0", 1),
-          "matching retry should be allowed through pending-delivery gating");
+  require(tx_item_fits_delivery_window(matching_retry, 1, 4, 4),
+          "a retry of the blind's own delivery should pass a full window");
 
-  TxQueueItem verification_query{"!QJ0r?;", TxPacingClass::STANDARD, false, "",
+  TxQueueItem verification_query{"!QJ0r?;", TxPacingClass::STANDARD, false, QJ0,
                                  esphome::arc_bridge::DeliveryExpectation::NONE,
                                  false, 0, "", ""};
-  require(tx_item_can_send_while_delivery_pending(verification_query, "QJ0", 1),
-          "untracked verification query should be allowed while delivery is pending");
+  require(tx_item_fits_delivery_window(verification_query, 1, 4, 4),
+          "untracked verification queries should never be gated");
+}
+
+struct SceneResult {
+  uint32_t all_acknowledged_ms{0};
+  size_t max_in_flight{0};
+};
+
+// Replays a scene that moves `blinds` blinds at once through the scheduler
+// and the delivery window, with each blind replying `reply_ms` after its
+// command goes out. A `silent` blind never replies and holds its slot.
+SceneResult run_motion_scene(size_t blinds, size_t window, uint32_t reply_ms,
+                             BlindId silent = {}) {
+  TxScheduler scheduler;
+  std::vector<BlindId> ids;
+  for (size_t i = 0; i < blinds; i++) {
+    const char text[] = {'B', static_cast<char>('A' + i / 10), static_cast<char>('0' + i % 10),
+                         '\0'};
+    ids.push_back(BlindId::from_text(text));
+    TxQueueItem item{"", TxPacingClass::MOTION, false, ids.back(),
+                     esphome::arc_bridge::DeliveryExpectation::BLIND_REPLY,
+                     true, static_cast<uint32_t>(i + 1), "m", ""};
+    require(build_command_frame(item.frame, ids.back(), 'm', "050"), "scene frame");
+    scheduler.push(item, TxPriorityClass::MOTION, 0);
+  }
+
+  // Tracking id pending per blind and when its reply lands; 0 when idle.
+  std::vector<uint32_t> pending(blinds, 0);
+  std::vector<uint32_t> reply_at(blinds, 0);
+  size_t in_flight = 0;
+  size_t acknowledged = 0;
+  const size_t expected = blinds - (silent.valid() ? 1 : 0);
+  uint32_t last_tx = 0;
+  bool sent_any = false;
+
+  SceneResult result;
+  for (uint32_t now = 0; now < 120000; now += 10) {
+    for (size_t i = 0; i < blinds; i++) {
+      if (pending[i] != 0 && ids[i] != silent && now >= reply_at[i]) {
+        pending[i] = 0;
+        in_flight--;
+        acknowledged++;
+      }
+    }
+    if (acknowledged == expected) {
+      result.all_acknowledged_ms = now;
+      return result;
+    }
+    if (sent_any && now - last_tx < tx_gap_ms_for(TxPacingClass::MOTION)) {
+      continue;
+    }
+    const size_t index = scheduler.select(now, [&](const TxQueueItem &item) {
+      const size_t blind = item.tracking_id - 1;
+      return tx_item_fits_delivery_window(item, pending[blind], in_flight, window);
+    });
+    if (index == TxScheduler::NONE) {
+      continue;
+    }
+    const size_t blind = scheduler.queue()[index].tracking_id - 1;
+    pending[blind] = scheduler.queue()[index].tracking_id;
+    reply_at[blind] = now + reply_ms;
+    in_flight++;
+    result.max_in_flight = std::max(result.max_in_flight, in_flight);
+    scheduler.complete(index, now);
+    last_tx = now;
+    sent_any = true;
+  }
+  require(false, "the scene should finish");
+  return result;
+}
+
+void test_delivery_window_speeds_up_scenes() {
+  constexpr uint32_t REPLY_MS = 600;
+  const SceneResult serial = run_motion_scene(12, 1, REPLY_MS);
+  const SceneResult windowed = run_motion_scene(12, 4, REPLY_MS);
+  const SceneResult open = run_motion_scene(12, 12, REPLY_MS);
+  std::cout << "12-blind scene, time to all acknowledged: window 1 " << serial.all_acknowledged_ms
+            << " ms, window 4 " << windowed.all_acknowledged_ms << " ms, window 12 "
+            << open.all_acknowledged_ms << " ms" << std::endl;
+
+  require(serial.max_in_flight == 1 && serial.all_acknowledged_ms >= 12 * REPLY_MS,
+          "a window of one should wait out every reply in turn");
+  require(windowed.max_in_flight <= 4, "the window should cap deliveries in flight");
+  // Once the window covers a reply round trip, the motion gap is the limit.
+  const uint32_t gap_bound = 11 * tx_gap_ms_for(TxPacingClass::MOTION) + REPLY_MS;
+  require(windowed.all_acknowledged_ms <= gap_bound && open.all_acknowledged_ms <= gap_bound,
+          "a window of four should pipeline the scene down to the motion gap");
+  require(windowed.all_acknowledged_ms * 2 < serial.all_acknowledged_ms,
+          "pipelining should at least halve the scene time");
 
-  require(tx_item_can_send_while_delivery_pending(other_motion, "", 0),
-          "delivery gating should not block when no delivery is pending");
+  // A blind that misses its reply holds one slot until it is retried or given
+  // up; the rest of the scene keeps moving through the other three.
+  const SceneResult missed = run_motion_scene(12, 4, REPLY_MS, BlindId::from_text("BA0"));
+  require(missed.all_acknowledged_ms <= gap_bound,
+          "a silent blind should not stall deliveries to the others");
 }
 
 }  // namespace
 
 int main() {
   test_gap_mapping();
-  test_drop_pending_polls_removes_only_poll_items();
-  test_priority_motion_sits_ahead_of_polls();
-  test_delivery_gating_allows_only_matching_retry_or_untracked_frames();
+  test_queue_is_bounded_and_wraps();
+  test_capacity_can_be_reconfigured();
+  test_scheduler_orders_by_class();
+  test_scheduler_ages_polls_past_motion();
+  test_scheduler_respects_eligibility_and_tracks_waits();
+  test_scheduler_displaces_polls_when_full();
+  test_full_queue_displaces_newest_poll();
+  test_scheduler_drop_polls_keeps_commands();
+  test_query_kind_classification();
+  test_query_index_survives_churn();
+  test_scheduler_merges_duplicate_queries();
+  test_frame_builders();
+  test_delivery_window_admits_one_delivery_per_blind();
+  test_delivery_window_speeds_up_scenes();
   std::cout << "tx queue tests passed" << std::endl;
   return 0;
 }
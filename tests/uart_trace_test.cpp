@@ -0,0 +1,135 @@
+#include "uart_trace.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using esphome::arc_bridge::TraceDirection;
+using esphome::arc_bridge::TraceRecord;
+using esphome::arc_bridge::UART_TRACE_HEADER_SIZE;
+using esphome::arc_bridge::UartTrace;
+using esphome::arc_bridge::UartTraceReader;
+
+namespace {
+
+void require(bool condition, const std::string &message) {
+  if (!condition) {
+    std::cerr << "FAIL: " << message << std::endl;
+    std::exit(1);
+  }
+}
+
+std::vector<TraceRecord> read_all(const std::vector<uint8_t> &capture) {
+  UartTraceReader reader(capture.data(), capture.size());
+  require(reader.valid(), "exported captures should have a valid header");
+  std::vector<TraceRecord> records;
+  TraceRecord record;
+  while (reader.next(record)) {
+    records.push_back(record);
+  }
+  require(!reader.truncated(), "exported captures should not be truncated");
+  return records;
+}
+
+void test_disabled_trace_records_nothing() {
+  UartTrace trace;
+  trace.record(10, TraceDirection::TX, "!USZr?;");
+  require(!trace.enabled() && trace.record_count() == 0 && trace.used() == 0,
+          "a trace without capacity should stay empty");
+}
+
+void test_records_round_trip_with_timestamps() {
+  UartTrace trace;
+  trace.set_capacity(256);
+  trace.set_origin(5);
+  trace.record(1000, TraceDirection::TX, "!USZr?;");
+  trace.record(1120, TraceDirection::RX, "!USZr100b180,RA6;");
+  trace.record(70000, TraceDirection::COMMAND, "!USZc;");
+  // Each frame plus direction and length bytes and a 1 to 3 byte delta.
+  require(trace.used() == (7 + 3) + (17 + 3) + (6 + 5),
+          "records should cost their frame plus a few bytes");
+
+  std::vector<uint8_t> capture;
+  trace.export_capture(capture);
+  UartTraceReader reader(capture.data(), capture.size());
+  require(reader.origin_ms() == 5 && reader.dropped() == 0, "the header should round trip");
+  const std::vector<TraceRecord> records = read_all(capture);
+  require(records.size() == 3, "every record should be exported");
+  require(records[0].at_ms == 1000 && records[0].direction == TraceDirection::TX &&
+              records[0].frame == "!USZr?;",
+          "the first record should keep its absolute time");
+  require(records[1].at_ms == 1120 && records[1].direction == TraceDirection::RX &&
+              records[1].frame == "!USZr100b180,RA6;",
+          "short deltas should round trip");
+  require(records[2].at_ms == 70000 && records[2].direction == TraceDirection::COMMAND,
+          "multi-byte deltas should round trip");
+}
+
+void test_full_ring_overwrites_the_oldest_records() {
+  UartTrace trace;
+  trace.set_capacity(64);
+  for (uint32_t i = 0; i < 20; i++) {
+    const std::string frame = "!B" + std::to_string(10 + i) + "r?;";
+    trace.record(1000 + i * 300, i % 2 == 0 ? TraceDirection::TX : TraceDirection::RX, frame);
+  }
+  require(trace.used() <= 64 && trace.record_count() + trace.dropped() == 20,
+          "a full ring should drop whole records");
+
+  std::vector<uint8_t> capture;
+  trace.export_capture(capture);
+  const std::vector<TraceRecord> records = read_all(capture);
+  require(records.size() == trace.record_count(), "the kept records should export");
+  for (size_t i = 0; i < records.size(); i++) {
+    const uint32_t original =
+        20 - static_cast<uint32_t>(records.size()) + static_cast<uint32_t>(i);
+    require(records[i].at_ms == 1000 + original * 300,
+            "kept records should keep their absolute times after wrapping");
+    require(records[i].frame == "!B" + std::to_string(10 + original) + "r?;",
+            "kept records should keep their bytes after wrapping");
+  }
+}
+
+void test_oversized_frames_are_truncated_or_dropped() {
+  UartTrace trace;
+  trace.set_capacity(32);
+  trace.record(0, TraceDirection::RX, std::string(40, 'x'));
+  require(trace.record_count() == 0 && trace.dropped() == 1,
+          "a record larger than the ring should be dropped");
+
+  trace.set_capacity(1024);
+  trace.record(0, TraceDirection::RX, std::string(300, 'x'));
+  std::vector<uint8_t> capture;
+  trace.export_capture(capture);
+  const std::vector<TraceRecord> records = read_all(capture);
+  require(records.size() == 1 && records[0].frame.size() == 255,
+          "frames over 255 bytes should be truncated");
+}
+
+void test_reader_rejects_bad_captures() {
+  const std::vector<uint8_t> garbage(UART_TRACE_HEADER_SIZE, 0);
+  require(!UartTraceReader(garbage.data(), garbage.size()).valid(),
+          "a capture without the magic should be rejected");
+
+  UartTrace trace;
+  trace.set_capacity(128);
+  trace.record(0, TraceDirection::TX, "!USZr?;");
+  std::vector<uint8_t> capture;
+  trace.export_capture(capture);
+  capture.pop_back();
+  UartTraceReader reader(capture.data(), capture.size());
+  TraceRecord record;
+  require(!reader.next(record) && reader.truncated(), "a cut record should be reported");
+}
+
+}  // namespace
+
+int main() {
+  test_disabled_trace_records_nothing();
+  test_records_round_trip_with_timestamps();
+  test_full_ring_overwrites_the_oldest_records();
+  test_oversized_frames_are_truncated_or_dropped();
+  test_reader_rejects_bad_captures();
+  std::cout << "UART trace tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,434 @@
+#include "virtual_hub.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace esphome {
+namespace arc_bridge {
+namespace testing {
+
+namespace {
+
+// Orders the event heap so the earliest event, then the first scheduled, is on top.
+template<typename Event> bool later_(const Event &lhs, const Event &rhs) {
+  if (lhs.at_ms != rhs.at_ms) {
+    return lhs.at_ms > rhs.at_ms;
+  }
+  return lhs.sequence > rhs.sequence;
+}
+
+bool parse_percent_(std::string_view digits, uint8_t &percent) {
+  if (digits.empty() || digits.size() > 3) {
+    return false;
+  }
+  int value = 0;
+  for (char c : digits) {
+    if (c < '0' || c > '9') {
+      return false;
+    }
+    value = value * 10 + (c - '0');
+  }
+  if (value > 100) {
+    return false;
+  }
+  percent = static_cast<uint8_t>(value);
+  return true;
+}
+
+std::string blind_frame_(BlindId id, std::string_view body) {
+  std::string frame;
+  frame.reserve(body.size() + 5);
+  frame += '!';
+  frame += id.text().view();
+  frame += body;
+  frame += ';';
+  return frame;
+}
+
+// Motion echoes carry the link quality the way the hub reports it: `,RXX`.
+std::string echo_frame_(BlindId id, std::string_view token, uint8_t rssi) {
+  char suffix[8];
+  snprintf(suffix, sizeof(suffix), ",R%02X", rssi);
+  return blind_frame_(id, std::string(token) + suffix);
+}
+
+}  // namespace
+
+VirtualHub::VirtualHub(uint32_t seed) : rng_state_(seed != 0 ? seed : 1) {}
+
+void VirtualHub::add_blind(std::string_view id, const VirtualBlindConfig &config) {
+  const BlindId blind_id = BlindId::from_text(id);
+  if (!blind_id.valid()) {
+    return;
+  }
+  Blind *existing = this->find_(blind_id);
+  if (existing != nullptr) {
+    existing->config = config;
+    existing->motion_generation++;
+    existing->moving = false;
+    return;
+  }
+  Blind blind;
+  blind.id = blind_id;
+  blind.config = config;
+  this->blinds_.push_back(blind);
+}
+
+VirtualBlindConfig *VirtualHub::blind_config(std::string_view id) {
+  Blind *blind = this->find_(BlindId::from_text(id));
+  return blind != nullptr ? &blind->config : nullptr;
+}
+
+int VirtualHub::position(std::string_view id) const {
+  const Blind *blind = this->find_(BlindId::from_text(id));
+  return blind != nullptr ? this->position_at_(*blind, this->now_ms_) : -1;
+}
+
+bool VirtualHub::moving(std::string_view id) const {
+  const Blind *blind = this->find_(BlindId::from_text(id));
+  return blind != nullptr && blind->moving;
+}
+
+void VirtualHub::set_pairing_candidate(std::string_view id, const VirtualBlindConfig &config) {
+  this->pairing_candidate_ = BlindId::from_text(id);
+  this->pairing_config_ = config;
+}
+
+void VirtualHub::press_remote(std::string_view id, uint8_t target_percent) {
+  Blind *blind = this->find_(BlindId::from_text(id));
+  if (blind != nullptr) {
+    this->start_motion_(*blind, target_percent > 100 ? 100 : target_percent);
+  }
+}
+
+void VirtualHub::write(std::string_view bytes) {
+  this->uart_in_.append(bytes.data(), bytes.size());
+  for (;;) {
+    const size_t start = this->uart_in_.find('!');
+    if (start == std::string::npos) {
+      if (!this->uart_in_.empty()) {
+        this->stats_.malformed_frames++;
+      }
+      this->uart_in_.clear();
+      return;
+    }
+    if (start > 0) {
+      this->stats_.malformed_frames++;
+      this->uart_in_.erase(0, start);
+    }
+    const size_t end = this->uart_in_.find(';');
+    if (end == std::string::npos) {
+      return;
+    }
+    // A second `!` before the terminator means the first frame was cut short.
+    const size_t restart = this->uart_in_.find('!', 1);
+    if (restart != std::string::npos && restart < end) {
+      this->stats_.malformed_frames++;
+      this->uart_in_.erase(0, restart);
+      continue;
+    }
+    const std::string frame = this->uart_in_.substr(0, end + 1);
+    this->uart_in_.erase(0, end + 1);
+    this->handle_frame_(frame);
+  }
+}
+
+std::string VirtualHub::read() {
+  std::string out;
+  out.swap(this->uart_out_);
+  return out;
+}
+
+void VirtualHub::advance_to(uint32_t now_ms) {
+  while (!this->events_.empty() &&
+         static_cast<int32_t>(this->events_.front().at_ms - now_ms) <= 0) {
+    std::pop_heap(this->events_.begin(), this->events_.end(), later_<Event>);
+    const Event event = std::move(this->events_.back());
+    this->events_.pop_back();
+    if (static_cast<int32_t>(event.at_ms - this->now_ms_) > 0) {
+      this->now_ms_ = event.at_ms;
+    }
+    this->run_event_(event);
+  }
+  if (static_cast<int32_t>(now_ms - this->now_ms_) > 0) {
+    this->now_ms_ = now_ms;
+  }
+}
+
+uint32_t VirtualHub::next_event_ms() const {
+  return this->events_.empty() ? this->now_ms_ : this->events_.front().at_ms;
+}
+
+VirtualHub::Blind *VirtualHub::find_(BlindId id) {
+  for (auto &blind : this->blinds_) {
+    if (blind.id == id) {
+      return &blind;
+    }
+  }
+  return nullptr;
+}
+
+const VirtualHub::Blind *VirtualHub::find_(BlindId id) const {
+  for (const auto &blind : this->blinds_) {
+    if (blind.id == id) {
+      return &blind;
+    }
+  }
+  return nullptr;
+}
+
+uint8_t VirtualHub::position_at_(const Blind &blind, uint32_t now_ms) const {
+  if (!blind.moving) {
+    return blind.config.position;
+  }
+  if (static_cast<int32_t>(now_ms - blind.end_ms) >= 0) {
+    return blind.target;
+  }
+  const uint32_t elapsed = now_ms - blind.start_ms;
+  const uint32_t duration = blind.end_ms - blind.start_ms;
+  const int delta = static_cast<int>(blind.target) - static_cast<int>(blind.start_position);
+  return static_cast<uint8_t>(blind.start_position +
+                              delta * static_cast<int64_t>(elapsed) / static_cast<int64_t>(duration));
+}
+
+void VirtualHub::schedule_(uint32_t at_ms, EventType type, BlindId blind, std::string frame,
+                           uint32_t generation, uint8_t target) {
+  this->events_.push_back(
+      {at_ms, this->next_sequence_++, type, blind, generation, target, std::move(frame)});
+  std::push_heap(this->events_.begin(), this->events_.end(), later_<Event>);
+}
+
+void VirtualHub::emit_(uint32_t at_ms, std::string frame) {
+  this->schedule_(at_ms, EventType::EMIT, BlindId(), std::move(frame));
+}
+
+void VirtualHub::handle_frame_(std::string_view frame) {
+  this->stats_.frames_received++;
+  this->record_('>', frame);
+  if (frame.size() < 5) {
+    this->stats_.malformed_frames++;
+    return;
+  }
+
+  const BlindId id = BlindId::from_text(frame.substr(1, 3));
+  const std::string_view command = frame.substr(4, frame.size() - 5);
+
+  if (frame == "!000&;") {
+    if (!this->pairing_candidate_.valid()) {
+      return;
+    }
+    const BlindId paired = this->pairing_candidate_;
+    this->pairing_candidate_ = BlindId();
+    this->add_blind(paired.text().view(), this->pairing_config_);
+    this->stats_.pair_acks++;
+    this->emit_(this->now_ms_ + this->pairing_config_.reply_latency_ms,
+                blind_frame_(paired, "A"));
+    return;
+  }
+
+  const bool overlapping =
+      this->reject_overlapping_ && static_cast<int32_t>(this->now_ms_ - this->rf_busy_until_ms_) < 0;
+  if (overlapping || this->roll_(this->busy_rate_)) {
+    this->stats_.busy_replies++;
+    this->emit_(this->now_ms_ + this->hub_latency_ms_, blind_frame_(id, "Ebz"));
+    return;
+  }
+
+  Blind *blind = this->find_(id);
+  if (blind == nullptr) {
+    // Nothing answers on that address; the hub gives up like for a lost link.
+    this->stats_.lost_link_replies++;
+    this->emit_(this->now_ms_ + this->hub_latency_ms_, blind_frame_(id, "Enl"));
+    return;
+  }
+
+  const uint32_t reply_ms = this->now_ms_ + this->latency_(*blind);
+  this->rf_busy_until_ms_ = reply_ms;
+  if (!blind->config.paired || this->roll_(blind->config.not_paired_rate)) {
+    this->stats_.not_paired_replies++;
+    this->emit_(reply_ms, blind_frame_(id, "Enp"));
+    return;
+  }
+  if (this->roll_(blind->config.lost_link_rate)) {
+    this->stats_.lost_link_replies++;
+    this->emit_(reply_ms, blind_frame_(id, "Enl"));
+    return;
+  }
+  if (this->roll_(blind->config.rf_loss_rate)) {
+    this->stats_.rf_lost++;
+    return;
+  }
+
+  // The blind acts on the command when its reply goes out.
+  this->handle_blind_command_(*blind, command, reply_ms);
+}
+
+void VirtualHub::handle_blind_command_(Blind &blind, std::string_view command, uint32_t at_ms) {
+  const VirtualBlindConfig &config = blind.config;
+
+  if (command == "r?") {
+    this->schedule_(at_ms, EventType::POSITION_REPLY, blind.id);
+    return;
+  }
+  if (command == "pVc?") {
+    char body[16];
+    snprintf(body, sizeof(body), "pVc%03d", static_cast<int>(config.voltage_centivolts));
+    this->emit_(at_ms, blind_frame_(blind.id, body));
+    return;
+  }
+  if (command == "pSc?") {
+    char body[16];
+    snprintf(body, sizeof(body), "pSc%03d", static_cast<int>(config.speed_rpm));
+    this->emit_(at_ms, blind_frame_(blind.id, body));
+    return;
+  }
+  if (command == "pP?") {
+    this->emit_(at_ms, blind_frame_(blind.id, "pP" + config.limits));
+    return;
+  }
+  if (command == "v?") {
+    this->emit_(at_ms, blind_frame_(blind.id, "v" + config.version));
+    return;
+  }
+
+  uint8_t target = 0;
+  const uint8_t current = this->position_at_(blind, at_ms);
+  if (command == "o") {
+    target = 0;
+  } else if (command == "c") {
+    target = 100;
+  } else if (command == "s") {
+    target = current;
+  } else if (command == "f") {
+    target = config.favorite;
+  } else if (command == "oA") {
+    target = current > config.jog_step ? current - config.jog_step : 0;
+  } else if (command == "cA") {
+    target = current + config.jog_step < 100 ? current + config.jog_step : 100;
+  } else if (command.size() != 4 || command.front() != 'm' ||
+             !parse_percent_(command.substr(1), target)) {
+    this->emit_(at_ms, blind_frame_(blind.id, "Eec"));
+    return;
+  }
+
+  this->emit_(at_ms, echo_frame_(blind.id, command, config.rssi));
+  this->schedule_(at_ms, EventType::START_MOTION, blind.id, {}, 0, target);
+}
+
+void VirtualHub::start_motion_(Blind &blind, uint8_t target) {
+  const uint8_t current = this->position_at_(blind, this->now_ms_);
+  blind.config.position = current;
+  blind.motion_generation++;
+  if (current == target) {
+    if (blind.moving) {
+      this->stats_.motions_finished++;
+    }
+    blind.moving = false;
+    this->emit_(this->now_ms_, this->position_frame_(blind));
+    return;
+  }
+  if (!blind.moving) {
+    this->stats_.motions_started++;
+  }
+  const uint32_t distance = current > target ? current - target : target - current;
+  blind.moving = true;
+  blind.start_position = current;
+  blind.target = target;
+  blind.start_ms = this->now_ms_;
+  blind.end_ms = this->now_ms_ + std::max<uint32_t>(1, distance * blind.config.travel_ms / 100);
+  this->schedule_(blind.end_ms, EventType::ARRIVAL, blind.id, {}, blind.motion_generation);
+  if (blind.config.motion_report_ms > 0) {
+    this->schedule_(this->now_ms_ + blind.config.motion_report_ms, EventType::MOTION_REPORT,
+                    blind.id, {}, blind.motion_generation);
+  }
+}
+
+void VirtualHub::run_event_(const Event &event) {
+  if (event.type == EventType::EMIT) {
+    this->stats_.frames_sent++;
+    this->record_('<', event.frame);
+    this->uart_out_ += event.frame;
+    return;
+  }
+
+  Blind *blind = this->find_(event.blind);
+  if (blind == nullptr) {
+    return;
+  }
+  switch (event.type) {
+    case EventType::START_MOTION:
+      this->start_motion_(*blind, event.target);
+      break;
+    case EventType::POSITION_REPLY:
+      this->emit_(this->now_ms_, this->position_frame_(*blind));
+      break;
+    case EventType::ARRIVAL:
+      if (event.generation == blind->motion_generation && blind->moving) {
+        blind->moving = false;
+        blind->config.position = blind->target;
+        this->stats_.motions_finished++;
+        this->emit_(this->now_ms_, this->position_frame_(*blind));
+      }
+      break;
+    case EventType::MOTION_REPORT:
+      if (event.generation == blind->motion_generation && blind->moving) {
+        this->emit_(this->now_ms_, this->position_frame_(*blind));
+        this->schedule_(this->now_ms_ + blind->config.motion_report_ms, EventType::MOTION_REPORT,
+                        blind->id, {}, blind->motion_generation);
+      }
+      break;
+    case EventType::EMIT:
+    default:
+      break;
+  }
+}
+
+void VirtualHub::record_(char direction, std::string_view frame) {
+  if (!this->transcript_enabled_) {
+    return;
+  }
+  char prefix[16];
+  snprintf(prefix, sizeof(prefix), "%8u %c ", static_cast<unsigned>(this->now_ms_), direction);
+  this->transcript_.push_back(prefix + std::string(frame));
+}
+
+// xorshift32: tiny, and identical on every platform unlike <random> distributions.
+uint32_t VirtualHub::next_random_() {
+  uint32_t x = this->rng_state_;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  this->rng_state_ = x;
+  return x;
+}
+
+bool VirtualHub::roll_(float rate) {
+  if (rate <= 0.0f) {
+    return false;
+  }
+  return static_cast<float>(this->next_random_() >> 8) / 16777216.0f < rate;
+}
+
+uint32_t VirtualHub::latency_(const Blind &blind) {
+  uint32_t latency = blind.config.reply_latency_ms;
+  if (blind.config.reply_jitter_ms > 0) {
+    latency += this->next_random_() % (blind.config.reply_jitter_ms + 1);
+  }
+  return latency;
+}
+
+std::string VirtualHub::position_frame_(const Blind &blind) const {
+  char body[24];
+  if (blind.moving) {
+    snprintf(body, sizeof(body), "<%02ub00",
+             static_cast<unsigned>(this->position_at_(blind, this->now_ms_)));
+  } else {
+    snprintf(body, sizeof(body), "r%03ub%03u,R%02X", static_cast<unsigned>(blind.config.position),
+             static_cast<unsigned>(blind.config.tilt), blind.config.rssi);
+  }
+  return blind_frame_(blind.id, body);
+}
+
+}  // namespace testing
+}  // namespace arc_bridge
+}  // namespace esphome
@@ -0,0 +1,176 @@
+#pragma once
+
+#include "blind_id.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Test-only stand-in for the STM32 hub and the blinds behind it. It speaks the
+// ARC ASCII protocol byte for byte on both sides of the UART and runs entirely
+// on a virtual clock, so hours of traffic simulate in milliseconds. All
+// randomness comes from a seeded generator: the same seed and the same input
+// bytes always produce the same transcript.
+
+namespace esphome {
+namespace arc_bridge {
+namespace testing {
+
+struct VirtualBlindConfig {
+  // Time from the hub receiving a frame to the blind's reply on the UART.
+  uint32_t reply_latency_ms{120};
+  // Extra latency drawn uniformly from [0, reply_jitter_ms].
+  uint32_t reply_jitter_ms{0};
+  // Chance that a command never reaches the blind: no reply, no motion.
+  float rf_loss_rate{0.0f};
+  // Chance that the hub answers `Enl` instead of the blind.
+  float lost_link_rate{0.0f};
+  // Chance that the hub answers `Enp` instead of the blind.
+  float not_paired_rate{0.0f};
+  // An unpaired blind always answers `Enp`.
+  bool paired{true};
+  // Full open-to-close travel time.
+  uint32_t travel_ms{20000};
+  // Spacing of unsolicited `<NN` frames while moving, 0 for none. Position
+  // queries during travel are answered with `<NN` either way.
+  uint32_t motion_report_ms{0};
+
+  uint8_t position{0};
+  uint16_t tilt{180};
+  uint8_t rssi{0xA6};
+  uint8_t favorite{50};
+  // Step of a jog (`oA` / `cA`) in percent.
+  uint8_t jog_step{5};
+  int32_t voltage_centivolts{1180};
+  int32_t speed_rpm{28};
+  std::string version{"A21"};
+  std::string limits{"03"};
+};
+
+struct VirtualHubStats {
+  uint32_t frames_received{0};
+  uint32_t frames_sent{0};
+  uint32_t malformed_frames{0};
+  uint32_t rf_lost{0};
+  uint32_t lost_link_replies{0};
+  uint32_t not_paired_replies{0};
+  uint32_t busy_replies{0};
+  uint32_t motions_started{0};
+  uint32_t motions_finished{0};
+  uint32_t pair_acks{0};
+};
+
+class VirtualHub {
+ public:
+  explicit VirtualHub(uint32_t seed = 1);
+
+  // Adds a blind, or replaces the configuration of an existing one.
+  void add_blind(std::string_view id, const VirtualBlindConfig &config = {});
+  VirtualBlindConfig *blind_config(std::string_view id);
+  // Current position of a blind, interpolated while it travels; -1 if unknown.
+  int position(std::string_view id) const;
+  bool moving(std::string_view id) const;
+
+  // The hub answers `Ebz` to any frame that arrives while an RF exchange is
+  // still in flight, plus this random share of the rest.
+  void set_busy_rate(float rate) { this->busy_rate_ = rate; }
+  void set_reject_overlapping(bool reject) { this->reject_overlapping_ = reject; }
+  // Latency of replies that come from the hub itself (`Ebz`, `Enl`, `Enp`).
+  void set_hub_latency(uint32_t latency_ms) { this->hub_latency_ms_ = latency_ms; }
+  // The next `!000&;` pairs this id: it is added as a blind and acknowledged
+  // with `!IDA;`. Without a candidate pairing goes unanswered.
+  void set_pairing_candidate(std::string_view id, const VirtualBlindConfig &config = {});
+  // A hand-held remote moves a blind without any bridge command.
+  void press_remote(std::string_view id, uint8_t target_percent);
+
+  // Bytes from the bridge to the hub, received at the current virtual time.
+  void write(std::string_view bytes);
+  // Drains the bytes the hub has put on the UART up to the current time.
+  std::string read();
+  bool available() const { return !this->uart_out_.empty(); }
+
+  // Runs every event due at or before `now_ms`, in time order.
+  void advance_to(uint32_t now_ms);
+  void advance(uint32_t delta_ms) { this->advance_to(this->now_ms_ + delta_ms); }
+  uint32_t now() const { return this->now_ms_; }
+  // Time of the next scheduled event, or `now()` when nothing is pending.
+  uint32_t next_event_ms() const;
+
+  const VirtualHubStats &stats() const { return this->stats_; }
+  // Every frame in both directions, prefixed with the time and `>` (to hub)
+  // or `<` (from hub), for determinism checks and failure output.
+  const std::vector<std::string> &transcript() const { return this->transcript_; }
+  void set_transcript_enabled(bool enabled) { this->transcript_enabled_ = enabled; }
+
+ protected:
+  struct Blind {
+    BlindId id;
+    VirtualBlindConfig config;
+    bool moving{false};
+    uint8_t start_position{0};
+    uint8_t target{0};
+    uint32_t start_ms{0};
+    uint32_t end_ms{0};
+    // Bumped on every motion change so stale arrival events are ignored.
+    uint32_t motion_generation{0};
+  };
+
+  enum class EventType : uint8_t {
+    EMIT,
+    START_MOTION,
+    POSITION_REPLY,
+    ARRIVAL,
+    MOTION_REPORT,
+  };
+
+  struct Event {
+    uint32_t at_ms;
+    uint64_t sequence;
+    EventType type;
+    BlindId blind;
+    uint32_t generation;
+    uint8_t target;
+    std::string frame;
+  };
+
+  Blind *find_(BlindId id);
+  const Blind *find_(BlindId id) const;
+  uint8_t position_at_(const Blind &blind, uint32_t now_ms) const;
+  void schedule_(uint32_t at_ms, EventType type, BlindId blind, std::string frame = {},
+                 uint32_t generation = 0, uint8_t target = 0);
+  void emit_(uint32_t at_ms, std::string frame);
+  void handle_frame_(std::string_view frame);
+  void handle_blind_command_(Blind &blind, std::string_view command, uint32_t at_ms);
+  void start_motion_(Blind &blind, uint8_t target);
+  void run_event_(const Event &event);
+  void record_(char direction, std::string_view frame);
+  uint32_t next_random_();
+  bool roll_(float rate);
+  uint32_t latency_(const Blind &blind);
+  std::string position_frame_(const Blind &blind) const;
+
+  uint32_t now_ms_{0};
+  uint32_t rng_state_;
+  uint64_t next_sequence_{0};
+  float busy_rate_{0.0f};
+  bool reject_overlapping_{true};
+  uint32_t hub_latency_ms_{5};
+  uint32_t rf_busy_until_ms_{0};
+  BlindId pairing_candidate_;
+  VirtualBlindConfig pairing_config_;
+
+  std::vector<Blind> blinds_;
+  // Min-heap on (at_ms, sequence).
+  std::vector<Event> events_;
+  std::string uart_in_;
+  std::string uart_out_;
+  VirtualHubStats stats_;
+  std::vector<std::string> transcript_;
+  bool transcript_enabled_{true};
+};
+
+}  // namespace testing
+}  // namespace arc_bridge
+}  // namespace esphome
@@ -0,0 +1,265 @@
+#include "delivery.h"
+#include "frame_extractor.h"
+#include "pairing.h"
+#include "protocol.h"
+#include "tx_queue.h"
+#include "virtual_hub.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using esphome::arc_bridge::BlindId;
+using esphome::arc_bridge::DeliveryExpectation;
+using esphome::arc_bridge::FrameExtractor;
+using esphome::arc_bridge::PairingOutcomeType;
+using esphome::arc_bridge::PairingSession;
+using esphome::arc_bridge::ParsedFrame;
+using esphome::arc_bridge::TxFrame;
+using esphome::arc_bridge::build_command_frame;
+using esphome::arc_bridge::build_pair_command_frame;
+using esphome::arc_bridge::frame_confirms_delivery;
+using esphome::arc_bridge::handle_pairing_frame;
+using esphome::arc_bridge::parse_arc_frame;
+using esphome::arc_bridge::start_pairing_session;
+using esphome::arc_bridge::testing::VirtualBlindConfig;
+using esphome::arc_bridge::testing::VirtualHub;
+
+namespace {
+
+void require(bool condition, const std::string &message) {
+  if (!condition) {
+    std::cerr << "FAIL: " << message << std::endl;
+    std::exit(1);
+  }
+}
+
+// The bridge end of the UART: frames go out through build_command_frame and
+// come back through the same extractor and parser the component uses.
+struct BridgeEnd {
+  explicit BridgeEnd(VirtualHub &hub) : hub(hub) {}
+
+  void send(const char *id, char command, const char *payload) {
+    TxFrame frame;
+    require(build_command_frame(frame, BlindId::from_text(id), command, payload),
+            "test frames should build");
+    this->hub.write(frame.view());
+  }
+
+  void run_until(uint32_t now_ms) {
+    this->hub.advance_to(now_ms);
+    for (char c : this->hub.read()) {
+      this->extractor.push(c);
+    }
+    char buffer[FrameExtractor::CAPACITY];
+    size_t length;
+    while ((length = this->extractor.next_frame(buffer, sizeof(buffer))) > 0) {
+      this->frames.push_back(parse_arc_frame(std::string_view(buffer, length)));
+    }
+  }
+
+  void run_for(uint32_t delta_ms) { this->run_until(this->hub.now() + delta_ms); }
+
+  VirtualHub &hub;
+  FrameExtractor extractor;
+  std::vector<ParsedFrame> frames;
+};
+
+void test_queries_are_answered_after_the_reply_latency() {
+  VirtualHub hub;
+  VirtualBlindConfig config;
+  config.position = 40;
+  hub.add_blind("USZ", config);
+  BridgeEnd bridge(hub);
+
+  bridge.send("USZ", 'r', "?");
+  bridge.run_for(119);
+  require(bridge.frames.empty(), "no reply should arrive before the reply latency");
+  bridge.run_for(1);
+  require(bridge.frames.size() == 1, "the position reply should arrive at the reply latency");
+  const ParsedFrame &position = bridge.frames[0];
+  require(position.has(ParsedFrame::POSITION) && position.position_percent == 40 &&
+              !position.position_in_motion && position.has(ParsedFrame::RSSI) &&
+              position.rssi_raw == 0xA6,
+          "r? should be answered with rNNNbNNN,RXX");
+
+  bridge.send("USZ", 'p', "Vc?");
+  bridge.run_for(500);
+  bridge.send("USZ", 'p', "Sc?");
+  bridge.run_for(500);
+  bridge.send("USZ", 'p', "P?");
+  bridge.run_for(500);
+  bridge.send("USZ", 'v', "?");
+  bridge.run_for(500);
+  require(bridge.frames.size() == 5, "every extended query should be answered");
+  require(bridge.frames[1].voltage_centivolts == 1180 && bridge.frames[2].speed_rpm == 28 &&
+              bridge.frames[3].limits_code_view() == "03" &&
+              bridge.frames[4].version_code_view() == "A21",
+          "pVc, pSc, pP and v replies should parse");
+}
+
+void test_motor_travel_reports_motion_then_the_final_position() {
+  VirtualHub hub;
+  VirtualBlindConfig config;
+  config.travel_ms = 10000;
+  config.motion_report_ms = 1000;
+  hub.add_blind("QJ0", config);
+  BridgeEnd bridge(hub);
+
+  bridge.send("QJ0", 'm', "050");
+  bridge.run_for(120);
+  require(bridge.frames.size() == 1 &&
+              frame_confirms_delivery(bridge.frames[0], BlindId::from_text("QJ0"),
+                                      DeliveryExpectation::BLIND_REPLY, "m050", "m"),
+          "a move should be echoed with its token");
+  require(hub.moving("QJ0"), "the motor should start with the echo");
+
+  bridge.run_for(2500);
+  require(hub.position("QJ0") == 25, "travel should be linear in time");
+  bridge.send("QJ0", 'r', "?");
+  bridge.run_for(200);
+  const ParsedFrame &in_motion = bridge.frames.back();
+  require(in_motion.position_in_motion && in_motion.position_percent > 0 &&
+              in_motion.position_percent < 50,
+          "a query during travel should be answered with <NN");
+
+  bridge.run_until(120 + 5000);
+  const ParsedFrame &final_frame = bridge.frames.back();
+  require(!hub.moving("QJ0") && final_frame.has(ParsedFrame::POSITION) &&
+              !final_frame.position_in_motion && final_frame.position_percent == 50,
+          "the blind should report its final position when it arrives");
+  size_t in_motion_reports = 0;
+  for (const auto &frame : bridge.frames) {
+    in_motion_reports += frame.position_in_motion ? 1 : 0;
+  }
+  require(in_motion_reports >= 4, "unsolicited <NN frames should follow the report interval");
+
+  bridge.send("QJ0", 'o', "");
+  bridge.run_for(2000);
+  bridge.send("QJ0", 's', "");
+  bridge.run_for(200);
+  require(!hub.moving("QJ0") && bridge.frames.back().position_percent == 30,
+          "a stop should halt the motor and report where it stopped");
+  require(hub.stats().motions_started == 2 && hub.stats().motions_finished == 2,
+          "the hub should count motions");
+}
+
+void test_hub_errors_and_rf_loss() {
+  VirtualHub hub;
+  VirtualBlindConfig unpaired;
+  unpaired.paired = false;
+  hub.add_blind("AAA", unpaired);
+  hub.add_blind("BBB");
+  BridgeEnd bridge(hub);
+
+  bridge.send("AAA", 'r', "?");
+  bridge.send("BBB", 'r', "?");
+  bridge.run_for(500);
+  require(bridge.frames.size() == 2 && bridge.frames[0].error_code_view() == "bz" &&
+              bridge.frames[1].not_paired,
+          "a frame during an RF exchange should get Ebz, unpaired blinds Enp");
+
+  bridge.send("ZZZ", 'r', "?");
+  bridge.run_for(500);
+  require(bridge.frames.back().lost_link, "an unknown address should get Enl");
+
+  VirtualBlindConfig lossy;
+  lossy.rf_loss_rate = 1.0f;
+  hub.add_blind("BBB", lossy);
+  bridge.frames.clear();
+  bridge.send("BBB", 'c', "");
+  bridge.run_for(30000);
+  require(bridge.frames.empty() && !hub.moving("BBB") && hub.stats().rf_lost == 1,
+          "a lost command should neither be answered nor move the blind");
+}
+
+void test_pairing_is_acknowledged() {
+  VirtualHub hub;
+  BridgeEnd bridge(hub);
+  PairingSession session;
+  start_pairing_session(session, hub.now());
+
+  hub.set_pairing_candidate("QJ0");
+  hub.write(build_pair_command_frame());
+  bridge.run_for(500);
+  require(bridge.frames.size() == 1 &&
+              handle_pairing_frame(session, bridge.frames[0]).type == PairingOutcomeType::SUCCESS,
+          "the pairing candidate should answer !IDA;");
+  bridge.send("QJ0", 'r', "?");
+  bridge.run_for(500);
+  require(bridge.frames.back().has(ParsedFrame::POSITION), "a paired blind should answer");
+
+  hub.write(build_pair_command_frame());
+  bridge.run_for(30000);
+  require(bridge.frames.size() == 2, "pairing without a candidate should go unanswered");
+}
+
+void test_remote_moves_are_reported() {
+  VirtualHub hub;
+  VirtualBlindConfig config;
+  config.travel_ms = 4000;
+  hub.add_blind("USZ", config);
+  BridgeEnd bridge(hub);
+
+  hub.press_remote("USZ", 100);
+  bridge.run_for(4000);
+  require(bridge.frames.size() == 1 && bridge.frames[0].position_percent == 100,
+          "a remote move should end with an unsolicited final position");
+}
+
+// Polls a 40-blind site for four virtual hours with some RF trouble and
+// returns the transcript.
+std::vector<std::string> run_site(uint32_t seed) {
+  VirtualHub hub(seed);
+  std::vector<std::string> ids;
+  for (int i = 0; i < 40; i++) {
+    VirtualBlindConfig config;
+    config.reply_jitter_ms = 80;
+    config.rf_loss_rate = 0.02f;
+    config.lost_link_rate = 0.02f;
+    config.position = static_cast<uint8_t>(i * 2);
+    const char id[] = {static_cast<char>('A' + i / 26), static_cast<char>('A' + i % 26), '1', '\0'};
+    ids.emplace_back(id);
+    hub.add_blind(id, config);
+  }
+  hub.set_busy_rate(0.01f);
+  BridgeEnd bridge(hub);
+
+  const uint32_t hours_ms = 4 * 3600 * 1000;
+  size_t next = 0;
+  for (uint32_t now = 0; now < hours_ms; now += 800) {
+    const std::string &id = ids[next++ % ids.size()];
+    if (next % 50 == 0) {
+      bridge.send(id.c_str(), next % 100 == 0 ? 'o' : 'c', "");
+    } else {
+      bridge.send(id.c_str(), 'r', "?");
+    }
+    bridge.run_until(now + 800);
+    bridge.frames.clear();
+  }
+  require(hub.stats().frames_received == hours_ms / 800, "every frame should reach the hub");
+  require(hub.stats().rf_lost > 0 && hub.stats().lost_link_replies > 0 &&
+              hub.stats().busy_replies > 0 && hub.stats().motions_finished > 0,
+          "the configured loss, Enl and busy rates should all show up");
+  return hub.transcript();
+}
+
+void test_long_runs_are_deterministic() {
+  const std::vector<std::string> first = run_site(7);
+  require(first == run_site(7), "the same seed should replay the same transcript");
+  require(first != run_site(8), "a different seed should change the transcript");
+}
+
+}  // namespace
+
+int main() {
+  test_queries_are_answered_after_the_reply_latency();
+  test_motor_travel_reports_motion_then_the_final_position();
+  test_hub_errors_and_rf_loss();
+  test_pairing_is_acknowledged();
+  test_remote_moves_are_reported();
+  test_long_runs_are_deterministic();
+  std::cout << "virtual hub tests passed" << std::endl;
+  return 0;
+}